@@ -40,6 +40,11 @@ const sGpioPinConfig_t g_psGpioPinConfigs[] = {
         // Arduino hardware mapping for LED1
         .u8ArduinoPin = 13,  // D13 (built-in LED on most Arduino boards)
         #endif
+        #ifdef PLATFORM_LINUX_GPIO
+        // Linux mapping for LED1 (scripts/gpio_sim_setup.sh creates this chip)
+        .pcLinuxChip = "gpio-hal-sim", // Chip label or gpiochipN
+        .u32LinuxLine = 0,
+        #endif
     },
     {
         .pcPinName = GPIO_CONFIG_BUTTON1_NAME,
@@ -61,6 +66,11 @@ const sGpioPinConfig_t g_psGpioPinConfigs[] = {
         // Arduino hardware mapping for BUTTON1
         .u8ArduinoPin = 2,   // D2 (with internal pull-up)
         #endif
+        #ifdef PLATFORM_LINUX_GPIO
+        // Linux mapping for BUTTON1
+        .pcLinuxChip = "gpio-hal-sim",
+        .u32LinuxLine = 1,
+        #endif
     },
     { .pcPinName = NULL, .eDirection = 0, .ePull = 0 } // NULL terminator - marks end of array
 };
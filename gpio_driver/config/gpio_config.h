@@ -68,6 +68,12 @@ typedef struct {
     // Maps generic pin name to Arduino digital pin number (0-53 for Mega, 0-19 for Uno/Nano)
     uint8_t u8ArduinoPin;         // Arduino digital pin: 0-19 (Uno/Nano), 0-53 (Mega)
     #endif
+    
+    #ifdef PLATFORM_LINUX_GPIO
+    // Linux GPIO character device mapping (SBCs, gpio-sim)
+    const char *pcLinuxChip;      // "gpiochip0", "/dev/gpiochip0" or chip label
+    uint32_t u32LinuxLine;        // Line offset on that chip
+    #endif
 } sGpioPinConfig_t;
 
 // ============================================================================
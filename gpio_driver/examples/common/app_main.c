@@ -131,8 +131,10 @@ void vAppLoop(void) {
 
 int main(void) {
   // 1. Safety: Disable Watchdog immediately
+#ifdef PLATFORM_AVR
   MCUSR = 0;
   wdt_disable();
+#endif
 
   // 2. Register Platform GPIO Interface (Also inits UART)
   // Note: vAppInit acts as the platform independent entry point
@@ -141,8 +143,10 @@ int main(void) {
     // 3. Main Loop
     while (1) {
       vAppLoop();
-      DELAY_MS(100); // Throttle loop
+      vGpioHelperFlush(); // Digital Twin update for the pass
+      DELAY_MS(100);      // Throttle loop
       eGpioHelperWrite("LED1", false);
+      vGpioHelperFlush();
       DELAY_MS(100); // Throttle loop
     }
     // } else {
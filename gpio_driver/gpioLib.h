@@ -78,6 +78,38 @@ typedef struct {
      * @return eRetType_t RET_TYPE_SUCCESS on success
      */
     eRetType_t (*eHalGpioWriteFunc)(const char *pcPinName, bool bValue);
+
+    /**
+     * @brief Read the first u32Count configured pins in one pass (optional)
+     * @param pu8Bits Bitmask, bit i = g_psGpioPinConfigs[i] (cleared by caller)
+     * @param u32Count Number of pins to read
+     * @return eRetType_t RET_TYPE_SUCCESS on success
+     * @note NULL = not supported; callers fall back to eHalGpioReadFunc
+     */
+    eRetType_t (*eHalGpioReadAllFunc)(uint8_t *pu8Bits, uint32_t u32Count);
+
+    /**
+     * @brief Write several configured pins at once (optional)
+     * @param pu8Mask Bitmask of pins to write, bit i = g_psGpioPinConfigs[i]
+     * @param pu8Bits Values, same layout (bits outside pu8Mask are ignored)
+     * @param u32Count Number of pins covered by the masks
+     * @return eRetType_t RET_TYPE_SUCCESS on success; on failure no pin has
+     *         been written
+     * @note NULL = not supported; callers fall back to eHalGpioWriteFunc
+     */
+    eRetType_t (*eHalGpioWriteManyFunc)(const uint8_t *pu8Mask,
+                                        const uint8_t *pu8Bits,
+                                        uint32_t u32Count);
+
+    /**
+     * @brief Read a GPIO pin by its config index, without a name lookup
+     *        (optional)
+     * @param u32Pin Pin handle: index in g_psGpioPinConfigs
+     * @param pbValue Pointer to store read value (true = HIGH, false = LOW)
+     * @return eRetType_t RET_TYPE_SUCCESS on success
+     * @note NULL = not supported; callers fall back to eHalGpioReadFunc
+     */
+    eRetType_t (*eHalGpioReadPinFunc)(uint32_t u32Pin, bool *pbValue);
 } sGpioInterface_t;
 
 // Function Prototypes =========================================================
@@ -6,11 +6,20 @@
 //------------------------------------------------------------------------------
 
 #include "gpio_helper.h"
+#include "../config/gpio_config.h" // Pin order of eGpioHelperReadAll
 #include "helper_common.h"
 #include <stdio.h>
 #include <string.h>
 
 // Platform conditional includes
+#if defined(PLATFORM_HTTP) || defined(PLATFORM_UDS) || defined(PLATFORM_SHM)
+#define GPIO_HELPER_SIMULATOR // HAL read already returns the simulated value
+#elif defined(PLATFORM_LINUX_GPIO)
+#define GPIO_HELPER_SIMULATOR // Real lines, no simulated overlay to merge
+#elif defined(PLATFORM_FARM)
+#define GPIO_HELPER_SIMULATOR // Per-instance levels already include the twin
+#endif
+
 #ifdef PLATFORM_HTTP
 // On PC Simulator, we can use the HTTP driver directly
 #include "../implementations/pc/gpioLib_http.h"
@@ -18,16 +27,183 @@
 extern const sGpioInterface_t sGpioInterfaceHTTP;
 #endif
 
-#ifndef PLATFORM_HTTP
-// AVR / Hardware Includes
-#include "../config/gpio_config.h"
-#include "../gpioLib.h"
+#ifndef GPIO_HELPER_SIMULATOR
+/**
+ * @brief Merge policy and Digital Twin level per config pin (bit i = pin i),
+ *        built once by vGpioHelperInit
+ *
+ * The idle level is the released one (1 with a pull-up). A pin reads active
+ * when its physical or its simulated level is: active dominates.
+ */
+typedef struct {
+  uint8_t au8Idle[GPIO_HELPER_MAX_PINS / 8];      // 1 = pull-up: active low
+  uint8_t au8Simulated[GPIO_HELPER_MAX_PINS / 8]; // Level the twin drives
+} sGpioHelperMerge_t;
+
+static sGpioHelperMerge_t g_sGpioHelperMerge;
+
+/**
+ * @brief Merge the physical levels of 8 pins (byte u32Byte of the bitmaps)
+ *        with the Digital Twin's simulated ones
+ */
+static uint8_t u8GpioHelperMerge(uint32_t u32Byte, uint8_t u8Physical) {
+  uint8_t u8Idle = g_sGpioHelperMerge.au8Idle[u32Byte];
+  uint8_t u8Active = (uint8_t)((u8Physical ^ u8Idle) |
+                               (g_sGpioHelperMerge.au8Simulated[u32Byte] ^
+                                u8Idle));
+  return (uint8_t)(u8Idle ^ u8Active);
+}
+#endif
+
+// Config pins, counted by vGpioHelperInit (bound of the pin handles)
+static uint32_t g_u32GpioHelperPinCount = 0;
+
+// Pins per aggregated Digital Twin message (vGpioHelperFlush)
+#define GPIO_HELPER_DT_BATCH 8
+
+// Full-state Digital Twin report period in ms; 0 = transitions only
+#ifndef GPIO_HELPER_DT_KEEPALIVE_MS
+#define GPIO_HELPER_DT_KEEPALIVE_MS 0
+#endif
+
+#ifdef PLATFORM_FARM
+// Every farm instance is a board of its own: the farm keeps the state. It
+// only runs an instance when woken, so the next keepalive asks for a wake-up.
+extern sGpioHelperDtState_t *psFarmGpioHelperDtState(void);
+extern void vFarmWakeAtMs(uint32_t u32TickMs);
+#define GPIO_HELPER_DT_STATE() psFarmGpioHelperDtState()
+#define GPIO_HELPER_DT_WAKE_AT(ms) vFarmWakeAtMs(ms)
+#else
+static sGpioHelperDtState_t g_sGpioHelperDtState;
+#define GPIO_HELPER_DT_STATE() (&g_sGpioHelperDtState)
+#define GPIO_HELPER_DT_WAKE_AT(ms) ((void)(ms)) // The loop calls every pass
+#endif
+
+// Digital Twin Sync ===========================================================
 
-// Manual declarations to ensure visibility
-extern const sGpioPinConfig_t g_psGpioPinConfigs[];
-extern bool bGpioAVRGetSimulated(const char *pcPinName);
+/** Config index of a pin name, -1 if it is not configured */
+static int32_t iGpioHelperFindPin(const char *pcPinName) {
+  for (int32_t i = 0; g_psGpioPinConfigs[i].pcPinName != NULL; i++) {
+    if (strcmp(g_psGpioPinConfigs[i].pcPinName, pcPinName) == 0)
+      return i;
+  }
+  return -1;
+}
+
+int32_t iGpioHelperPinHandle(const char *pcName, size_t u32Len) {
+  if (pcName == NULL)
+    return -1;
+  for (int32_t i = 0; g_psGpioPinConfigs[i].pcPinName != NULL; i++) {
+    const char *pcPinName = g_psGpioPinConfigs[i].pcPinName;
+    if (strncmp(pcPinName, pcName, u32Len) == 0 && pcPinName[u32Len] == '\0')
+      return i;
+  }
+  return -1;
+}
+
+#ifndef GPIO_HELPER_SIMULATOR
+/** True once a level of config pin iPin was sent or is waiting to be */
+static bool bGpioHelperDtKnown(int32_t iPin) {
+  const sGpioHelperDtState_t *psState = GPIO_HELPER_DT_STATE();
+  if (psState == NULL || iPin < 0 || iPin >= GPIO_HELPER_MAX_PINS)
+    return false;
+  uint8_t u8Bit = (uint8_t)(1u << (iPin & 7));
+  return ((psState->au8Reported[iPin >> 3] | psState->au8Pending[iPin >> 3]) &
+          u8Bit) != 0;
+}
 #endif
 
+/**
+ * @brief Record bValue as the level of config pin iPin. It goes to the twin
+ *        with the next vGpioHelperFlush unless the twin already has it.
+ * @return false if the pin is not tracked: the caller sends it now
+ */
+static bool bGpioHelperDtNote(int32_t iPin, bool bValue) {
+  sGpioHelperDtState_t *psState = GPIO_HELPER_DT_STATE();
+  if (psState == NULL || iPin < 0 || iPin >= GPIO_HELPER_MAX_PINS)
+    return false;
+  uint8_t u8Byte = (uint8_t)(iPin >> 3);
+  uint8_t u8Bit = (uint8_t)(1u << (iPin & 7));
+  if (bValue)
+    psState->au8Level[u8Byte] |= u8Bit;
+  else
+    psState->au8Level[u8Byte] &= (uint8_t)~u8Bit;
+  // Back to the sent level within the tick (a short pulse): nothing to send
+  if ((psState->au8Reported[u8Byte] & u8Bit) != 0 &&
+      ((psState->au8Sent[u8Byte] & u8Bit) != 0) == bValue)
+    psState->au8Pending[u8Byte] &= (uint8_t)~u8Bit;
+  else
+    psState->au8Pending[u8Byte] |= u8Bit;
+  return true;
+}
+
+/** Note a level, or send it at once for a pin the cache does not cover */
+static void vGpioHelperDtSync(int32_t iPin, const char *pcPinName,
+                              bool bValue) {
+  if (!bGpioHelperDtNote(iPin, bValue))
+    vHelperSend("GPIO", pcPinName, bValue);
+}
+
+void vGpioHelperSyncPin(uint32_t u32Pin, bool bValue) {
+  vGpioHelperDtSync((int32_t)u32Pin, g_psGpioPinConfigs[u32Pin].pcPinName,
+                    bValue);
+}
+
+void vGpioHelperFlush(void) {
+  sGpioHelperDtState_t *psState = GPIO_HELPER_DT_STATE();
+  const char *apcPins[GPIO_HELPER_DT_BATCH];
+  int aiValues[GPIO_HELPER_DT_BATCH];
+  uint32_t u32Batch = 0;
+
+  if (psState == NULL)
+    return;
+  for (uint8_t u8Byte = 0; u8Byte < GPIO_HELPER_MAX_PINS / 8; u8Byte++) {
+    uint8_t u8Pending = psState->au8Pending[u8Byte];
+    if (u8Pending == 0)
+      continue; // Eight unchanged pins per compare: the common case
+    uint8_t u8Level = psState->au8Level[u8Byte];
+    for (uint8_t u8Bit = 0; u8Bit < 8; u8Bit++) {
+      if ((u8Pending & (1u << u8Bit)) == 0)
+        continue;
+      apcPins[u32Batch] = g_psGpioPinConfigs[u8Byte * 8 + u8Bit].pcPinName;
+      aiValues[u32Batch] = (u8Level >> u8Bit) & 1;
+      if (++u32Batch == GPIO_HELPER_DT_BATCH) {
+        vHelperSendMany("GPIO", apcPins, aiValues, u32Batch);
+        u32Batch = 0;
+      }
+    }
+    psState->au8Sent[u8Byte] =
+        (uint8_t)((psState->au8Sent[u8Byte] & ~u8Pending) |
+                  (u8Level & u8Pending));
+    psState->au8Reported[u8Byte] |= u8Pending;
+    psState->au8Pending[u8Byte] = 0;
+  }
+  if (u32Batch > 0)
+    vHelperSendMany("GPIO", apcPins, aiValues, u32Batch);
+}
+
+void vGpioHelperKeepalive(uint32_t u32NowMs) {
+#if GPIO_HELPER_DT_KEEPALIVE_MS > 0
+  sGpioHelperDtState_t *psState = GPIO_HELPER_DT_STATE();
+  if (psState == NULL)
+    return;
+  // Unsigned difference: correct across the 49-day tick wrap
+  if ((uint32_t)(u32NowMs - psState->u32KeepaliveMs) <
+      (uint32_t)GPIO_HELPER_DT_KEEPALIVE_MS) {
+    GPIO_HELPER_DT_WAKE_AT(psState->u32KeepaliveMs +
+                           GPIO_HELPER_DT_KEEPALIVE_MS);
+    return;
+  }
+  psState->u32KeepaliveMs = u32NowMs;
+  GPIO_HELPER_DT_WAKE_AT(u32NowMs + GPIO_HELPER_DT_KEEPALIVE_MS);
+  // Every reported pin goes out again with the next flush
+  for (uint8_t u8Byte = 0; u8Byte < GPIO_HELPER_MAX_PINS / 8; u8Byte++)
+    psState->au8Pending[u8Byte] |= psState->au8Reported[u8Byte];
+#else
+  (void)u32NowMs;
+#endif
+}
+
 // Main Helper Implementation ==================================================
 
 void vGpioHelperInit(void) {
@@ -36,6 +212,28 @@ void vGpioHelperInit(void) {
   if (psGpio != NULL && psGpio->vHalGpioInitFunc != NULL) {
     psGpio->vHalGpioInitFunc();
   }
+
+  // Per-pin tables, so reads by handle need no name lookup or config scan
+  uint32_t u32Count = 0;
+  while (g_psGpioPinConfigs[u32Count].pcPinName != NULL) {
+#ifndef GPIO_HELPER_SIMULATOR
+    if (u32Count < GPIO_HELPER_MAX_PINS) {
+      uint8_t u8Bit = (uint8_t)(1u << (u32Count & 7u));
+      uint32_t u32Byte = u32Count >> 3;
+      if (g_psGpioPinConfigs[u32Count].ePull == GPIO_PULL_UP)
+        g_sGpioHelperMerge.au8Idle[u32Byte] |= u8Bit;
+      else
+        g_sGpioHelperMerge.au8Idle[u32Byte] &= (uint8_t)~u8Bit;
+    }
+#endif
+    u32Count++;
+  }
+#ifndef GPIO_HELPER_SIMULATOR
+  // The twin starts released: reads return the physical level
+  memcpy(g_sGpioHelperMerge.au8Simulated, g_sGpioHelperMerge.au8Idle,
+         sizeof(g_sGpioHelperMerge.au8Simulated));
+#endif
+  g_u32GpioHelperPinCount = u32Count;
 }
 
 eRetType_t eGpioHelperConfigure(const sGpioConfig_t *psConfig) {
@@ -58,72 +256,318 @@ eRetType_t eGpioHelperWrite(const char *pcPinName, bool bValue) {
     return RET_TYPE_FAIL;
   }
 
-  /* 2. On hardware (AVR/STM32): send MCP response "OK" first so the serial
-   *    client gets it, then DT sync JSON. */
+  /* 2. DT sync, sent with the tick's other changes by vGpioHelperFlush.
+   *    The MCP response ("OK", tagged with the request ID) is the caller's
+   *    (tool_handlers_gpio.c), not the helper's. */
   if (eRet == RET_TYPE_SUCCESS) {
-    printf("OK\n");
-    vHelperSend("GPIO", pcPinName, bValue);
+    vGpioHelperDtSync(iGpioHelperFindPin(pcPinName), pcPinName, bValue);
   }
 
   return eRet;
 }
 
 eRetType_t eGpioHelperRead(const char *pcPinName, bool *pbValue) {
+  int32_t iPin = iGpioHelperFindPin(pcPinName);
+  if (iPin >= 0) {
+    return eGpioHelperReadPin((uint32_t)iPin, pbValue);
+  }
+
+  // Not in the config: the HAL may still know it (e.g. a simulator pin)
   const sGpioInterface_t *psGpio = psHalGetGpioInterface();
   if (psGpio == NULL || psGpio->eHalGpioReadFunc == NULL) {
     return RET_TYPE_FAIL;
   }
+  return psGpio->eHalGpioReadFunc(pcPinName, pbValue);
+}
 
-  // 1. Get Physical State from HAL
+eRetType_t eGpioHelperReadPin(uint32_t u32Pin, bool *pbValue) {
+  const sGpioInterface_t *psGpio = psHalGetGpioInterface();
+  if (psGpio == NULL || psGpio->eHalGpioReadFunc == NULL) {
+    return RET_TYPE_FAIL;
+  }
+  if (pbValue == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+  if (u32Pin >= g_u32GpioHelperPinCount) {
+    return RET_TYPE_INVALID_PARAMETER;
+  }
+
+  // 1. Get Physical State from HAL, by handle when the HAL supports it
   bool bPhysical = false;
-  eRetType_t eRet = psGpio->eHalGpioReadFunc(pcPinName, &bPhysical);
+  eRetType_t eRet =
+      (psGpio->eHalGpioReadPinFunc != NULL)
+          ? psGpio->eHalGpioReadPinFunc(u32Pin, &bPhysical)
+          : psGpio->eHalGpioReadFunc(g_psGpioPinConfigs[u32Pin].pcPinName,
+                                     &bPhysical);
   if (eRet != RET_TYPE_SUCCESS)
     return eRet;
 
-#ifdef PLATFORM_HTTP
+#ifdef GPIO_HELPER_SIMULATOR
   // On PC Simulator, the HAL Read IS the Simulated Read.
   *pbValue = bPhysical;
 #else
   // On Hardware (AVR), we need to Merge Physical + Simulated
-  bool bSimulated = bGpioAVRGetSimulated(pcPinName);
+  bool bIdle = g_psGpioPinConfigs[u32Pin].ePull == GPIO_PULL_UP;
+  *pbValue = bPhysical;
+  if (u32Pin < GPIO_HELPER_MAX_PINS) {
+    uint8_t u8Bit = (uint8_t)(1u << (u32Pin & 7u));
+    bIdle = (g_sGpioHelperMerge.au8Idle[u32Pin >> 3] & u8Bit) != 0;
+    *pbValue =
+        (u8GpioHelperMerge(u32Pin >> 3, bPhysical ? u8Bit : 0) & u8Bit) != 0;
+  }
+
+  // Report a PHYSICAL press to the Digital Twin, and the release after it,
+  // once per edge however often the pin is polled
+  if (bPhysical != bIdle || bGpioHelperDtKnown((int32_t)u32Pin)) {
+    vGpioHelperDtSync((int32_t)u32Pin, g_psGpioPinConfigs[u32Pin].pcPinName,
+                      bPhysical);
+  }
+#endif
+
+  return RET_TYPE_SUCCESS;
+}
 
-  // Find Config to know Pull Direction
-  // Simple linear search (same as Platform)
-  const sGpioPinConfig_t *psConfig = g_psGpioPinConfigs;
-  eGpioPull_t ePull = GPIO_PULL_NONE;
+eRetType_t eGpioHelperSetSimulated(const char *pcPinName, bool bValue) {
+  if (pcPinName == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+  int32_t iPin = iGpioHelperFindPin(pcPinName);
+  if (iPin < 0) {
+    return RET_TYPE_INVALID_PARAMETER;
+  }
+  return eGpioHelperSetSimulatedPin((uint32_t)iPin, bValue);
+}
 
-  while (psConfig->pcPinName != NULL) {
-    if (strcmp(psConfig->pcPinName, pcPinName) == 0) {
-      ePull = psConfig->ePull;
-      break;
+eRetType_t eGpioHelperSetSimulatedPin(uint32_t u32Pin, bool bValue) {
+#ifdef GPIO_HELPER_SIMULATOR
+  (void)u32Pin;
+  (void)bValue;
+  return RET_TYPE_INVALID_STATE; // The simulator owns the levels
+#else
+  if (u32Pin >= g_u32GpioHelperPinCount || u32Pin >= GPIO_HELPER_MAX_PINS) {
+    return RET_TYPE_INVALID_PARAMETER;
+  }
+  uint8_t u8Bit = (uint8_t)(1u << (u32Pin & 7u));
+  if (bValue)
+    g_sGpioHelperMerge.au8Simulated[u32Pin >> 3] |= u8Bit;
+  else
+    g_sGpioHelperMerge.au8Simulated[u32Pin >> 3] &= (uint8_t)~u8Bit;
+  return RET_TYPE_SUCCESS;
+#endif
+}
+
+eRetType_t eGpioHelperReadAll(uint8_t *pu8Bits, uint32_t u32Count) {
+  const sGpioInterface_t *psGpio = psHalGetGpioInterface();
+  if (psGpio == NULL || psGpio->eHalGpioReadFunc == NULL) {
+    return RET_TYPE_FAIL;
+  }
+  if (pu8Bits == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+  for (uint32_t i = 0; i < u32Count; i++) {
+    if (g_psGpioPinConfigs[i].pcPinName == NULL) {
+      return RET_TYPE_INVALID_PARAMETER; // More pins asked than configured
     }
-    psConfig++;
   }
+  memset(pu8Bits, 0, (u32Count + 7u) / 8u);
 
-  // Merge Logic
-  bool bIsPressedPhysical = false;
-  if (ePull == GPIO_PULL_UP) {
-    // Active Low: 0 = Pressed
-    // Result = Physical && Simulated (0 dominates)
-    *pbValue = bPhysical && bSimulated;
-    bIsPressedPhysical = !bPhysical;
+  // 1. Physical state: one HAL pass (e.g. one load per port) when supported
+  if (psGpio->eHalGpioReadAllFunc != NULL) {
+    eRetType_t eRet = psGpio->eHalGpioReadAllFunc(pu8Bits, u32Count);
+    if (eRet != RET_TYPE_SUCCESS)
+      return eRet;
   } else {
-    // Active High/None: 1 = Pressed
-    // Result = Physical || Simulated (1 dominates)
-    *pbValue = bPhysical || bSimulated;
-    bIsPressedPhysical = bPhysical;
+    for (uint32_t i = 0; i < u32Count; i++) {
+      bool bPhysical = false;
+      eRetType_t eRet = psGpio->eHalGpioReadFunc(
+          g_psGpioPinConfigs[i].pcPinName, &bPhysical);
+      if (eRet != RET_TYPE_SUCCESS)
+        return eRet;
+      if (bPhysical)
+        pu8Bits[i >> 3] |= (uint8_t)(1u << (i & 7u));
+    }
   }
 
-  // Report to Digital Twin if PHYSICAL caused the Press
-  // We send only if Physical is Active (Pressed)
-  if (bIsPressedPhysical) {
-    // Note: This might spam if called frequently.
-    // Ideally we'd detect change, but Helper defines "Current State".
-    // We assume App throttles or handles logical edge detection.
-    // User requested: "if real press sync with the dt"
-    vHelperSend("GPIO", pcPinName, (ePull == GPIO_PULL_UP ? 0 : 1));
+#ifndef GPIO_HELPER_SIMULATOR
+  // 2. Same merge as eGpioHelperRead, 8 pins per table lookup. No per-pin
+  //    Digital Twin report: a snapshot is an inspection, and physical
+  //    presses still reach the twin through eGpioHelperRead.
+  uint32_t u32Merged =
+      (u32Count < GPIO_HELPER_MAX_PINS) ? u32Count : GPIO_HELPER_MAX_PINS;
+  for (uint32_t i = 0; i < (u32Merged + 7u) / 8u; i++) {
+    uint8_t u8Valid = (i < u32Merged / 8u)
+                          ? 0xFFu
+                          : (uint8_t)((1u << (u32Merged & 7u)) - 1u);
+    pu8Bits[i] = (uint8_t)((pu8Bits[i] & (uint8_t)~u8Valid) |
+                           (u8GpioHelperMerge(i, pu8Bits[i]) & u8Valid));
   }
 #endif
 
   return RET_TYPE_SUCCESS;
 }
+
+eRetType_t eGpioHelperWriteMany(const uint8_t *pu8Mask, const uint8_t *pu8Bits,
+                                uint32_t u32Count) {
+  const sGpioInterface_t *psGpio = psHalGetGpioInterface();
+  if (psGpio == NULL || psGpio->eHalGpioWriteFunc == NULL) {
+    return RET_TYPE_FAIL;
+  }
+  if (pu8Mask == NULL || pu8Bits == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+  for (uint32_t i = 0; i < u32Count; i++) {
+    if (g_psGpioPinConfigs[i].pcPinName == NULL) {
+      return RET_TYPE_INVALID_PARAMETER; // More pins given than configured
+    }
+  }
+
+  // 1. Execute on Registered Driver: grouped (e.g. one store per port) when
+  //    supported, else pin by pin
+  if (psGpio->eHalGpioWriteManyFunc != NULL) {
+    eRetType_t eRet = psGpio->eHalGpioWriteManyFunc(pu8Mask, pu8Bits, u32Count);
+    if (eRet != RET_TYPE_SUCCESS)
+      return eRet;
+  } else {
+    for (uint32_t i = 0; i < u32Count; i++) {
+      uint8_t u8Bit = (uint8_t)(1u << (i & 7u));
+      if ((pu8Mask[i >> 3] & u8Bit) == 0)
+        continue;
+      eRetType_t eRet = psGpio->eHalGpioWriteFunc(
+          g_psGpioPinConfigs[i].pcPinName, (pu8Bits[i >> 3] & u8Bit) != 0);
+      if (eRet != RET_TYPE_SUCCESS)
+        return eRet;
+    }
+  }
+
+  // 2. DT sync: the changed pins go out in the tick's aggregated message
+  for (uint32_t i = 0; i < u32Count; i++) {
+    uint8_t u8Bit = (uint8_t)(1u << (i & 7u));
+    if ((pu8Mask[i >> 3] & u8Bit) != 0)
+      vGpioHelperSyncPin(i, (pu8Bits[i >> 3] & u8Bit) != 0);
+  }
+
+  return RET_TYPE_SUCCESS;
+}
+
+// Digital Twin Input ==========================================================
+
+/** Skip spaces */
+static const char *pcGpioHelperDtSkip(const char *pc) {
+  while (*pc == ' ' || *pc == '\t')
+    pc++;
+  return pc;
+}
+
+/** Quoted string at pc (pin names have no escapes): start and length.
+ *  Returns the position after the closing quote, NULL if none. */
+static const char *pcGpioHelperDtString(const char *pc, const char **ppcStart,
+                                        size_t *pu32Len) {
+  if (*pc != '"')
+    return NULL;
+  const char *pcEnd = strchr(++pc, '"');
+  if (pcEnd == NULL)
+    return NULL;
+  *ppcStart = pc;
+  *pu32Len = (size_t)(pcEnd - pc);
+  return pcEnd + 1;
+}
+
+/** Level at pc: a number (non-zero = 1) or true/false. NULL if neither. */
+static const char *pcGpioHelperDtLevel(const char *pc, bool *pbValue) {
+  if (*pc == 't' || *pc == 'f') {
+    *pbValue = (*pc == 't');
+    while (*pc >= 'a' && *pc <= 'z')
+      pc++;
+    return pc;
+  }
+  if (*pc < '0' || *pc > '9')
+    return NULL;
+  bool bValue = false;
+  for (; *pc >= '0' && *pc <= '9'; pc++) {
+    if (*pc != '0')
+      bValue = true;
+  }
+  *pbValue = bValue;
+  return pc;
+}
+
+bool bGpioHelperParseDtLine(const char *pcLine, pfGpioHelperDtApply_t pfApply) {
+  const char *pc = pcLine;
+  int32_t iPin = -1;    // "p"
+  int8_t i8Value = -1;  // "v"
+  bool bGpio = false;   // "t":"GPIO" seen
+  bool bInMap = false;  // Inside "s"
+  const char *pcText;
+  size_t u32Len;
+  bool bValue;
+
+  if (pc == NULL || pfApply == NULL)
+    return false;
+  pc = pcGpioHelperDtSkip(pc);
+  if (*pc++ != '{')
+    return false;
+  for (;;) {
+    pc = pcGpioHelperDtSkip(pc);
+    if (*pc == '}') {
+      if (!bInMap)
+        break;
+      bInMap = false; // End of "s": a separator of the outer object follows
+      pc++;
+    } else if (bInMap) {
+      // "PIN":level, applied as it is read
+      pc = pcGpioHelperDtString(pc, &pcText, &u32Len);
+      if (pc == NULL)
+        return false;
+      pc = pcGpioHelperDtSkip(pc);
+      if (*pc++ != ':')
+        return false;
+      pc = pcGpioHelperDtLevel(pcGpioHelperDtSkip(pc), &bValue);
+      if (pc == NULL)
+        return false;
+      int32_t iMapPin = iGpioHelperPinHandle(pcText, u32Len);
+      if (iMapPin >= 0)
+        pfApply((uint32_t)iMapPin, bValue);
+    } else {
+      if (pc[0] != '"' || pc[1] == '\0' || pc[2] != '"')
+        return false; // Keys of the outer object are one letter
+      char cKey = pc[1];
+      pc = pcGpioHelperDtSkip(pc + 3);
+      if (*pc++ != ':')
+        return false;
+      pc = pcGpioHelperDtSkip(pc);
+      if (cKey == 't') {
+        if (strncmp(pc, "\"GPIO\"", 6) != 0)
+          return false;
+        bGpio = true;
+        pc += 6;
+      } else if (cKey == 'p' && bGpio) {
+        pc = pcGpioHelperDtString(pc, &pcText, &u32Len);
+        if (pc == NULL)
+          return false;
+        iPin = iGpioHelperPinHandle(pcText, u32Len);
+      } else if (cKey == 'v') {
+        pc = pcGpioHelperDtLevel(pc, &bValue);
+        if (pc == NULL)
+          return false;
+        i8Value = bValue ? 1 : 0;
+      } else if (cKey == 's' && bGpio && *pc == '{') {
+        bInMap = true;
+        pc++;
+        continue; // A pin name or '}' follows, not a separator
+      } else {
+        return false; // Unknown key, or a pin before "t"
+      }
+    }
+    pc = pcGpioHelperDtSkip(pc);
+    if (*pc == ',')
+      pc++;
+    else if (*pc != '}')
+      return false;
+  }
+
+  if (!bGpio)
+    return false;
+  if (iPin >= 0 && i8Value >= 0)
+    pfApply((uint32_t)iPin, i8Value != 0);
+  return true;
+}
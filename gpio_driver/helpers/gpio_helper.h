@@ -9,11 +9,31 @@
 #define GPIO_HELPER_H
 
 #include "../gpioLib.h"
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Digital Twin Sync State =====================================================
+
+// Config pins with per-pin helper state (last-reported level, merge policy);
+// later pins always send and read the physical level only
+#define GPIO_HELPER_MAX_PINS 64
+
+/**
+ * @brief What the Digital Twin was told and what it will be told at the end
+ *        of the tick, per config pin (bit i = pin i). Zero-initialised =
+ *        nothing reported yet.
+ */
+typedef struct {
+  uint8_t au8Level[GPIO_HELPER_MAX_PINS / 8];    // Latest level
+  uint8_t au8Sent[GPIO_HELPER_MAX_PINS / 8];     // Last level sent
+  uint8_t au8Reported[GPIO_HELPER_MAX_PINS / 8]; // Level sent at least once
+  uint8_t au8Pending[GPIO_HELPER_MAX_PINS / 8];  // To send at the next flush
+  uint32_t u32KeepaliveMs; // Tick of the last full-state report
+} sGpioHelperDtState_t;
+
 // Helper Function Prototypes =================================================
 
 /**
@@ -34,15 +54,113 @@ eRetType_t eGpioHelperConfigure(const sGpioConfig_t *psConfig);
  * @brief Write to a GPIO pin (Helper wrapper)
  *
  * 1. Writes to Real Hardware/Simulator (via HAL)
- * 2. Sends Telemetry Bridge message (if on embedded hardware)
+ * 2. Queues a Telemetry Bridge update (if on embedded hardware) when the
+ *    level differs from the one last reported; see vGpioHelperFlush
  */
 eRetType_t eGpioHelperWrite(const char *pcPinName, bool bValue);
 
 /**
  * @brief Read from a GPIO pin (Helper wrapper)
+ *
+ * On hardware, a physical press or release of the pin is reported to the
+ * Digital Twin once, on the edge, however often the pin is polled.
  */
 eRetType_t eGpioHelperRead(const char *pcPinName, bool *pbValue);
 
+/**
+ * @brief eGpioHelperRead by config index (pin handle): no name lookup
+ *
+ * On hardware the cost is the HAL's register read plus a table lookup: the
+ * merge policy of every pin is computed once by vGpioHelperInit.
+ */
+eRetType_t eGpioHelperReadPin(uint32_t u32Pin, bool *pbValue);
+
+/**
+ * @brief Set the level the Digital Twin drives on a pin (hardware builds)
+ *
+ * A read returns the physical level merged with this one: with a pull-up
+ * the low level (pressed) wins, otherwise the high level wins. Until the
+ * twin sends a level, a pin reads its physical level only.
+ * @return RET_TYPE_INVALID_PARAMETER for a pin the helper does not track
+ */
+eRetType_t eGpioHelperSetSimulated(const char *pcPinName, bool bValue);
+
+/**
+ * @brief eGpioHelperSetSimulated by config index (pin handle)
+ */
+eRetType_t eGpioHelperSetSimulatedPin(uint32_t u32Pin, bool bValue);
+
+/**
+ * @brief Pin handle (config index) of a pin name
+ * @param pcName Pin name, not necessarily NUL-terminated (e.g. inside a
+ *        received line)
+ * @return -1 if the name is not a configured pin
+ */
+int32_t iGpioHelperPinHandle(const char *pcName, size_t u32Len);
+
+/**
+ * @brief Read every configured pin at once (Helper wrapper)
+ *
+ * Bit i of pu8Bits is pin i of the config (config.json "pins" order), with
+ * the same merge as eGpioHelperRead but without its per-pin Digital Twin
+ * messages. Uses the HAL's one-pass read when the platform has one, else
+ * reads pin by pin.
+ */
+eRetType_t eGpioHelperReadAll(uint8_t *pu8Bits, uint32_t u32Count);
+
+/**
+ * @brief Write several pins at once (Helper wrapper)
+ *
+ * Writes pin i of the config where bit i of pu8Mask is set, to bit i of
+ * pu8Bits. Uses the HAL's grouped write when the platform has one (e.g. one
+ * store per port), else writes pin by pin. The pins whose level changed go
+ * to the Digital Twin with the next vGpioHelperFlush.
+ */
+eRetType_t eGpioHelperWriteMany(const uint8_t *pu8Mask, const uint8_t *pu8Bits,
+                                uint32_t u32Count);
+
+/**
+ * @brief Report config pin u32Pin at bValue to the Digital Twin with the next
+ *        flush, unless that is the level it was last told (writes done
+ *        outside the helper)
+ */
+void vGpioHelperSyncPin(uint32_t u32Pin, bool bValue);
+
+/**
+ * @brief Call at the end of each main-loop pass: sends every pin that changed
+ *        during the pass as {"t":"GPIO","s":{"LED1":1,"BUTTON1":0}}, up to 8
+ *        pins per line. A pin that changed and changed back is not sent.
+ */
+void vGpioHelperFlush(void);
+
+/**
+ * @brief Call from the main loop before vGpioHelperFlush: every
+ *        GPIO_HELPER_DT_KEEPALIVE_MS (build option, 0 = off) resend the
+ *        last-reported level of every pin, so a twin that (re)connects or
+ *        lost a line catches up
+ */
+void vGpioHelperKeepalive(uint32_t u32NowMs);
+
+// Digital Twin Input ==========================================================
+
+/** Level of one pin from a Digital Twin input line, by pin handle */
+typedef void (*pfGpioHelperDtApply_t)(uint32_t u32Pin, bool bValue);
+
+/**
+ * @brief Parse a Digital Twin input line in one pass, without copies
+ *
+ *   {"t":"GPIO","p":"BUTTON1","v":0}           one pin
+ *   {"t":"GPIO","s":{"BUTTON1":0,"LED1":1}}    any number of pins
+ *
+ * "t" must be "GPIO" and come before "p" / "s", so no pin of another
+ * message type is applied. Levels are digits (non-zero = 1) or true/false.
+ * pfApply gets the pins of an "s" map as they are read and the "p" pin at
+ * the end; unknown pins are skipped.
+ * @return false for a malformed line or another message type (map pins
+ *         before the error may have been applied)
+ */
+bool bGpioHelperParseDtLine(const char *pcLine, pfGpioHelperDtApply_t pfApply);
+
 #ifdef __cplusplus
 }
 #endif
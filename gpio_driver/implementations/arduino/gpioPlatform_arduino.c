@@ -139,6 +139,32 @@ static eRetType_t eArduinoGpioRead(const char *pcPinName, bool *pbValue)
     return RET_TYPE_SUCCESS;
 }
 
+/**
+ * @brief Read a GPIO pin state by config index (no name lookup)
+ * 
+ * @param u32Pin Index in g_psGpioPinConfigs
+ * @param pbValue Pointer to store state (true = HIGH, false = LOW)
+ * @return eRetType_t RET_TYPE_SUCCESS on success
+ */
+static eRetType_t eArduinoGpioReadPin(uint32_t u32Pin, bool *pbValue)
+{
+    if (pbValue == NULL)
+        return RET_TYPE_FAIL;
+    
+    extern const sGpioPinConfig_t g_psGpioPinConfigs[];
+    
+    // Bounds check without string compares: walk to the terminator
+    for (uint32_t i = 0; i <= u32Pin; i++)
+    {
+        if (g_psGpioPinConfigs[i].pcPinName == NULL)
+            return RET_TYPE_FAIL;
+    }
+    
+    *pbValue = (digitalRead(g_psGpioPinConfigs[u32Pin].u8ArduinoPin) == HIGH);
+    
+    return RET_TYPE_SUCCESS;
+}
+
 /**
  * @brief Write a GPIO pin state
  * 
@@ -170,6 +196,7 @@ const sGpioInterface_t sGpioInterfaceArduino = {
     .eHalGpioConfigureFunc = eArduinoGpioConfigure,
     .eHalGpioReadFunc = eArduinoGpioRead,
     .eHalGpioWriteFunc = eArduinoGpioWrite,
+    .eHalGpioReadPinFunc = eArduinoGpioReadPin,
 };
 
 #endif // PLATFORM_ARDUINO
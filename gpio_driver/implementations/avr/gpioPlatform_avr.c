@@ -18,6 +18,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <util/atomic.h>
 
 // Constants ===================================================================
 #define MAX_PINS 32
@@ -31,6 +32,10 @@
 #define AVR_PORT_E 4
 #define AVR_PORT_F 5
 
+// Distinct registers one snapshot / grouped write can touch: PINx and PORTx
+// of ports A..F
+#define AVR_SNAPSHOT_REGS 12
+
 // Type Definitions ============================================================
 // Internal pin state tracking
 typedef struct {
@@ -39,11 +44,11 @@ typedef struct {
   volatile uint8_t *pu8DdrReg;  // Pointer to DDR register (DDRB, DDRC, etc.)
   volatile uint8_t *pu8PortReg; // Pointer to PORT register (PORTB, PORTC, etc.)
   volatile uint8_t *pu8PinReg;  // Pointer to PIN register (PINB, PINC, etc.)
+  volatile uint8_t *pu8ReadReg; // What a read samples: PIN (input), PORT
   uint8_t u8PinMask;            // Pin bitmask (1 << pin_number)
   eGpioDirection_t eDirection;
   eGpioPull_t ePull;
   bool bValue;
-  bool bSimulatedValue; // Stored state from Digital Twin
 } sPinState_t;
 
 // Static Variables ============================================================
@@ -121,7 +126,11 @@ static sPinState_t *psFindPin(const char *pcPinName) {
 // Forward Declarations =======================================================
 eRetType_t eGpioAVRConfigure(const sGpioConfig_t *psConfig);
 eRetType_t eGpioAVRRead(const char *pcPinName, bool *pbValue);
+eRetType_t eGpioAVRReadPin(uint32_t u32Pin, bool *pbValue);
 eRetType_t eGpioAVRWrite(const char *pcPinName, bool bValue);
+eRetType_t eGpioAVRReadAll(uint8_t *pu8Bits, uint32_t u32Count);
+eRetType_t eGpioAVRWriteMany(const uint8_t *pu8Mask, const uint8_t *pu8Bits,
+                             uint32_t u32Count);
 
 // Functions ===================================================================
 
@@ -196,13 +205,9 @@ void vGpioAVRInit(void) {
       psPin->eDirection = psPinConfig->eDirection;
       psPin->ePull = psPinConfig->ePull;
       psPin->bValue = false;
-
-      // Default simulated state depends on Pull (Active Low -> Default High)
-      if (psPin->ePull == GPIO_PULL_UP) {
-        psPin->bSimulatedValue = true; // Default Released (High)
-      } else {
-        psPin->bSimulatedValue = false; // Default Low
-      }
+      // Inputs read the pin, outputs the last written value
+      psPin->pu8ReadReg =
+          (psPin->eDirection == GPIO_DIR_INPUT) ? pu8Pin : pu8Port;
 
       g_u8PinCount++;
 
@@ -289,46 +294,77 @@ eRetType_t eGpioAVRRead(const char *pcPinName, bool *pbValue) {
     return RET_TYPE_FAIL;
   }
 
-  // Read from PIN register (for input) or PORT register (for output)
-  // Read from PIN register (for input) or PORT register (for output)
-  if (psPin->eDirection == GPIO_DIR_INPUT) {
-    // Input: read PIN register
-    // RAW PHYSICAL ONLY - Merging happens in Helper
-    *pbValue = ((*(psPin->pu8PinReg)) & psPin->u8PinMask) != 0;
-  } else {
-    // Output: read last written value (from PORT register)
-    *pbValue = ((*(psPin->pu8PortReg)) & psPin->u8PinMask) != 0;
+  return eGpioAVRReadPin((uint32_t)(psPin - g_psPins), pbValue);
+}
+
+/**
+ * @brief Read GPIO pin state by config index: no name lookup
+ */
+eRetType_t eGpioAVRReadPin(uint32_t u32Pin, bool *pbValue) {
+  if (pbValue == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+
+  if (!g_bInitialized) {
+    return RET_TYPE_NOT_INITIALIZED;
+  }
+
+  if (u32Pin >= g_u8PinCount) {
+    return RET_TYPE_INVALID_PARAMETER;
   }
+  sPinState_t *psPin = &g_psPins[u32Pin];
+
+  // PIN register (input) or PORT register (output), chosen at init
+  // RAW PHYSICAL ONLY - Merging happens in Helper
+  *pbValue = ((*(psPin->pu8ReadReg)) & psPin->u8PinMask) != 0;
 
   psPin->bValue = *pbValue;
   return RET_TYPE_SUCCESS;
 }
 
 /**
- * @brief Set the simulated input value from Digital Twin
+ * @brief Read the first u32Count pins with one load per port register
+ *
+ * Pins sharing a PINx / PORTx register reuse the same sample, so the
+ * snapshot is coherent per port and costs at most AVR_SNAPSHOT_REGS loads.
  */
-void vGpioAVRSetSimulated(const char *pcPinName, bool bValue) {
-  if (!g_bInitialized)
-    return;
+eRetType_t eGpioAVRReadAll(uint8_t *pu8Bits, uint32_t u32Count) {
+  if (pu8Bits == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
 
-  sPinState_t *psPin = psFindPin(pcPinName);
-  if (psPin != NULL) {
-    psPin->bSimulatedValue = bValue;
+  if (!g_bInitialized) {
+    return RET_TYPE_NOT_INITIALIZED;
   }
-}
 
-/**
- * @brief Get the simulated input value from Digital Twin
- */
-bool bGpioAVRGetSimulated(const char *pcPinName) {
-  if (!g_bInitialized)
-    return false; // Default released? Or false?
+  if (u32Count > g_u8PinCount) {
+    return RET_TYPE_INVALID_PARAMETER;
+  }
 
-  sPinState_t *psPin = psFindPin(pcPinName);
-  if (psPin != NULL) {
-    return psPin->bSimulatedValue;
+  volatile uint8_t *apu8Reg[AVR_SNAPSHOT_REGS];
+  uint8_t au8Sample[AVR_SNAPSHOT_REGS];
+  uint8_t u8Regs = 0;
+
+  for (uint8_t i = 0; i < (uint8_t)u32Count; i++) {
+    sPinState_t *psPin = &g_psPins[i];
+    // Same source as eGpioAVRRead: PIN for inputs, PORT for outputs
+    volatile uint8_t *pu8Reg = psPin->pu8ReadReg;
+    uint8_t j = 0;
+    while (j < u8Regs && apu8Reg[j] != pu8Reg) {
+      j++;
+    }
+    if (j == u8Regs) {
+      apu8Reg[j] = pu8Reg;
+      au8Sample[j] = *pu8Reg;
+      u8Regs++;
+    }
+
+    psPin->bValue = (au8Sample[j] & psPin->u8PinMask) != 0;
+    if (psPin->bValue) {
+      pu8Bits[i >> 3] |= (uint8_t)(1u << (i & 7u));
+    }
   }
-  return false; // Default
+  return RET_TYPE_SUCCESS;
 }
 
 /**
@@ -353,22 +389,101 @@ eRetType_t eGpioAVRWrite(const char *pcPinName, bool bValue) {
     return RET_TYPE_INVALID_STATE;
   }
 
-  // Write to PORT register
-  if (bValue) {
-    *(psPin->pu8PortReg) |= psPin->u8PinMask; // Set HIGH
-  } else {
-    *(psPin->pu8PortReg) &= ~psPin->u8PinMask; // Set LOW
+  // Write to PORT register. Read-modify-write: the Timer0 ISR may write the
+  // same port (gpio_write_at), so it must not run in between.
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    if (bValue) {
+      *(psPin->pu8PortReg) |= psPin->u8PinMask; // Set HIGH
+    } else {
+      *(psPin->pu8PortReg) &= ~psPin->u8PinMask; // Set LOW
+    }
   }
 
   psPin->bValue = bValue;
   return RET_TYPE_SUCCESS;
 }
 
+/**
+ * @brief Write several pins with one store per PORT register
+ *
+ * Every pin is checked before any register changes. Pins on one port then
+ * change with a single store, so their edges are simultaneous; the stores
+ * for different ports follow back to back.
+ */
+eRetType_t eGpioAVRWriteMany(const uint8_t *pu8Mask, const uint8_t *pu8Bits,
+                             uint32_t u32Count) {
+  if (pu8Mask == NULL || pu8Bits == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+
+  if (!g_bInitialized) {
+    return RET_TYPE_NOT_INITIALIZED;
+  }
+
+  if (u32Count > g_u8PinCount) {
+    return RET_TYPE_INVALID_PARAMETER;
+  }
+
+  volatile uint8_t *apu8Reg[AVR_SNAPSHOT_REGS];
+  uint8_t au8Set[AVR_SNAPSHOT_REGS];
+  uint8_t au8Clear[AVR_SNAPSHOT_REGS];
+  uint8_t u8Regs = 0;
+
+  for (uint8_t i = 0; i < (uint8_t)u32Count; i++) {
+    uint8_t u8Bit = (uint8_t)(1u << (i & 7u));
+    if ((pu8Mask[i >> 3] & u8Bit) == 0) {
+      continue;
+    }
+    sPinState_t *psPin = &g_psPins[i];
+    // Only write if pin is configured as output (same as eGpioAVRWrite)
+    if (psPin->eDirection != GPIO_DIR_OUTPUT) {
+      return RET_TYPE_INVALID_STATE;
+    }
+    uint8_t j = 0;
+    while (j < u8Regs && apu8Reg[j] != psPin->pu8PortReg) {
+      j++;
+    }
+    if (j == u8Regs) {
+      apu8Reg[j] = psPin->pu8PortReg;
+      au8Set[j] = 0;
+      au8Clear[j] = 0;
+      u8Regs++;
+    }
+    if (pu8Bits[i >> 3] & u8Bit) {
+      au8Set[j] |= psPin->u8PinMask;
+    } else {
+      au8Clear[j] |= psPin->u8PinMask;
+    }
+  }
+
+  // Atomic like eGpioAVRWrite (this also runs in the Timer0 ISR)
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    for (uint8_t j = 0; j < u8Regs; j++) {
+      *apu8Reg[j] =
+          (uint8_t)((*apu8Reg[j] & (uint8_t)~au8Clear[j]) | au8Set[j]);
+    }
+  }
+
+  for (uint8_t i = 0; i < (uint8_t)u32Count; i++) {
+    uint8_t u8Bit = (uint8_t)(1u << (i & 7u));
+    if (pu8Mask[i >> 3] & u8Bit) {
+      g_psPins[i].bValue = (pu8Bits[i >> 3] & u8Bit) != 0;
+    }
+  }
+  return RET_TYPE_SUCCESS;
+}
+
 // AVR GPIO Interface Structure =============================================
 const sGpioInterface_t sGpioInterfaceAVR = {.vHalGpioInitFunc = vGpioAVRInit,
                                             .eHalGpioConfigureFunc =
                                                 eGpioAVRConfigure,
                                             .eHalGpioReadFunc = eGpioAVRRead,
-                                            .eHalGpioWriteFunc = eGpioAVRWrite};
+                                            .eHalGpioWriteFunc = eGpioAVRWrite,
+                                            .eHalGpioReadAllFunc =
+                                                eGpioAVRReadAll,
+                                            .eHalGpioWriteManyFunc =
+                                                eGpioAVRWriteMany,
+                                            .eHalGpioReadPinFunc =
+                                                eGpioAVRReadPin};
 
 #endif // PLATFORM_AVR
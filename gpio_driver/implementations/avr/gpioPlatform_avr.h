@@ -26,11 +26,8 @@ extern "C" {
 // AVR GPIO Interface structure
 extern const sGpioInterface_t sGpioInterfaceAVR;
 
-// Digital Twin Input Injection
-void vGpioAVRSetSimulated(const char *pcPinName, bool bValue);
-
-// Digital Twin Input Retrieval
-bool bGpioAVRGetSimulated(const char *pcPinName);
+// Digital Twin input levels are kept and merged by the helper layer
+// (eGpioHelperSetSimulated in gpio_helper.h), the same on every platform.
 
 #ifdef __cplusplus
 }
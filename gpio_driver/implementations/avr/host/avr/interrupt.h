@@ -0,0 +1,24 @@
+//==============================================================================
+// AVR Host Emulation - <avr/interrupt.h>
+//------------------------------------------------------------------------------
+// ISR(vector) defines an ordinary function that u32AvrHostUartInject() or
+// vAvrHostElapseUs() calls; sei()/cli() drive the emulated global interrupt
+// flag.
+//------------------------------------------------------------------------------
+
+#ifndef AVR_HOST_AVR_INTERRUPT_H
+#define AVR_HOST_AVR_INTERRUPT_H
+
+#include "../avr_host.h"
+
+#define USART_RX_vect vAvrHostIsrUsartRx
+#define TIMER0_COMPA_vect vAvrHostIsrTimer0CompA
+
+#define ISR(vector, ...)                                                       \
+  void vector(void);                                                           \
+  void vector(void)
+
+#define sei() (g_bAvrHostIrqEnabled = true)
+#define cli() (g_bAvrHostIrqEnabled = false)
+
+#endif // AVR_HOST_AVR_INTERRUPT_H
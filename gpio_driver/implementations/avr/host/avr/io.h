@@ -0,0 +1,70 @@
+//==============================================================================
+// AVR Host Emulation - <avr/io.h> for ATmega328P
+//------------------------------------------------------------------------------
+// Register names map onto g_sAvrHostRegs (see avr_host.h). Only the
+// registers and bits the HAL sources use are defined.
+//------------------------------------------------------------------------------
+
+#ifndef AVR_HOST_AVR_IO_H
+#define AVR_HOST_AVR_IO_H
+
+#include "../avr_host.h"
+
+// Bit helpers (avr/sfr_defs.h)
+#define _BV(bit) (1u << (bit))
+#define bit_is_set(sfr, bit) ((sfr) & _BV(bit))
+#define bit_is_clear(sfr, bit) (!((sfr) & _BV(bit)))
+// Polling a flag is a sync point; polling UDRE0 also announces a UDR0 store
+#define loop_until_bit_is_set(sfr, bit)                                       \
+  do {                                                                         \
+    vAvrHostPollFlag(&(sfr), (bit));                                           \
+  } while (bit_is_clear(sfr, bit))
+#define loop_until_bit_is_clear(sfr, bit)                                     \
+  do {                                                                         \
+    vAvrHostPollFlag(&(sfr), (bit));                                           \
+  } while (bit_is_set(sfr, bit))
+
+// GPIO ports
+#define DDRB (g_sAvrHostRegs.au8Ddr[AVR_HOST_PORT_B])
+#define PORTB (g_sAvrHostRegs.au8Port[AVR_HOST_PORT_B])
+#define PINB (g_pu8AvrHostPin[AVR_HOST_PORT_B])
+#define DDRC (g_sAvrHostRegs.au8Ddr[AVR_HOST_PORT_C])
+#define PORTC (g_sAvrHostRegs.au8Port[AVR_HOST_PORT_C])
+#define PINC (g_pu8AvrHostPin[AVR_HOST_PORT_C])
+#define DDRD (g_sAvrHostRegs.au8Ddr[AVR_HOST_PORT_D])
+#define PORTD (g_sAvrHostRegs.au8Port[AVR_HOST_PORT_D])
+#define PIND (g_pu8AvrHostPin[AVR_HOST_PORT_D])
+
+// USART0
+#define UDR0 (g_sAvrHostRegs.u8Udr0)
+#define UCSR0A (g_sAvrHostRegs.u8Ucsr0a)
+#define UCSR0B (g_sAvrHostRegs.u8Ucsr0b)
+#define UCSR0C (g_sAvrHostRegs.u8Ucsr0c)
+#define UBRR0H (g_sAvrHostRegs.u8Ubrr0h)
+#define UBRR0L (g_sAvrHostRegs.u8Ubrr0l)
+
+#define RXC0 7
+#define TXC0 6
+#define UDRE0 5
+#define U2X0 1
+#define RXCIE0 7
+#define RXEN0 4
+#define TXEN0 3
+#define UCSZ00 1
+
+// Timer0 (CTC mode only: see vAvrHostElapseUs)
+#define TCCR0A (g_sAvrHostRegs.u8Tccr0a)
+#define TCCR0B (g_sAvrHostRegs.u8Tccr0b)
+#define OCR0A (g_sAvrHostRegs.u8Ocr0a)
+#define TIMSK0 (g_sAvrHostRegs.u8Timsk0)
+
+#define WGM01 1
+#define CS02 2
+#define CS01 1
+#define CS00 0
+#define OCIE0A 1
+
+// Reset cause
+#define MCUSR (g_sAvrHostRegs.u8Mcusr)
+
+#endif // AVR_HOST_AVR_IO_H
@@ -0,0 +1,11 @@
+//==============================================================================
+// AVR Host Emulation - <avr/wdt.h> (no watchdog on the host)
+//------------------------------------------------------------------------------
+
+#ifndef AVR_HOST_AVR_WDT_H
+#define AVR_HOST_AVR_WDT_H
+
+#define wdt_disable() ((void)0)
+#define wdt_reset() ((void)0)
+
+#endif // AVR_HOST_AVR_WDT_H
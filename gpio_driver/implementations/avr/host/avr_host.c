@@ -0,0 +1,339 @@
+//==============================================================================
+// AVR Host Emulation - Register Model and Test Hooks
+//------------------------------------------------------------------------------
+//! @file
+//! @brief Emulated ATmega328P GPIO/USART0 registers for host builds
+//------------------------------------------------------------------------------
+
+#define _GNU_SOURCE // fopencookie, memfd_create, REG_EFL
+
+// Includes ====================================================================
+#include "avr_host.h"
+#include "avr/io.h"
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+// PINx stores are trapped where the CPU can single-step from a signal
+// handler; elsewhere (or with AVR_HOST_NO_PIN_TRAP, e.g. under gdb/valgrind)
+// they are detected at the next sync point
+#if defined(__linux__) && defined(__x86_64__) && !defined(AVR_HOST_NO_PIN_TRAP)
+#define AVR_HOST_PIN_TRAP
+#define AVR_HOST_EFLAGS_TF 0x100
+#endif
+
+// Global Variables ============================================================
+volatile sAvrHostRegs_t g_sAvrHostRegs;
+volatile bool g_bAvrHostIrqEnabled = false;
+
+// Static Variables ============================================================
+static uint8_t g_au8AvrHostPinFallback[AVR_HOST_PORT_COUNT];
+static uint8_t *g_pu8AvrHostPinRw = g_au8AvrHostPinFallback; // Model's view
+
+static uint8_t g_au8AvrHostPinShadow[AVR_HOST_PORT_COUNT]; // Last published
+static uint8_t g_au8AvrHostDriven[AVR_HOST_PORT_COUNT];
+static uint8_t g_au8AvrHostDrivenLevel[AVR_HOST_PORT_COUNT];
+
+static bool g_bAvrHostTxArmed = false; // UDRE0 polled: a UDR0 store follows
+static char g_acAvrHostTx[AVR_HOST_TX_SIZE];
+static uint32_t g_u32AvrHostTxLen = 0;
+static uint32_t g_u32AvrHostOverruns = 0;
+static double g_dAvrHostDelayedUs = 0.0;
+static double g_dAvrHostTimer0Us = 0.0; // Since the last compare match
+
+#ifdef AVR_HOST_PIN_TRAP
+static long g_lAvrHostPageSize = 0;
+static volatile uint8_t *g_pu8AvrHostPinRo = NULL;
+static volatile sig_atomic_t g_iAvrHostTrapPort = -1;
+static struct sigaction g_sAvrHostOldSegv;
+static struct sigaction g_sAvrHostOldTrap;
+#endif
+
+// Firmware's view of PINA..PIND: read-only page on trap hosts
+volatile uint8_t *g_pu8AvrHostPin = g_au8AvrHostPinFallback;
+
+// Provided by platform_adapter.c when it is linked
+extern void vAvrHostIsrUsartRx(void) __attribute__((weak));
+extern void vAvrHostIsrTimer0CompA(void) __attribute__((weak));
+
+// Private Function Prototypes ================================================
+static uint8_t u8AvrHost_Level(uint8_t u8Port);
+static void vAvrHost_Publish(uint8_t u8Port);
+static void vAvrHost_CommitTx(void);
+static void vAvrHost_Setup(void) __attribute__((constructor));
+#ifdef AVR_HOST_PIN_TRAP
+static void vAvrHost_OnSegv(int iSignal, siginfo_t *psInfo, void *pvContext);
+static void vAvrHost_OnTrap(int iSignal, siginfo_t *psInfo, void *pvContext);
+#endif
+
+// Functions ===================================================================
+
+void vAvrHostReset(void) {
+  memset((void *)&g_sAvrHostRegs, 0, sizeof(g_sAvrHostRegs));
+  g_sAvrHostRegs.u8Ucsr0a = (uint8_t)_BV(UDRE0); // Datasheet reset value
+  g_sAvrHostRegs.u8Mcusr = 0x01;                 // PORF: power-on reset
+  g_bAvrHostIrqEnabled = false;
+
+  memset(g_au8AvrHostDriven, 0, sizeof(g_au8AvrHostDriven));
+  memset(g_au8AvrHostDrivenLevel, 0, sizeof(g_au8AvrHostDrivenLevel));
+  g_bAvrHostTxArmed = false;
+  g_u32AvrHostTxLen = 0;
+  g_u32AvrHostOverruns = 0;
+  g_dAvrHostDelayedUs = 0.0;
+  g_dAvrHostTimer0Us = 0.0;
+
+  for (uint8_t i = 0; i < AVR_HOST_PORT_COUNT; i++) {
+    vAvrHost_Publish(i);
+  }
+}
+
+void vAvrHostSync(void) {
+  for (uint8_t i = 0; i < AVR_HOST_PORT_COUNT; i++) {
+#ifndef AVR_HOST_PIN_TRAP
+    // Untrapped PINx store: anything other than the published level
+    uint8_t u8Written = g_pu8AvrHostPinRw[i];
+    if (u8Written != g_au8AvrHostPinShadow[i]) {
+      g_sAvrHostRegs.au8Port[i] ^= u8Written;
+    }
+#endif
+    vAvrHost_Publish(i);
+  }
+
+  vAvrHost_CommitTx();
+  g_sAvrHostRegs.u8Ucsr0a |= (uint8_t)_BV(UDRE0); // Transmitter never busy
+}
+
+void vAvrHostSetInput(uint8_t u8Port, uint8_t u8Pin, bool bLevel) {
+  if (u8Port >= AVR_HOST_PORT_COUNT || u8Pin > 7) {
+    return;
+  }
+  g_au8AvrHostDriven[u8Port] |= (uint8_t)_BV(u8Pin);
+  if (bLevel) {
+    g_au8AvrHostDrivenLevel[u8Port] |= (uint8_t)_BV(u8Pin);
+  } else {
+    g_au8AvrHostDrivenLevel[u8Port] &= (uint8_t)~_BV(u8Pin);
+  }
+  vAvrHostSync();
+}
+
+void vAvrHostReleaseInput(uint8_t u8Port, uint8_t u8Pin) {
+  if (u8Port >= AVR_HOST_PORT_COUNT || u8Pin > 7) {
+    return;
+  }
+  g_au8AvrHostDriven[u8Port] &= (uint8_t)~_BV(u8Pin);
+  vAvrHostSync();
+}
+
+uint32_t u32AvrHostUartInject(const char *pcData, uint32_t u32Len) {
+  uint32_t u32Delivered = 0;
+
+  for (uint32_t i = 0; i < u32Len; i++) {
+    vAvrHostSync(); // UDR0 is shared with TX: commit any pending byte first
+
+    bool bEnabled = g_bAvrHostIrqEnabled && vAvrHostIsrUsartRx != NULL &&
+                    (g_sAvrHostRegs.u8Ucsr0b & _BV(RXEN0)) &&
+                    (g_sAvrHostRegs.u8Ucsr0b & _BV(RXCIE0));
+    if (!bEnabled) {
+      g_u32AvrHostOverruns++;
+      continue;
+    }
+
+    g_sAvrHostRegs.u8Udr0 = (uint8_t)pcData[i];
+    g_sAvrHostRegs.u8Ucsr0a |= (uint8_t)_BV(RXC0);
+    g_bAvrHostIrqEnabled = false; // The CPU clears I on ISR entry
+    vAvrHostIsrUsartRx();
+    g_bAvrHostIrqEnabled = true; // ... and RETI sets it again
+    g_sAvrHostRegs.u8Ucsr0a &= (uint8_t)~_BV(RXC0);
+    u32Delivered++;
+  }
+  return u32Delivered;
+}
+
+uint32_t u32AvrHostUartTake(char *pcBuffer, uint32_t u32Size) {
+  vAvrHostSync();
+  if (pcBuffer == NULL || u32Size == 0) {
+    return 0;
+  }
+
+  uint32_t u32Copy = (g_u32AvrHostTxLen < u32Size) ? g_u32AvrHostTxLen
+                                                   : u32Size;
+  memcpy(pcBuffer, g_acAvrHostTx, u32Copy);
+  if (u32Copy < u32Size) {
+    pcBuffer[u32Copy] = '\0';
+  }
+  g_u32AvrHostTxLen -= u32Copy;
+  memmove(g_acAvrHostTx, g_acAvrHostTx + u32Copy, g_u32AvrHostTxLen);
+  return u32Copy;
+}
+
+uint32_t u32AvrHostUartOverruns(void) { return g_u32AvrHostOverruns; }
+
+uint64_t u64AvrHostDelayedUs(void) { return (uint64_t)g_dAvrHostDelayedUs; }
+
+void vAvrHostElapseUs(double dUs) {
+  // CS02..CS00 -> prescaler; 6 and 7 (external clock) are not modelled
+  static const uint16_t au16Prescale[8] = {0, 1, 8, 64, 256, 1024, 0, 0};
+  uint16_t u16Prescale = au16Prescale[g_sAvrHostRegs.u8Tccr0b & 0x07];
+  if (u16Prescale == 0 || !(g_sAvrHostRegs.u8Tccr0a & _BV(WGM01))) {
+    return; // Stopped, or a mode other than CTC
+  }
+
+  double dPeriodUs = (double)(g_sAvrHostRegs.u8Ocr0a + 1u) * u16Prescale *
+                     1e6 / (double)F_CPU;
+  g_dAvrHostTimer0Us += dUs;
+  while (g_dAvrHostTimer0Us >= dPeriodUs) {
+    g_dAvrHostTimer0Us -= dPeriodUs;
+    bool bEnabled = g_bAvrHostIrqEnabled && vAvrHostIsrTimer0CompA != NULL &&
+                    (g_sAvrHostRegs.u8Timsk0 & _BV(OCIE0A));
+    if (bEnabled) {
+      g_bAvrHostIrqEnabled = false; // As in u32AvrHostUartInject()
+      vAvrHostIsrTimer0CompA();
+      g_bAvrHostIrqEnabled = true;
+    }
+  }
+}
+
+void vAvrHostDelayUs(double dUs) {
+  g_dAvrHostDelayedUs += dUs;
+  vAvrHostElapseUs(dUs);
+  vAvrHostSync();
+}
+
+void vAvrHostPollFlag(volatile uint8_t *pu8Sfr, uint8_t u8Bit) {
+  vAvrHostSync();
+  if (pu8Sfr == &g_sAvrHostRegs.u8Ucsr0a && u8Bit == UDRE0) {
+    g_bAvrHostTxArmed = true;
+  }
+}
+
+// Stream ======================================================================
+
+static int (*g_pfAvrHostPut)(char c, FILE *psStream) = NULL;
+static FILE *g_psAvrHostStream = NULL;
+
+static ssize_t iAvrHost_StreamWrite(void *pvCookie, const char *pcBuf,
+                                    size_t u32Size) {
+  (void)pvCookie;
+  for (size_t i = 0; i < u32Size; i++) {
+    g_pfAvrHostPut(pcBuf[i], g_psAvrHostStream);
+  }
+  return (ssize_t)u32Size;
+}
+
+FILE *psAvrHostOpenStream(int (*pfPut)(char c, FILE *psStream)) {
+  if (g_psAvrHostStream == NULL) {
+    cookie_io_functions_t sIo = {.write = iAvrHost_StreamWrite};
+    g_psAvrHostStream = fopencookie(NULL, "w", sIo);
+    if (g_psAvrHostStream == NULL) {
+      return stdout;
+    }
+    setvbuf(g_psAvrHostStream, NULL, _IONBF, 0); // avr-libc: unbuffered
+  }
+  g_pfAvrHostPut = pfPut;
+  return g_psAvrHostStream;
+}
+
+// Private Functions ===========================================================
+
+static uint8_t u8AvrHost_Level(uint8_t u8Port) {
+  uint8_t u8Ddr = g_sAvrHostRegs.au8Ddr[u8Port];
+  uint8_t u8PortReg = g_sAvrHostRegs.au8Port[u8Port];
+  uint8_t u8Driven = g_au8AvrHostDriven[u8Port];
+
+  // Inputs: external level where driven, else pull-up (PORTx=1) or low
+  uint8_t u8Input = (uint8_t)((u8Driven & g_au8AvrHostDrivenLevel[u8Port]) |
+                              (~u8Driven & u8PortReg));
+  return (uint8_t)((u8Ddr & u8PortReg) | (~u8Ddr & u8Input));
+}
+
+static void vAvrHost_Publish(uint8_t u8Port) {
+  uint8_t u8Level = u8AvrHost_Level(u8Port);
+  g_pu8AvrHostPinRw[u8Port] = u8Level;
+  g_au8AvrHostPinShadow[u8Port] = u8Level;
+}
+
+static void vAvrHost_CommitTx(void) {
+  if (!g_bAvrHostTxArmed) {
+    return;
+  }
+  g_bAvrHostTxArmed = false;
+  if (g_u32AvrHostTxLen < sizeof(g_acAvrHostTx)) {
+    g_acAvrHostTx[g_u32AvrHostTxLen++] = (char)g_sAvrHostRegs.u8Udr0;
+  } else {
+    g_u32AvrHostOverruns++;
+  }
+}
+
+static void vAvrHost_Setup(void) {
+#ifdef AVR_HOST_PIN_TRAP
+  // One page, two mappings: the model writes levels through a RW alias,
+  // the firmware's PINx pointer is read-only so its stores fault
+  g_lAvrHostPageSize = sysconf(_SC_PAGESIZE);
+  int iFd = memfd_create("avr_host_pin", MFD_CLOEXEC);
+  if (iFd >= 0 && ftruncate(iFd, g_lAvrHostPageSize) == 0) {
+    void *pvRw = mmap(NULL, (size_t)g_lAvrHostPageSize,
+                      PROT_READ | PROT_WRITE, MAP_SHARED, iFd, 0);
+    void *pvRo =
+        mmap(NULL, (size_t)g_lAvrHostPageSize, PROT_READ, MAP_SHARED, iFd, 0);
+    if (pvRw != MAP_FAILED && pvRo != MAP_FAILED) {
+      g_pu8AvrHostPinRw = (uint8_t *)pvRw;
+      g_pu8AvrHostPinRo = (volatile uint8_t *)pvRo;
+      g_pu8AvrHostPin = g_pu8AvrHostPinRo;
+
+      struct sigaction sAction;
+      memset(&sAction, 0, sizeof(sAction));
+      sAction.sa_flags = SA_SIGINFO;
+      sAction.sa_sigaction = vAvrHost_OnSegv;
+      sigaction(SIGSEGV, &sAction, &g_sAvrHostOldSegv);
+      sAction.sa_sigaction = vAvrHost_OnTrap;
+      sigaction(SIGTRAP, &sAction, &g_sAvrHostOldTrap);
+    }
+  }
+  if (iFd >= 0) {
+    close(iFd);
+  }
+#endif
+  vAvrHostReset();
+}
+
+#ifdef AVR_HOST_PIN_TRAP
+static void vAvrHost_OnSegv(int iSignal, siginfo_t *psInfo, void *pvContext) {
+  (void)iSignal;
+  volatile uint8_t *pu8Addr = (volatile uint8_t *)psInfo->si_addr;
+  if (pu8Addr < g_pu8AvrHostPinRo || pu8Addr >= g_pu8AvrHostPinRo +
+                                                    AVR_HOST_PORT_COUNT) {
+    // Not a PINx store: restore the previous handler, let it fault again
+    sigaction(SIGSEGV, &g_sAvrHostOldSegv, NULL);
+    return;
+  }
+
+  // Let the store through, single-step it, then apply it in OnTrap
+  g_iAvrHostTrapPort = (int)(pu8Addr - g_pu8AvrHostPinRo);
+  mprotect((void *)g_pu8AvrHostPinRo, (size_t)g_lAvrHostPageSize,
+           PROT_READ | PROT_WRITE);
+  ucontext_t *psContext = (ucontext_t *)pvContext;
+  psContext->uc_mcontext.gregs[REG_EFL] |= AVR_HOST_EFLAGS_TF;
+}
+
+static void vAvrHost_OnTrap(int iSignal, siginfo_t *psInfo, void *pvContext) {
+  (void)iSignal;
+  (void)psInfo;
+  if (g_iAvrHostTrapPort < 0) {
+    sigaction(SIGTRAP, &g_sAvrHostOldTrap, NULL);
+    raise(SIGTRAP);
+    return;
+  }
+
+  ucontext_t *psContext = (ucontext_t *)pvContext;
+  psContext->uc_mcontext.gregs[REG_EFL] &= ~AVR_HOST_EFLAGS_TF;
+  mprotect((void *)g_pu8AvrHostPinRo, (size_t)g_lAvrHostPageSize, PROT_READ);
+
+  // Writing 1 to a PINx bit toggles PORTx; 0 bits have no effect
+  uint8_t u8Port = (uint8_t)g_iAvrHostTrapPort;
+  g_iAvrHostTrapPort = -1;
+  g_sAvrHostRegs.au8Port[u8Port] ^= g_pu8AvrHostPinRw[u8Port];
+  vAvrHost_Publish(u8Port);
+}
+#endif
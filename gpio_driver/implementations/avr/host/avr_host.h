@@ -0,0 +1,136 @@
+//==============================================================================
+// AVR Host Emulation - Register Model and Test Hooks
+//------------------------------------------------------------------------------
+//! @file
+//! @brief Emulated ATmega328P I/O registers so the real AVR sources
+//!        (gpioPlatform_avr.c, platform_adapter.c) build with gcc on Linux
+//!
+//! The headers in this directory shadow <avr/io.h>, <avr/interrupt.h>,
+//! <avr/wdt.h> and <util/delay.h> (put it first on the include path and
+//! define AVR_HOST_EMULATION). Register semantics:
+//!
+//!   DDRx / PORTx  plain bytes, as on the chip
+//!   PINx          reads the pin level: outputs follow PORTx, inputs follow
+//!                 the level injected with vAvrHostSetInput(), else the
+//!                 pull-up (PORTx bit set) or 0. Writing 1 bits toggles
+//!                 PORTx (x86 hosts: trapped at the store; elsewhere: at the
+//!                 next sync point, and a store equal to the current level
+//!                 is not seen)
+//!   UDR0          stores are transmitted (see u32AvrHostUartTake()); reads
+//!                 return the byte being received in USART_RX_vect
+//!   Timer0        CTC mode (WGM01) only: each OCR0A+1 prescaled clocks of
+//!                 delay or vAvrHostElapseUs() time runs TIMER0_COMPA_vect
+//!                 if OCIE0A and interrupts are enabled
+//!
+//! Levels are refreshed at sync points: every _delay_*, UART access, input
+//! injection or explicit vAvrHostSync(). Like the chip's input synchronizer,
+//! a PINx read right after changing DDRx/PORTx may still see the old level.
+//------------------------------------------------------------------------------
+
+#ifndef AVR_HOST_H
+#define AVR_HOST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Includes ====================================================================
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Constants ===================================================================
+#define AVR_HOST_PORT_COUNT 4 // A..D; the 328P has B, C and D
+#define AVR_HOST_PORT_B 1
+#define AVR_HOST_PORT_C 2
+#define AVR_HOST_PORT_D 3
+#define AVR_HOST_TX_SIZE 4096
+
+// Type Definitions ============================================================
+typedef struct {
+  uint8_t au8Ddr[AVR_HOST_PORT_COUNT];
+  uint8_t au8Port[AVR_HOST_PORT_COUNT];
+  uint8_t u8Udr0;
+  uint8_t u8Ucsr0a;
+  uint8_t u8Ucsr0b;
+  uint8_t u8Ucsr0c;
+  uint8_t u8Ubrr0h;
+  uint8_t u8Ubrr0l;
+  uint8_t u8Tccr0a;
+  uint8_t u8Tccr0b;
+  uint8_t u8Ocr0a;
+  uint8_t u8Timsk0;
+  uint8_t u8Mcusr;
+} sAvrHostRegs_t;
+
+// Global Variables ============================================================
+extern volatile sAvrHostRegs_t g_sAvrHostRegs;
+extern volatile uint8_t *g_pu8AvrHostPin; // PINA..PIND, see avr_host.c
+extern volatile bool g_bAvrHostIrqEnabled; // SREG I bit (sei/cli)
+
+// Function Prototypes =========================================================
+
+/**
+ * @brief Power-on reset: registers zero, inputs released, UART buffers empty
+ */
+void vAvrHostReset(void);
+
+/**
+ * @brief Recompute PINx from DDRx/PORTx/injected levels; commit a pending
+ *        UDR0 byte
+ */
+void vAvrHostSync(void);
+
+/**
+ * @brief Drive an input pin from outside (button, sensor)
+ */
+void vAvrHostSetInput(uint8_t u8Port, uint8_t u8Pin, bool bLevel);
+
+/**
+ * @brief Stop driving a pin: it floats (reads 0) or follows its pull-up
+ */
+void vAvrHostReleaseInput(uint8_t u8Port, uint8_t u8Pin);
+
+/**
+ * @brief Receive bytes on UART0: each one runs USART_RX_vect if RXCIE0 and
+ *        interrupts are enabled
+ * @return Bytes delivered; the rest are counted as overruns
+ */
+uint32_t u32AvrHostUartInject(const char *pcData, uint32_t u32Len);
+
+/**
+ * @brief Take what the firmware transmitted on UART0 since the last call
+ * @return Bytes copied (output is NUL-terminated when there is room)
+ */
+uint32_t u32AvrHostUartTake(char *pcBuffer, uint32_t u32Size);
+
+/**
+ * @brief Bytes lost because the RX interrupt was disabled or TX overflowed
+ */
+uint32_t u32AvrHostUartOverruns(void);
+
+/**
+ * @brief Let time pass outside the firmware (timers advance, no sync point)
+ */
+void vAvrHostElapseUs(double dUs);
+
+/**
+ * @brief Total time requested through _delay_ms/_delay_us (not slept)
+ */
+uint64_t u64AvrHostDelayedUs(void);
+
+/**
+ * @brief Stand-in for avr-libc FDEV_SETUP_STREAM: an unbuffered stream that
+ *        writes each character through pfPut (like the chip's stdout)
+ */
+FILE *psAvrHostOpenStream(int (*pfPut)(char c, FILE *psStream));
+
+// Hooks used by the shadow headers
+void vAvrHostDelayUs(double dUs);
+void vAvrHostPollFlag(volatile uint8_t *pu8Sfr, uint8_t u8Bit);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AVR_HOST_H
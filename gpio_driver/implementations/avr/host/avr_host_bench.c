@@ -0,0 +1,202 @@
+//==============================================================================
+// AVR Host Emulation - Benchmark
+//------------------------------------------------------------------------------
+//! @file
+//! @brief Runs the real AVR driver and UART adapter against the emulated
+//!        registers and times their hot paths
+//!
+//! The register model the numbers depend on is checked by avr_host_check
+//! (ctest); this program only measures:
+//!   1. sGpioInterfaceAVR write / read (name lookup + register access)
+//!   2. eGpioHelperRead (HAL read + Digital Twin merge), by name and by pin
+//!      handle, and eGpioHelperReadAll
+//!   3. PINB toggle store (trap cost on x86, see avr_host.h)
+//!   4. one DT line through USART_RX_vect + bUartDispatchPendingLine
+//!   5. vApplyReceivedJsonLine parse (one pin, and a two-pin map)
+//!   6. vHelperSend printf through the UART stream
+//!
+//! stdout is the emulated UART, so results go to stderr.
+//! Usage: ./avr_host_bench [iterations]   (default 200000)
+//------------------------------------------------------------------------------
+
+#define _GNU_SOURCE
+
+#include "avr_host.h"
+#include "gpioLib.h"
+#include "gpio_helper.h"
+#include "helper_common.h"
+#include "implementations/avr/gpioPlatform_avr.h"
+#include "implementations/avr/uart_line_callback.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_LED_BIT 5    // LED1 = PB5 (examples/avr/config.json)
+#define BENCH_BUTTON_BIT 0 // BUTTON1 = PB0, pull-up
+#define BENCH_BUTTON_PIN 1 // BUTTON1's pin handle (config order)
+
+extern const sGpioInterface_t *psGetPlatformGpioInterface(void);
+extern uint32_t u32PlatformGetTickMs(void);
+
+static const char g_acDtLine[] =
+    "{\"t\":\"GPIO\",\"p\":\"BUTTON1\",\"v\":1}\n";
+static const char g_acDtMap[] =
+    "{\"t\":\"GPIO\",\"s\":{\"NOPE\":0,\"BUTTON1\":1}}";
+
+/**
+ * @brief Line callback normally provided by app_main.c (nothing to do here)
+ */
+void vOnUartLineReceived(const char *pcLine) { (void)pcLine; }
+
+/**
+ * @brief Frame callback normally provided by app_main.c (nothing to do here)
+ */
+void vOnUartFrameReceived(const uint8_t *pu8Frame, uint16_t u16Len) {
+  (void)pu8Frame;
+  (void)u16Len;
+}
+
+/**
+ * @brief Telemetry hook normally provided by app_main.c: always JSON here
+ */
+bool bOnHelperSend(const char *pcCmd, const char *pcPin, int iValue) {
+  (void)pcCmd;
+  (void)pcPin;
+  (void)iValue;
+  return false;
+}
+
+/**
+ * @brief Tick hook normally provided by app_main.c (nothing to do here)
+ */
+void vOnPlatformTick(uint32_t u32NowMs) { (void)u32NowMs; }
+
+static double dNowUs(void) {
+  struct timespec sNow;
+  clock_gettime(CLOCK_MONOTONIC, &sNow);
+  return (double)sNow.tv_sec * 1e6 + (double)sNow.tv_nsec / 1e3;
+}
+
+static void vReport(const char *pcName, int iOps, double dUs) {
+  fprintf(stderr, "  %-28s %8d ops  %11.0f ops/s  %8.1f ns/op\n", pcName,
+          iOps, iOps / (dUs / 1e6), dUs * 1e3 / iOps);
+}
+
+int main(int argc, char **argv) {
+  int iIterations = (argc > 1) ? atoi(argv[1]) : 200000;
+  if (iIterations <= 0) {
+    iIterations = 200000;
+  }
+
+  // Same bring-up as app_main.c on the chip
+  vHalRegisterGpioInterface(psGetPlatformGpioInterface());
+  vGpioHelperInit();
+  sei();
+  const sGpioInterface_t *psGpio = psHalGetGpioInterface();
+
+  char acTx[AVR_HOST_TX_SIZE];
+  bool bValue = false;
+  volatile bool bSink = false;
+
+  // 1) HAL write / read
+  double dStart = dNowUs();
+  for (int i = 0; i < iIterations; i++) {
+    psGpio->eHalGpioWriteFunc("LED1", (i & 1) != 0);
+  }
+  vReport("sGpioInterfaceAVR write", iIterations, dNowUs() - dStart);
+
+  dStart = dNowUs();
+  for (int i = 0; i < iIterations; i++) {
+    psGpio->eHalGpioReadFunc("BUTTON1", &bValue);
+    bSink = bValue;
+  }
+  vReport("sGpioInterfaceAVR read", iIterations, dNowUs() - dStart);
+
+  // 2) Helper read with the DT merge
+  dStart = dNowUs();
+  for (int i = 0; i < iIterations; i++) {
+    eGpioHelperRead("BUTTON1", &bValue);
+    bSink = bValue;
+  }
+  vReport("eGpioHelperRead (merge)", iIterations, dNowUs() - dStart);
+
+  dStart = dNowUs();
+  for (int i = 0; i < iIterations; i++) {
+    eGpioHelperReadPin(BENCH_BUTTON_PIN, &bValue);
+    bSink = bValue;
+  }
+  vReport("eGpioHelperReadPin (handle)", iIterations, dNowUs() - dStart);
+
+  uint8_t u8Bits = 0;
+  dStart = dNowUs();
+  for (int i = 0; i < iIterations; i++) {
+    eGpioHelperReadAll(&u8Bits, 2);
+    bSink = (u8Bits != 0);
+  }
+  vReport("eGpioHelperReadAll (2 pins)", iIterations, dNowUs() - dStart);
+
+  // 3) PINx toggle: a signal round trip per store on trapping hosts
+  int iToggles = iIterations / 100;
+  if (iToggles < 100) {
+    iToggles = 100;
+  }
+  dStart = dNowUs();
+  for (int i = 0; i < iToggles; i++) {
+    PINB = (uint8_t)_BV(BENCH_LED_BIT);
+    vAvrHostSync();
+  }
+  vReport("PINB toggle store", iToggles, dNowUs() - dStart);
+
+  // 4) RX: one DT line byte by byte through the ISR, then dispatch
+  int iDispatched = 0;
+  dStart = dNowUs();
+  for (int i = 0; i < iIterations; i++) {
+    u32AvrHostUartInject(g_acDtLine, sizeof(g_acDtLine) - 1);
+    iDispatched += bUartDispatchPendingLine() ? 1 : 0;
+  }
+  vReport("RX ISR line + dispatch", iIterations, dNowUs() - dStart);
+  if (iDispatched != iIterations) {
+    fprintf(stderr, "[AVR HOST] [ERROR] %d of %d lines seen\n", iDispatched,
+            iIterations);
+    return 1;
+  }
+  // Two pins in one map line: half the ISR framing and dispatches of two
+  // single-pin lines
+  dStart = dNowUs();
+  for (int i = 0; i < iIterations; i++) {
+    u32AvrHostUartInject(g_acDtMap, sizeof(g_acDtMap) - 1);
+    u32AvrHostUartInject("\n", 1);
+    bUartDispatchPendingLine();
+  }
+  vReport("RX ISR 2-pin map + dispatch", iIterations, dNowUs() - dStart);
+
+  // 5) DT parse only
+  dStart = dNowUs();
+  for (int i = 0; i < iIterations; i++) {
+    vApplyReceivedJsonLine(g_acDtLine);
+  }
+  vReport("vApplyReceivedJsonLine", iIterations, dNowUs() - dStart);
+  dStart = dNowUs();
+  for (int i = 0; i < iIterations; i++) {
+    vApplyReceivedJsonLine(g_acDtMap);
+  }
+  vReport("vApplyReceivedJsonLine (map)", iIterations, dNowUs() - dStart);
+
+  // 6) TX: printf + uart_putchar per byte, drained like a host reader would
+  dStart = dNowUs();
+  for (int i = 0; i < iIterations; i++) {
+    vHelperSend("GPIO", "LED1", i & 1);
+    if ((i & 63) == 63) {
+      u32AvrHostUartTake(acTx, sizeof(acTx));
+    }
+  }
+  u32AvrHostUartTake(acTx, sizeof(acTx));
+  vReport("vHelperSend (UART stream)", iIterations, dNowUs() - dStart);
+
+  (void)bSink;
+  fprintf(stderr, "[AVR HOST] UART overruns: %u, delayed: %llu us\n",
+          u32AvrHostUartOverruns(),
+          (unsigned long long)u64AvrHostDelayedUs());
+  return 0;
+}
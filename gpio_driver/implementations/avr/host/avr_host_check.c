@@ -0,0 +1,298 @@
+//==============================================================================
+// AVR Host Emulation - Checks
+//------------------------------------------------------------------------------
+//! @file
+//! @brief Checks the register model and the AVR adapter the benchmark relies
+//!        on, without timed loops (registered with CTest)
+//!
+//! Covers PINx toggle, pull-up, injected inputs, grouped read/write, Digital
+//! Twin input lines, RX line and frame assembly, RX window and lanes, Timer0
+//! tick, ATOMIC_BLOCK and TX capture.
+//!
+//! stdout is the emulated UART, so results go to stderr.
+//! Usage: ./avr_host_check   (exit status 0 = all checks passed)
+//------------------------------------------------------------------------------
+
+#define _GNU_SOURCE
+
+#include "avr_host.h"
+#include "gpioLib.h"
+#include "gpio_helper.h"
+#include "helper_common.h"
+#include "implementations/avr/gpioPlatform_avr.h"
+#include "implementations/avr/uart_line_callback.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <string.h>
+#include <util/atomic.h>
+
+#define CHECK_LED_BIT 5    // LED1 = PB5 (examples/avr/config.json)
+#define CHECK_BUTTON_BIT 0 // BUTTON1 = PB0, pull-up
+#define CHECK_BUTTON_PIN 1 // BUTTON1's pin handle (config order)
+
+extern const sGpioInterface_t *psGetPlatformGpioInterface(void);
+extern uint32_t u32PlatformGetTickMs(void);
+
+static const char g_acDtPressed[] =
+    "{\"t\":\"GPIO\",\"p\":\"BUTTON1\",\"v\":0}";
+static const char g_acDtLine[] =
+    "{\"t\":\"GPIO\",\"p\":\"BUTTON1\",\"v\":1}\n";
+static const char g_acDtMap[] =
+    "{\"t\":\"GPIO\",\"s\":{\"NOPE\":0,\"BUTTON1\":1}}";
+/* Twin traffic on another pin (low: no effect on LED1 without a pull-up) */
+static const char g_acDtOther[] = "{\"t\":\"GPIO\",\"p\":\"LED1\",\"v\":0}\n";
+static const char g_acMcpLine[] = "gpio_read BUTTON1\n";
+
+static char g_acLastLine[128];
+static uint32_t g_u32Lines = 0;
+static uint16_t g_u16LastFrameLen = 0;
+static uint32_t g_u32LastTickMs = 0;
+static int g_iFailures = 0;
+
+/**
+ * @brief Line callback normally provided by app_main.c (MCP lane: records the
+ *        command only here)
+ */
+void vOnUartLineReceived(const char *pcLine) {
+  strncpy(g_acLastLine, pcLine, sizeof(g_acLastLine) - 1);
+  g_acLastLine[sizeof(g_acLastLine) - 1] = '\0';
+  g_u32Lines++;
+}
+
+/**
+ * @brief Frame callback normally provided by app_main.c (length only here)
+ */
+void vOnUartFrameReceived(const uint8_t *pu8Frame, uint16_t u16Len) {
+  (void)pu8Frame;
+  g_u16LastFrameLen = u16Len;
+}
+
+/**
+ * @brief Telemetry hook normally provided by app_main.c: always JSON here
+ */
+bool bOnHelperSend(const char *pcCmd, const char *pcPin, int iValue) {
+  (void)pcCmd;
+  (void)pcPin;
+  (void)iValue;
+  return false;
+}
+
+/**
+ * @brief Tick hook normally provided by app_main.c (records the tick here)
+ */
+void vOnPlatformTick(uint32_t u32NowMs) { g_u32LastTickMs = u32NowMs; }
+
+static void vCheck(bool bOk, const char *pcWhat) {
+  if (!bOk) {
+    fprintf(stderr, "[AVR HOST] [ERROR] Check failed: %s\n", pcWhat);
+    g_iFailures++;
+  }
+}
+
+/**
+ * @brief Verify the emulated semantics the benchmarks rely on
+ */
+static void vSelfCheck(const sGpioInterface_t *psGpio) {
+  char acTx[256];
+  bool bValue = false;
+
+  // Output: PORTx drives PINx
+  vCheck(psGpio->eHalGpioWriteFunc("LED1", true) == RET_TYPE_SUCCESS,
+         "LED1 write");
+  vAvrHostSync();
+  vCheck((PINB & _BV(CHECK_LED_BIT)) != 0, "PINB follows PORTB on output");
+
+  // Writing 1 to PINx toggles PORTx
+  PINB = (uint8_t)_BV(CHECK_LED_BIT);
+  vAvrHostSync();
+  vCheck((PORTB & _BV(CHECK_LED_BIT)) == 0, "PINB write toggles PORTB");
+  vCheck(psGpio->eHalGpioReadFunc("LED1", &bValue) == RET_TYPE_SUCCESS &&
+             !bValue,
+         "LED1 reads back toggled level");
+
+  // Input: pull-up, then an injected level, then the pull-up again
+  vCheck(psGpio->eHalGpioReadFunc("BUTTON1", &bValue) == RET_TYPE_SUCCESS &&
+             bValue,
+         "BUTTON1 pull-up reads high");
+  vAvrHostSetInput(AVR_HOST_PORT_B, CHECK_BUTTON_BIT, false);
+  psGpio->eHalGpioReadFunc("BUTTON1", &bValue);
+  vCheck(!bValue, "BUTTON1 reads injected low");
+  vAvrHostReleaseInput(AVR_HOST_PORT_B, CHECK_BUTTON_BIT);
+  psGpio->eHalGpioReadFunc("BUTTON1", &bValue);
+  vCheck(bValue, "BUTTON1 back on pull-up");
+
+  // RX: split line, assembled by the ISR, dispatched from the main loop
+  u32AvrHostUartTake(acTx, sizeof(acTx)); // Drop the LED1 write's output
+  u32AvrHostUartInject(g_acMcpLine, 5);
+  vCheck(!bUartDispatchPendingLine(), "no line before newline");
+  u32AvrHostUartInject(g_acMcpLine + 5, sizeof(g_acMcpLine) - 7);
+  u32AvrHostUartInject("\r\n", 2);
+  vCheck(bUartDispatchPendingLine(), "line dispatched");
+  vCheck(strncmp(g_acLastLine, g_acMcpLine, sizeof(g_acMcpLine) - 2) == 0 &&
+             g_acLastLine[sizeof(g_acMcpLine) - 2] == '\0',
+         "line content");
+  // A twin line is applied by the platform, not handed to the callback
+  uint32_t u32Lines = g_u32Lines;
+  u32AvrHostUartInject(g_acDtPressed, sizeof(g_acDtPressed) - 1);
+  u32AvrHostUartInject("\n", 1);
+  vCheck(bUartDispatchPendingLine() && g_u32Lines == u32Lines,
+         "DT line on the twin lane");
+  vCheck(eGpioHelperRead("BUTTON1", &bValue) == RET_TYPE_SUCCESS && !bValue,
+         "DT press merged into BUTTON1");
+  vCheck(eGpioHelperReadPin(CHECK_BUTTON_PIN, &bValue) == RET_TYPE_SUCCESS &&
+             !bValue,
+         "DT press merged into BUTTON1 by handle");
+  uint8_t u8Bits = 0;
+  psGpio->eHalGpioWriteFunc("LED1", true);
+  vCheck(eGpioHelperReadAll(&u8Bits, 2) == RET_TYPE_SUCCESS && u8Bits == 0x01,
+         "read-all: LED1 high, BUTTON1 pressed by DT");
+  vApplyReceivedJsonLine("{\"t\":\"LOG\",\"p\":\"BUTTON1\",\"v\":1}");
+  vCheck(eGpioHelperReadPin(CHECK_BUTTON_PIN, &bValue) == RET_TYPE_SUCCESS &&
+             !bValue,
+         "DT line of another type ignored");
+  vApplyReceivedJsonLine("{\"s\":{\"BUTTON1\":1},\"t\":\"LOG\"}");
+  vApplyReceivedJsonLine("{\"p\":\"BUTTON1\",\"v\":1}");
+  vCheck(eGpioHelperReadPin(CHECK_BUTTON_PIN, &bValue) == RET_TYPE_SUCCESS &&
+             !bValue,
+         "DT pins before \"t\", or without it, ignored");
+  vApplyReceivedJsonLine(g_acDtMap);
+  vCheck(eGpioHelperReadPin(CHECK_BUTTON_PIN, &bValue) == RET_TYPE_SUCCESS &&
+             bValue,
+         "DT map line releases BUTTON1, unknown pin skipped");
+  vApplyReceivedJsonLine(
+      "{ \"t\" : \"GPIO\" , \"s\" : { \"BUTTON1\" : false } }");
+  vCheck(eGpioHelperReadPin(CHECK_BUTTON_PIN, &bValue) == RET_TYPE_SUCCESS &&
+             !bValue,
+         "DT map line with spaces and false presses BUTTON1");
+
+  // Grouped write: an input in the set rejects it before any store
+  uint8_t u8Mask = 0x03;
+  u8Bits = 0x00;
+  vCheck(eGpioHelperWriteMany(&u8Mask, &u8Bits, 2) == RET_TYPE_INVALID_STATE &&
+             (PORTB & _BV(CHECK_LED_BIT)) != 0,
+         "write-many: input pin rejects the whole set");
+  u8Mask = 0x01;
+  vGpioHelperFlush();
+  u32AvrHostUartTake(acTx, sizeof(acTx));
+  vCheck(eGpioHelperWriteMany(&u8Mask, &u8Bits, 2) == RET_TYPE_SUCCESS &&
+             (PORTB & _BV(CHECK_LED_BIT)) == 0,
+         "write-many: LED1 low");
+  vCheck(u32AvrHostUartTake(acTx, sizeof(acTx)) == 0,
+         "DT sync: nothing sent before the flush");
+  vGpioHelperFlush();
+  u32AvrHostUartTake(acTx, sizeof(acTx));
+  vCheck(strcmp(acTx, "{\"t\":\"GPIO\",\"s\":{\"LED1\":0}}\r\n") == 0,
+         "write-many: one aggregated DT line");
+  // The twin hears about changes only, once per flush
+  eGpioHelperWriteMany(&u8Mask, &u8Bits, 2);
+  eGpioHelperWrite("LED1", true);
+  eGpioHelperWrite("LED1", false);
+  vGpioHelperFlush();
+  vCheck(u32AvrHostUartTake(acTx, sizeof(acTx)) == 0,
+         "DT sync: repeated level not resent");
+  eGpioHelperWrite("LED1", false);
+  eGpioHelperWrite("LED1", true);
+  vGpioHelperFlush();
+  u32AvrHostUartTake(acTx, sizeof(acTx));
+  vCheck(strcmp(acTx, "{\"t\":\"GPIO\",\"s\":{\"LED1\":1}}\r\n") == 0,
+         "DT sync: new level sent once");
+
+  // RX: a frame between 0x00 delimiters, '\n' inside it is data
+  u32AvrHostUartInject("\0ab\ncd\0", 7);
+  vCheck(bUartDispatchPendingLine() && g_u16LastFrameLen == 5,
+         "binary frame dispatched");
+
+  // RX window: lines past the free slots are dropped whole and counted
+  uint8_t u8Slots = 0;
+  uint8_t u8Free = 0;
+  uint32_t u32Dropped = 0;
+  u32Lines = g_u32Lines;
+  vUartGetRxFlow(&u8Slots, &u8Free, &u32Dropped);
+  vCheck(u8Slots >= 1 && u8Free == u8Slots, "RX window empty");
+  for (uint8_t i = 0; i <= u8Slots; i++) {
+    u32AvrHostUartInject(g_acMcpLine, sizeof(g_acMcpLine) - 1);
+  }
+  uint32_t u32Before = u32Dropped;
+  vUartGetRxFlow(&u8Slots, &u8Free, &u32Dropped);
+  vCheck(u8Free == 0 && u32Dropped == u32Before + 1 &&
+             u32UartTakeRxOverruns() == u32Dropped &&
+             u32UartTakeRxOverruns() == 0,
+         "RX window full: one line over counted");
+  vCheck(bUartDispatchPendingLine() && g_u32Lines - u32Lines == u8Slots,
+         "RX window: queued lines dispatched in one call");
+
+  // RX lanes: a twin flood behind a full window takes no MCP slot, and the
+  // newest twin line wins
+  u32Lines = g_u32Lines;
+  for (uint8_t i = 0; i < u8Slots; i++) {
+    u32AvrHostUartInject(g_acMcpLine, sizeof(g_acMcpLine) - 1);
+  }
+  for (int i = 0; i < 8; i++) {
+    u32AvrHostUartInject(g_acDtPressed, sizeof(g_acDtPressed) - 1);
+    u32AvrHostUartInject("\n", 1);
+  }
+  u32AvrHostUartInject(g_acDtLine, sizeof(g_acDtLine) - 1); // Released
+  u32Before = u32Dropped;
+  vUartGetRxFlow(&u8Slots, &u8Free, &u32Dropped);
+  vCheck(u8Free == 0 && u32Dropped == u32Before, "RX lanes: no MCP overrun");
+  vCheck(bUartDispatchPendingLine() && g_u32Lines - u32Lines == u8Slots,
+         "RX lanes: every command dispatched");
+  vCheck(eGpioHelperRead("BUTTON1", &bValue) == RET_TYPE_SUCCESS && bValue,
+         "RX lanes: newest twin level applied");
+  // A lone pin's line survives a flood on other pins
+  u32AvrHostUartInject(g_acDtPressed, sizeof(g_acDtPressed) - 1);
+  u32AvrHostUartInject("\n", 1);
+  for (int i = 0; i < 8; i++) {
+    u32AvrHostUartInject(g_acDtOther, sizeof(g_acDtOther) - 1);
+  }
+  while (bUartDispatchPendingLine()) {
+  }
+  vCheck(eGpioHelperRead("BUTTON1", &bValue) == RET_TYPE_SUCCESS && !bValue,
+         "RX lanes: a lone pin's line survives a flood on other pins");
+  u32AvrHostUartInject(g_acDtLine, sizeof(g_acDtLine) - 1); // Released
+  bUartDispatchPendingLine();
+
+  // RX with interrupts disabled is lost
+  cli();
+  uint32_t u32Overruns = u32AvrHostUartOverruns();
+  vCheck(u32AvrHostUartInject("x", 1) == 0 &&
+             u32AvrHostUartOverruns() == u32Overruns + 1,
+         "RX with cli() counts an overrun");
+  sei();
+  u32AvrHostUartInject("\n", 1); // Flush the partial line
+
+  // Timer0 tick: one compare match per emulated millisecond, none with cli()
+  uint32_t u32Tick = u32PlatformGetTickMs();
+  vAvrHostElapseUs(5000.0);
+  vCheck(u32PlatformGetTickMs() - u32Tick == 5, "Timer0 tick counts 1 ms");
+  cli();
+  vAvrHostElapseUs(3000.0);
+  sei();
+  vCheck(u32PlatformGetTickMs() - u32Tick == 5, "no tick with cli()");
+  vCheck(g_u32LastTickMs == u32Tick + 5, "Timer0 ISR calls vOnPlatformTick");
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { vAvrHostElapseUs(2000.0); }
+  vCheck(u32PlatformGetTickMs() - u32Tick == 5 && g_bAvrHostIrqEnabled,
+         "no tick in ATOMIC_BLOCK, sei() restored");
+
+  // TX: printf through uart_putchar, LF expanded to CRLF
+  u32AvrHostUartTake(acTx, sizeof(acTx));
+  vHelperSend("GPIO", "LED1", 1);
+  u32AvrHostUartTake(acTx, sizeof(acTx));
+  vCheck(strcmp(acTx, "{\"t\":\"GPIO\",\"p\":\"LED1\",\"v\":1}\r\n") == 0,
+         "vHelperSend output on UDR0");
+}
+
+int main(void) {
+  // Same bring-up as app_main.c on the chip
+  vHalRegisterGpioInterface(psGetPlatformGpioInterface());
+  vGpioHelperInit();
+  sei();
+
+  vSelfCheck(psHalGetGpioInterface());
+  if (g_iFailures != 0) {
+    fprintf(stderr, "[AVR HOST] %d check(s) failed\n", g_iFailures);
+    return 1;
+  }
+  fprintf(stderr, "[AVR HOST] Register model checks passed\n");
+  return 0;
+}
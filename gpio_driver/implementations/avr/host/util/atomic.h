@@ -0,0 +1,23 @@
+//==============================================================================
+// AVR Host Emulation - <util/atomic.h>
+//------------------------------------------------------------------------------
+// ATOMIC_BLOCK clears the emulated global interrupt flag for the block and
+// then restores it (ATOMIC_RESTORESTATE) or sets it (ATOMIC_FORCEON). As on
+// the chip, leave the block by falling off its end, not with break/return.
+//------------------------------------------------------------------------------
+
+#ifndef AVR_HOST_UTIL_ATOMIC_H
+#define AVR_HOST_UTIL_ATOMIC_H
+
+#include "../avr_host.h"
+
+#define ATOMIC_RESTORESTATE g_bAvrHostIrqEnabled
+#define ATOMIC_FORCEON true
+
+#define ATOMIC_BLOCK(type)                                                     \
+  for (bool bAvrHostIrqSaved = (type), bAvrHostIrqOnce =                       \
+                                           (g_bAvrHostIrqEnabled = false, 1);  \
+       bAvrHostIrqOnce;                                                        \
+       g_bAvrHostIrqEnabled = bAvrHostIrqSaved, bAvrHostIrqOnce = false)
+
+#endif // AVR_HOST_UTIL_ATOMIC_H
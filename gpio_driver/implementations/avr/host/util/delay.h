@@ -0,0 +1,16 @@
+//==============================================================================
+// AVR Host Emulation - <util/delay.h>
+//------------------------------------------------------------------------------
+// Delays are accounted (u64AvrHostDelayedUs) and act as sync points, but do
+// not sleep: benchmarks measure the code, not the busy-waits.
+//------------------------------------------------------------------------------
+
+#ifndef AVR_HOST_UTIL_DELAY_H
+#define AVR_HOST_UTIL_DELAY_H
+
+#include "../avr_host.h"
+
+#define _delay_ms(ms) vAvrHostDelayUs((double)(ms) * 1000.0)
+#define _delay_us(us) vAvrHostDelayUs((double)(us))
+
+#endif // AVR_HOST_UTIL_DELAY_H
@@ -4,15 +4,16 @@
  */
 #include "../../gpioLib.h" // Explicit relative path
 #include "helper_common.h"
+#include "helpers/gpio_helper.h"
 #include "implementations/avr/gpioPlatform_avr.h"
 #include <avr/interrupt.h> // For ISR
 #include <avr/io.h>
 #include <stdbool.h>
 #include <stdint.h> // For uint8_t
 #include <stdio.h>
-#include <stdlib.h> // For atoi
-#include <string.h> // For strstr
+#include <string.h> // For memcpy, strcpy
 
+#include <util/atomic.h>
 #include <util/delay.h>
 
 // ============================================================================
@@ -36,94 +37,299 @@ static void vUartInit(void) {
 
 // ... (Rest of UART code) ...
 
+// ============================================================================
+// MILLISECOND TICK (Timer0, CTC)
+// ============================================================================
+// F_CPU / 64 / 250 = 1 kHz at 16 MHz (Timer0 is free: no Arduino core here)
+#define TICK_PRESCALE 64
+#define TICK_OCR ((F_CPU / TICK_PRESCALE / 1000) - 1)
+
+static volatile uint32_t u32TickMs = 0;
+
+/** Implemented in main (common): work due at a tick (runs in the ISR). */
+extern void vOnPlatformTick(uint32_t u32NowMs);
+
+static void vTickInit(void) {
+  TCCR0A = (1 << WGM01); // CTC: count 0..OCR0A, then compare match
+  OCR0A = (uint8_t)TICK_OCR;
+  TCCR0B = (1 << CS01) | (1 << CS00); // clk/64
+  TIMSK0 = (1 << OCIE0A);
+}
+
+ISR(TIMER0_COMPA_vect) { vOnPlatformTick(++u32TickMs); }
+
 // ============================================================================
 // DIGITAL TWIN INPUT HANDLING (RX)
 // ============================================================================
 #define RX_BUFFER_SIZE 128
-static char acRxBuffer[RX_BUFFER_SIZE];
-static uint8_t u8RxIndex = 0;
-/* Pending line: ISR only sets this; main loop dispatches (so printf runs in main). */
-static char acPendingLine[RX_BUFFER_SIZE];
-static volatile uint8_t u8LineReady = 0;
-
-// Simple Parser: {"t":"GPIO","p":"BUTTON1","v":0}
-static void vParseAndApplyInput(char *pcJson) {
-  // We expect: "p":"BUTTON1" and "v":0 or 1
-  char *pcPinLoc = strstr(pcJson, "\"p\":\"");
-  char *pcValLoc = strstr(pcJson, "\"v\":");
-
-  if (pcPinLoc && pcValLoc) {
-    // Extract Pin Name
-    pcPinLoc += 5; // Skip "p":"
-    char acPinName[32];
-    uint8_t i = 0;
-    while (*pcPinLoc != '"' && i < 31) {
-      acPinName[i++] = *pcPinLoc++;
-    }
-    acPinName[i] = '\0';
+/* Lines received but not yet dispatched: the credit window the host may fill
+ * ("flow"). Power of 2; each slot costs RX_BUFFER_SIZE bytes of RAM. */
+#ifndef RX_LINE_SLOTS
+#define RX_LINE_SLOTS 2
+#endif
+/* Digital Twin lines ('{' first) have their own slots, so a twin flood never
+ * takes an MCP slot. When they are full the oldest twin line is folded into
+ * per-pin pending levels: a newer line only overrides the pins it names, so
+ * a lone pin's level survives a flood on other pins. Power of 2. */
+#ifndef RX_DT_SLOTS
+#define RX_DT_SLOTS 2
+#endif
+/* Dispatch round: up to RX_MCP_WEIGHT commands, then RX_DT_WEIGHT twin lines.
+ * A command waits for at most RX_DT_WEIGHT twin lines, whatever the flood. */
+#define RX_MCP_WEIGHT 2
+#define RX_DT_WEIGHT 1
+/* Pin handles a folded twin line can carry (bits of the pending masks) */
+#define RX_DT_PEND_PINS 32
+/* Binary frame mode: bytes between 0x00 delimiters are COBS, not text. COBS
+ * never yields 0x00, so the frame fits the same char buffers. */
+#define RX_READY_LINE 1
+#define RX_READY_FRAME 2
 
-    // Extract Value
-    pcValLoc += 4; // Skip "v":
-    int iValue = atoi(pcValLoc);
-    // Note: atoi stops at non-digit (like })
+typedef struct {
+  char acData[RX_BUFFER_SIZE];
+  uint8_t u8Len;
+  uint8_t u8Kind; // RX_READY_LINE or RX_READY_FRAME
+} sRxSlot_t;
 
-    // Inject into GPIO Driver
-    // Use vGpioAVRSetSimulated (from gpioPlatform_avr.h)
-    // 1 = Released (High), 0 = Pressed (Low) typically for buttons
-    vGpioAVRSetSimulated(acPinName, (iValue != 0));
-  }
+/* ISR assembles into the tail slot and publishes it; the main loop copies the
+ * head slot out and frees it before the handler runs (so printf runs in
+ * main, and a response always means a free slot). */
+static sRxSlot_t asRxSlots[RX_LINE_SLOTS];
+static volatile uint8_t u8RxHead = 0; // Next to dispatch (main loop)
+static volatile uint8_t u8RxTail = 0; // Being assembled (ISR)
+/* Twin lane: the ISR also moves the head when it folds the oldest line, so
+ * the main loop takes a line (and the pending levels) with interrupts off */
+static sRxSlot_t asRxDtSlots[RX_DT_SLOTS];
+static volatile uint8_t u8RxDtHead = 0;
+static volatile uint8_t u8RxDtTail = 0;
+/* Folded twin lines, older than any line still in the lane: pins named
+ * (mask) and their newest levels. ISR or interrupts off only. */
+static uint32_t u32RxDtPendMask = 0;
+static uint32_t u32RxDtPendLevel = 0;
+static char acRxDispatch[RX_BUFFER_SIZE];
+static uint8_t u8RxIndex = 0;
+static bool bRxInFrame = false;
+static bool bRxDt = false; // Line being received goes to the twin lane
+static bool bRxDiscard = false; // No free slot or too long: drop to the end
+static volatile uint32_t u32RxOverruns = 0; // Lines dropped since boot
+static uint32_t u32RxOverrunsTaken = 0;     // Already reported by main
+/* Host asked for binary telemetry ("proto cobs") */
+static bool bUartFramed = false;
+
+/** Twin input level of a pin: into the helper's merge table (gpio_helper.h).
+ *  1 = Released (High), 0 = Pressed (Low) typically for buttons. */
+void vPlatformApplyDtPin(uint32_t u32Pin, bool bValue) {
+  (void)eGpioHelperSetSimulatedPin(u32Pin, bValue);
 }
 
 /** Implemented in main (common); dispatches to MCP or DT. */
 extern void vOnUartLineReceived(const char *pcLine);
+extern void vOnUartFrameReceived(const uint8_t *pu8Frame, uint16_t u16Len);
+extern bool bOnHelperSend(const char *pcCmd, const char *pcPin, int iValue);
 
 void vApplyReceivedJsonLine(const char *pcLine) {
-  if (pcLine != NULL)
-    vParseAndApplyInput((char *)pcLine);
+  (void)bGpioHelperParseDtLine(pcLine, vPlatformApplyDtPin);
+}
+
+/** Pin level of a folded twin line into the pending masks (ISR) */
+static void vRxDtFoldPin(uint32_t u32Pin, bool bValue) {
+  if (u32Pin >= RX_DT_PEND_PINS)
+    return;
+  uint32_t u32Bit = (uint32_t)1 << u32Pin;
+  u32RxDtPendMask |= u32Bit;
+  if (bValue)
+    u32RxDtPendLevel |= u32Bit;
+  else
+    u32RxDtPendLevel &= ~u32Bit;
 }
 
 /* RX ISR: only enqueue line; main loop calls bUartDispatchPendingLine(). */
 ISR(USART_RX_vect) {
   char c = UDR0;
+  uint8_t u8Kind = RX_READY_LINE;
 
-  if (c == '\n' || c == '\r') {
-    if (u8RxIndex > 0) {
-      acRxBuffer[u8RxIndex] = '\0';
-      strncpy(acPendingLine, acRxBuffer, RX_BUFFER_SIZE - 1);
-      acPendingLine[RX_BUFFER_SIZE - 1] = '\0';
-      u8LineReady = 1;
+  if (c == '\0') {
+    if (!bRxInFrame || (u8RxIndex == 0 && !bRxDiscard)) {
+      // Opening delimiter (a partial text line before it is dropped)
+      bRxInFrame = true;
+      bRxDiscard = false;
       u8RxIndex = 0;
+      return;
     }
+    bRxInFrame = false; // Closing delimiter of a non-empty frame
+    u8Kind = RX_READY_FRAME;
+  } else if (!bRxInFrame && (c == '\n' || c == '\r')) {
+    if (u8RxIndex == 0 && !bRxDiscard)
+      return; // Empty line, or the LF of a CRLF
   } else {
-    if (u8RxIndex < RX_BUFFER_SIZE - 1) {
-      acRxBuffer[u8RxIndex++] = c;
-    } else {
-      u8RxIndex = 0;
+    if (bRxDiscard)
+      return;
+    if (u8RxIndex == 0) {
+      // The first byte picks the lane
+      bRxDt = (c == '{' && !bRxInFrame);
+      if (bRxDt && (uint8_t)(u8RxDtTail - u8RxDtHead) >= RX_DT_SLOTS) {
+        // Twin lane full: fold its oldest line into the pending levels
+        (void)bGpioHelperParseDtLine(
+            asRxDtSlots[u8RxDtHead & (RX_DT_SLOTS - 1)].acData, vRxDtFoldPin);
+        u8RxDtHead++;
+      }
+    }
+    if (u8RxIndex >= RX_BUFFER_SIZE - 1 ||
+        (!bRxDt && (uint8_t)(u8RxTail - u8RxHead) >= RX_LINE_SLOTS)) {
+      bRxDiscard = true; // Too long, or the host sent past its window
+      return;
     }
+    if (bRxDt)
+      asRxDtSlots[u8RxDtTail & (RX_DT_SLOTS - 1)].acData[u8RxIndex++] = c;
+    else
+      asRxSlots[u8RxTail & (RX_LINE_SLOTS - 1)].acData[u8RxIndex++] = c;
+    return;
   }
+
+  // End of a line or frame
+  if (bRxDiscard) {
+    if (!bRxDt)
+      u32RxOverruns++; // A lost command: the host hears of it (flow)
+  } else if (bRxDt) {
+    asRxDtSlots[u8RxDtTail & (RX_DT_SLOTS - 1)].acData[u8RxIndex] = '\0';
+    u8RxDtTail++;
+  } else {
+    sRxSlot_t *psSlot = &asRxSlots[u8RxTail & (RX_LINE_SLOTS - 1)];
+    psSlot->acData[u8RxIndex] = '\0';
+    psSlot->u8Len = u8RxIndex;
+    psSlot->u8Kind = u8Kind;
+    u8RxTail++;
+  }
+  u8RxIndex = 0;
+  bRxDiscard = false;
 }
 
-bool bUartDispatchPendingLine(void) {
-  if (u8LineReady == 0)
+/** Next MCP command line or frame into acRxDispatch; false if none */
+static bool bRxTakeMcp(uint8_t *pu8Kind, uint8_t *pu8Len) {
+  if (u8RxHead == u8RxTail)
     return false;
-  u8LineReady = 0;
-  vOnUartLineReceived(acPendingLine);
+  const sRxSlot_t *psSlot = &asRxSlots[u8RxHead & (RX_LINE_SLOTS - 1)];
+  *pu8Kind = psSlot->u8Kind;
+  *pu8Len = psSlot->u8Len;
+  memcpy(acRxDispatch, psSlot->acData, (size_t)*pu8Len + 1);
+  u8RxHead++; // Slot free before any response: the host's credit is back
   return true;
 }
 
+/** Pending levels of folded lines, then the next twin line, into
+ *  acRxDispatch ("" if the lane is empty); false if neither */
+static bool bRxTakeDt(uint32_t *pu32Mask, uint32_t *pu32Level) {
+  bool bTaken = false;
+  acRxDispatch[0] = '\0';
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    *pu32Mask = u32RxDtPendMask;
+    *pu32Level = u32RxDtPendLevel;
+    u32RxDtPendMask = 0;
+    if (u8RxDtHead != u8RxDtTail) {
+      strcpy(acRxDispatch, asRxDtSlots[u8RxDtHead & (RX_DT_SLOTS - 1)].acData);
+      u8RxDtHead++;
+      bTaken = true;
+    }
+  }
+  return bTaken || *pu32Mask != 0;
+}
+
+bool bUartDispatchPendingLine(void) {
+  bool bAny = false;
+  // A twin lane's worth per call: a flood cannot keep the loop here
+  uint8_t u8DtBudget = RX_DT_SLOTS;
+  bool bMore = true;
+  while (bMore) {
+    bMore = false;
+    uint8_t u8Kind = 0;
+    uint8_t u8Len = 0;
+    for (uint8_t i = 0; i < RX_MCP_WEIGHT && bRxTakeMcp(&u8Kind, &u8Len); i++) {
+      if (u8Kind == RX_READY_FRAME)
+        vOnUartFrameReceived((const uint8_t *)acRxDispatch, u8Len);
+      else
+        vOnUartLineReceived(acRxDispatch);
+      bAny = bMore = true;
+    }
+    for (uint8_t i = 0; i < RX_DT_WEIGHT && u8DtBudget > 0; i++) {
+      uint32_t u32Mask = 0;
+      uint32_t u32Level = 0;
+      if (!bRxTakeDt(&u32Mask, &u32Level))
+        break;
+      u8DtBudget--;
+      // Folded lines are older than the one taken with them
+      for (uint32_t u32Pin = 0; u32Mask != 0; u32Pin++, u32Mask >>= 1) {
+        if (u32Mask & 1)
+          vPlatformApplyDtPin(u32Pin, (u32Level >> u32Pin) & 1);
+      }
+      if (acRxDispatch[0] != '\0')
+        vApplyReceivedJsonLine(acRxDispatch);
+      bAny = bMore = true;
+    }
+  }
+  return bAny;
+}
+
+void vUartGetRxFlow(uint8_t *pu8Slots, uint8_t *pu8Free,
+                    uint32_t *pu32Overruns) {
+  *pu8Slots = RX_LINE_SLOTS;
+  *pu8Free = (uint8_t)(RX_LINE_SLOTS - (uint8_t)(u8RxTail - u8RxHead));
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { *pu32Overruns = u32RxOverruns; }
+}
+
+uint32_t u32UartTakeRxOverruns(void) {
+  uint32_t u32Total = 0;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { u32Total = u32RxOverruns; }
+  uint32_t u32New = u32Total - u32RxOverrunsTaken;
+  u32RxOverrunsTaken = u32Total;
+  return u32New;
+}
+
+void vUartSetFramed(bool bFramed) { bUartFramed = bFramed; }
+
+bool bUartIsFramed(void) { return bUartFramed; }
+
+/* Binary frames: straight to UDR0, bypassing uart_putchar's LF -> CRLF */
+void vUartWriteRaw(const uint8_t *pu8Data, uint16_t u16Len) {
+  for (uint16_t i = 0; i < u16Len; i++) {
+    loop_until_bit_is_set(UCSR0A, UDRE0);
+    UDR0 = pu8Data[i];
+  }
+}
+
 void vHelperSend(const char *pcCmd, const char *pcPin, int iValue) {
+  if (bOnHelperSend(pcCmd, pcPin, iValue))
+    return; // Sent as a DT_GPIO frame
   // {"t":"<Cmd>","p":"<Pin>","v":<Val>}
   // Manual JSON construction to avoid sprintf bloat (optional, but good for
   // AVR) Using printf since we already redirected it
   printf("{\"t\":\"%s\",\"p\":\"%s\",\"v\":%d}\n", pcCmd, pcPin, iValue);
 }
 
+void vHelperSendMany(const char *pcCmd, const char *const *ppcPins,
+                     const int *piValues, uint32_t u32Count) {
+  if (u32Count == 0)
+    return;
+  if (bOnHelperSend(pcCmd, ppcPins[0], piValues[0])) {
+    // Binary link: one DT_GPIO frame per pin
+    for (uint32_t i = 1; i < u32Count; i++)
+      bOnHelperSend(pcCmd, ppcPins[i], piValues[i]);
+    return;
+  }
+  // {"t":"<Cmd>","s":{"<Pin>":<Val>,...}}
+  printf("{\"t\":\"%s\",\"s\":{", pcCmd);
+  for (uint32_t i = 0; i < u32Count; i++)
+    printf("%s\"%s\":%d", (i > 0) ? "," : "", ppcPins[i], piValues[i]);
+  printf("}}\n");
+}
+
 // End of peripheral adapter
 
 // Redefine UART characters
 static int uart_putchar(char c, FILE *stream);
+#ifndef AVR_HOST_EMULATION
 static FILE uart_stdout =
     FDEV_SETUP_STREAM(uart_putchar, NULL, _FDEV_SETUP_WRITE);
+#endif
 
 static int uart_putchar(char c, FILE *stream) {
   (void)stream; // Suppress unused parameter warning
@@ -144,16 +350,34 @@ const sGpioInterface_t *psGetPlatformGpioInterface(void) {
   static bool bInitialized = false;
   if (!bInitialized) {
     vUartInit();
+    vTickInit(); // Counts once sei() runs (see app_main.c)
+#ifdef AVR_HOST_EMULATION
+    stdout = psAvrHostOpenStream(uart_putchar); // See host/avr_host.h
+#else
     stdout = &uart_stdout; // Bind printf
+#endif
     bInitialized = true;
   }
   return &sGpioInterfaceAVR;
 }
 
+uint32_t u32PlatformGetTickMs(void) {
+  // The AVR loads the counter a byte at a time and the ISR may run in
+  // between: read until two loads agree rather than blocking interrupts
+  uint32_t u32First = 0;
+  uint32_t u32Second = 0;
+  do {
+    u32First = u32TickMs;
+    u32Second = u32TickMs;
+  } while (u32First != u32Second);
+  return u32First;
+}
+
 void vPlatformDelayMs(uint32_t u32Ms) {
   // util/delay.h expects compile-time constant usually, but _delay_ms handles
-  // variables (loops) However, for large values it's better to loop
-  while (u32Ms--) {
+  // variables (loops) However, for large values it's better to loop. A
+  // received line ends the delay early (the host may be waiting on it).
+  while (u32Ms-- && u8RxHead == u8RxTail && u8RxDtHead == u8RxDtTail) {
     _delay_ms(1);
   }
 }
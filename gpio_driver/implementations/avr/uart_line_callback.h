@@ -1,13 +1,18 @@
 //==============================================================================
 // UART Line Received (AVR) - Platform calls main; main dispatches
 //------------------------------------------------------------------------------
-// ISR calls vOnUartLineReceived(line); main implements it (MCP vs Digital Twin).
+// ISR queues MCP lines and Digital Twin lines ('{') in separate lanes; the
+// main loop hands commands to vOnUartLineReceived(line), implemented in main.
+// Bytes between 0x00 delimiters are a binary frame -> vOnUartFrameReceived.
 // vApplyReceivedJsonLine is implemented here (platform) for DT path.
 //------------------------------------------------------------------------------
 
 #ifndef UART_LINE_CALLBACK_H
 #define UART_LINE_CALLBACK_H
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -16,12 +21,48 @@ extern "C" {
  *  to MCP (tool_registry) or Digital Twin (vApplyReceivedJsonLine). */
 void vOnUartLineReceived(const char *pcLine);
 
+/** Entry point for each complete binary frame: the COBS bytes between the
+ *  0x00 delimiters (see mcu/common/mcp_frame.h). Implemented in main. */
+void vOnUartFrameReceived(const uint8_t *pu8Frame, uint16_t u16Len);
+
+/** Called first by the platform's vHelperSend. Implemented in main; returns
+ *  true if it already sent the update as a binary frame. */
+bool bOnHelperSend(const char *pcCmd, const char *pcPin, int iValue);
+
+/** Write bytes as-is (no newline translation). Implemented in platform. */
+void vUartWriteRaw(const uint8_t *pu8Data, uint16_t u16Len);
+
+/** Telemetry format negotiated by the host ("proto cobs|text"). Implemented in
+ *  platform. */
+void vUartSetFramed(bool bFramed);
+bool bUartIsFramed(void);
+
 /** Apply a received JSON line (Digital Twin path). Implemented in platform. */
 void vApplyReceivedJsonLine(const char *pcLine);
 
-/** Call from main loop to process one pending RX line (run handler in main context). */
+/** Digital Twin input level of one pin, by valid pin handle (index in
+ *  g_psGpioPinConfigs). vApplyReceivedJsonLine parses into it; main calls it
+ *  for binary DT frames. Implemented in platform. */
+void vPlatformApplyDtPin(uint32_t u32Pin, bool bValue);
+
+/** Call from main loop to process the pending RX lines (run handlers in main
+ *  context): MCP commands first, Digital Twin lines in between (weighted), so
+ *  a twin flood delays a command by a bounded number of lines. */
 bool bUartDispatchPendingLine(void);
 
+/** Receive flow control ("flow" command): lines the platform holds before
+ *  dispatch (the host's credit window), how many are free now, and lines
+ *  dropped since boot because they were past the window or too long.
+ *  UART_RX_SLOTS_UNBOUNDED: the link pushes back instead of dropping.
+ *  Implemented in platform. */
+#define UART_RX_SLOTS_UNBOUNDED 255
+void vUartGetRxFlow(uint8_t *pu8Slots, uint8_t *pu8Free,
+                    uint32_t *pu32Overruns);
+
+/** Lines dropped since the previous call (main reports them). Implemented in
+ *  platform. */
+uint32_t u32UartTakeRxOverruns(void);
+
 #ifdef __cplusplus
 }
 #endif
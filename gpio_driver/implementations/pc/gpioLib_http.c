@@ -21,31 +21,95 @@
 #include <winhttp.h>
 #include <winnls.h>
 #else
+#include <time.h>
 #include <unistd.h>
 #endif
 
 // Constants ===================================================================
 #define HTTP_BASE_URL "http://localhost:8080"
+#define HTTP_API_PATH "/api/gpio/"
 #define MAX_URL_LEN 256
 #define MAX_RESPONSE_SIZE 1024
+#define MAX_PINS 32
+#define MAX_PIN_NAME_LEN 32
+
+// Circuit breaker: while the simulator is unreachable calls fail fast with
+// RET_TYPE_NOT_AVAILABLE; a single health probe is allowed once the backoff
+// expires, doubling up to the maximum on each failed probe.
+#define HTTP_BACKOFF_MIN_MS 100
+#define HTTP_BACKOFF_MAX_MS 5000
+
+// Type Definitions ============================================================
+// Per-pin state: request targets are built once when the pin is configured so
+// the hot read/write path does no formatting (and no wide-string conversion on
+// Win32); the last configuration and output value are replayed on recovery.
+typedef struct {
+  char acPinName[MAX_PIN_NAME_LEN];
+  eGpioDirection_t eDirection;
+  eGpioPull_t ePull;
+  bool bConfigured; // Configure requested (re-sent after reconnect)
+  bool bHasValue;   // bValue holds the last written output
+  bool bValue;
+#ifdef _WIN32
+  wchar_t awValuePath[MAX_URL_LEN];     // /api/gpio/<pin>
+  wchar_t awConfigurePath[MAX_URL_LEN]; // /api/gpio/<pin>/configure
+#else
+  char acValueURL[MAX_URL_LEN];     // http://host/api/gpio/<pin>
+  char acConfigureURL[MAX_URL_LEN]; // http://host/api/gpio/<pin>/configure
+#endif
+} sHTTPPin_t;
+
+// HTTP request target: narrow URL for curl, wide path for WinHTTP
+#ifdef _WIN32
+typedef const wchar_t *pcHTTPTarget_t;
+#else
+typedef const char *pcHTTPTarget_t;
+#endif
+
+/**
+ * @brief Simulator connection health
+ */
+typedef enum {
+  HTTP_LINK_UNKNOWN = 0, // Not probed yet (first use triggers the probe)
+  HTTP_LINK_UP,          // Requests go through
+  HTTP_LINK_DOWN         // Fail fast until the backoff deadline, then probe
+} eHTTPLinkState_t;
 
 // Static Variables ============================================================
 static bool g_bHTTPInitialized = false;
-static bool g_bHTTPInitMessagePrinted = false;
+static sHTTPPin_t g_asHTTPPins[MAX_PINS];
+static uint8_t g_u8HTTPPinCount = 0;
+static eHTTPLinkState_t g_eHTTPLinkState = HTTP_LINK_UNKNOWN;
+static uint32_t g_u32HTTPBackoffMs = HTTP_BACKOFF_MIN_MS;
+static uint32_t g_u32HTTPRetryAtMs = 0;
 #ifdef _WIN32
 static HINTERNET g_hHTTPSession = NULL; // Reused HTTP session
 static HINTERNET g_hHTTPConnect = NULL; // Reused connection to localhost:8080
 #endif
 
 // Private Function Prototypes ================================================
-static eRetType_t eHTTP_MakeRequest(const char *pcURL, const char *pcMethod,
-                                    const char *pcBody, char **ppcResponse);
-static eRetType_t eHTTP_GetRequest(const char *pcURL, char **ppcResponse);
-static eRetType_t eHTTP_PostRequest(const char *pcURL, const char *pcBody,
-                                    char **ppcResponse);
-
-// Forward Declarations =======================================================
-eRetType_t eGpioHTTPConfigure(const sGpioConfig_t *psConfig);
+static eRetType_t eHTTP_MakeRequest(pcHTTPTarget_t pcTarget, bool bPost,
+                                    const char *pcBody, char *pcResponse,
+                                    size_t u32ResponseSize);
+static eRetType_t eHTTP_GetRequest(pcHTTPTarget_t pcTarget, char *pcResponse,
+                                   size_t u32ResponseSize);
+static eRetType_t eHTTP_PostRequest(pcHTTPTarget_t pcTarget,
+                                    const char *pcBody, char *pcResponse,
+                                    size_t u32ResponseSize);
+static eRetType_t eHTTP_PostWithRetry(pcHTTPTarget_t pcTarget,
+                                      const char *pcBody);
+static sHTTPPin_t *psHTTP_FindPin(const char *pcPinName);
+static sHTTPPin_t *psHTTP_AddPin(const char *pcPinName);
+static bool bHTTP_FillPinPaths(sHTTPPin_t *psPin, const char *pcPinName);
+static bool bHTTP_BuildTarget(const char *pcPinName, bool bConfigure,
+                              sHTTPPin_t *psScratch,
+                              pcHTTPTarget_t *ppcTarget);
+static bool bHTTP_LinkReady(void);
+static void vHTTP_LinkFailed(void);
+static bool bHTTP_ResyncPins(void);
+static uint32_t u32HTTP_NowMs(void);
+static bool bHTTP_JsonGetInt(const char *pcJson, const char *pcKey,
+                             int *piValue);
 
 // Configuration array is defined in ../config/gpio_config.h
 // All implementations (HTTP, Windows, STM32) use the SAME config array
@@ -54,8 +118,9 @@ eRetType_t eGpioHTTPConfigure(const sGpioConfig_t *psConfig);
 
 /**
  * @brief Initialize the HTTP GPIO interface
- * Tests connection to the server and configures default pins for this
- * implementation
+ *
+ * Queues the configured pins without touching the network. The simulator is
+ * probed on first use; reachable -> all queued pins are configured then.
  */
 void vGpioHTTPInit(void) {
   // Only initialize once
@@ -63,33 +128,6 @@ void vGpioHTTPInit(void) {
     return;
   }
 
-  // Only print initialization messages once
-  if (!g_bHTTPInitMessagePrinted) {
-    g_bHTTPInitMessagePrinted = true;
-
-    // Test connection to server
-    char *pcTestResponse = NULL;
-    printf("[GPIO HTTP] Initializing HTTP GPIO implementation...\n");
-    printf("[GPIO HTTP] Connecting to: %s/api/gpio/health\n", HTTP_BASE_URL);
-
-    char acHealthURL[MAX_URL_LEN];
-    snprintf(acHealthURL, sizeof(acHealthURL), "%s/api/gpio/health",
-             HTTP_BASE_URL);
-
-    if (eHTTP_GetRequest(acHealthURL, &pcTestResponse) == RET_TYPE_SUCCESS &&
-        pcTestResponse != NULL) {
-      printf("[GPIO HTTP] [OK] Server connection successful!\n");
-      printf("[GPIO HTTP] Response: %s\n", pcTestResponse);
-      free(pcTestResponse);
-    } else {
-      printf("[GPIO HTTP] [WARNING] Could not connect to server!\n");
-      printf("[GPIO HTTP] Make sure Python simulator is running: python "
-             "gpio_simulator.py\n");
-      printf("[GPIO HTTP] Will retry pin configuration when server becomes "
-             "available.\n");
-    }
-  }
-
 #ifdef _WIN32
   // Create and cache HTTP session and connection for reuse (much faster!)
   if (g_hHTTPSession == NULL) {
@@ -110,53 +148,42 @@ void vGpioHTTPInit(void) {
   }
 #endif
 
+  printf("[GPIO HTTP] Initializing HTTP GPIO implementation...\n");
+  printf("[GPIO HTTP] Simulator: %s%shealth (checked on first use)\n",
+         HTTP_BASE_URL, HTTP_API_PATH);
+
   g_bHTTPInitialized = true;
+  g_eHTTPLinkState = HTTP_LINK_UNKNOWN;
 
-  // Configure pins from config file - makes implementation self-contained
+  // Queue pins from config file - makes implementation self-contained
   // All pin configurations are read from ../config/gpio_config.h
-  printf("[GPIO HTTP] Configuring pins from config...\n");
-
-  // Iterate through configured pins and configure them
   const sGpioPinConfig_t *psPinConfig = g_psGpioPinConfigs;
-  uint8_t u8ConfiguredCount = 0;
+  uint8_t u8QueuedCount = 0;
 
   while (psPinConfig->pcPinName != NULL) {
-    sGpioConfig_t sConfig = {.pcPinName = psPinConfig->pcPinName,
-                             .eDirection = psPinConfig->eDirection,
-                             .ePull = psPinConfig->ePull};
-
-    eRetType_t eRet = eGpioHTTPConfigure(&sConfig);
-    if (eRet == RET_TYPE_SUCCESS) {
-      printf("[GPIO HTTP] [OK] %s configured (%s, %s)\n",
-             psPinConfig->pcPinName,
-             (psPinConfig->eDirection == GPIO_DIR_OUTPUT) ? "OUTPUT" : "INPUT",
-             (psPinConfig->ePull == GPIO_PULL_UP)     ? "PULL_UP"
-             : (psPinConfig->ePull == GPIO_PULL_DOWN) ? "PULL_DOWN"
-                                                      : "NONE");
-      u8ConfiguredCount++;
+    sHTTPPin_t *psPin = psHTTP_AddPin(psPinConfig->pcPinName);
+    if (psPin != NULL) {
+      psPin->eDirection = psPinConfig->eDirection;
+      psPin->ePull = psPinConfig->ePull;
+      psPin->bConfigured = true;
+      u8QueuedCount++;
     } else {
-      printf("[GPIO HTTP] [WARNING] Failed to configure %s (server may not be "
-             "ready yet)\n",
+      printf("[GPIO HTTP] [WARNING] Cannot track %s (pin table full or name "
+             "too long)\n",
              psPinConfig->pcPinName);
     }
-
-    // Small delay between configure operations to avoid overwhelming server
-#ifdef _WIN32
-    Sleep(10); // 10ms delay
-#else
-    usleep(10000); // 10ms delay
-#endif
-
     psPinConfig++;
   }
 
-  printf(
-      "[GPIO HTTP] Initialization complete. Configured %u pins from config.\n",
-      u8ConfiguredCount);
+  printf("[GPIO HTTP] Initialization complete. %u pins from config queued.\n",
+         u8QueuedCount);
 }
 
 /**
  * @brief Configure a GPIO pin via HTTP
+ *
+ * Also caches the pin's request paths so later reads/writes skip formatting,
+ * and remembers the configuration so it is re-sent after a reconnect.
  */
 eRetType_t eGpioHTTPConfigure(const sGpioConfig_t *psConfig) {
   if (psConfig == NULL || psConfig->pcPinName == NULL) {
@@ -167,54 +194,36 @@ eRetType_t eGpioHTTPConfigure(const sGpioConfig_t *psConfig) {
     return RET_TYPE_NOT_INITIALIZED;
   }
 
-  char acURL[MAX_URL_LEN];
-  snprintf(acURL, sizeof(acURL), "%s/api/gpio/%s/configure", HTTP_BASE_URL,
-           psConfig->pcPinName);
-
-  char acBody[256];
-  snprintf(acBody, sizeof(acBody), "{\"direction\":%d,\"pull\":%d}",
-           (int)psConfig->eDirection, (int)psConfig->ePull);
+  sHTTPPin_t sScratch;
+  pcHTTPTarget_t pcTarget = NULL;
+  if (!bHTTP_BuildTarget(psConfig->pcPinName, true, &sScratch, &pcTarget)) {
+    return RET_TYPE_INVALID_PARAMETER;
+  }
 
-  // Retry logic for configure - sometimes first request after startup times out
-  char *pcResponse = NULL;
-  eRetType_t eRet = RET_TYPE_FAIL;
-  int iRetries = 2; // 2 attempts - localhost should respond fast
+  sHTTPPin_t *psPin = psHTTP_FindPin(psConfig->pcPinName);
+  if (psPin != NULL) {
+    psPin->eDirection = psConfig->eDirection;
+    psPin->ePull = psConfig->ePull;
+    psPin->bConfigured = true;
+  }
 
-  for (int i = 0; i < iRetries; i++) {
-    eRet = eHTTP_PostRequest(acURL, acBody, &pcResponse);
+  if (!bHTTP_LinkReady()) {
+    return RET_TYPE_NOT_AVAILABLE; // Queued; sent when the simulator returns
+  }
 
-    if (eRet == RET_TYPE_SUCCESS) {
-      break; // Success - exit retry loop
-    }
+  char acBody[64];
+  snprintf(acBody, sizeof(acBody), "{\"direction\":%d,\"pull\":%d}",
+           (int)psConfig->eDirection, (int)psConfig->ePull);
 
-    // Wait a bit before retry (only if not last attempt)
-    if (i < iRetries - 1) {
-#ifdef _WIN32
-      Sleep(10); // 10ms delay before retry - localhost is fast!
-#else
-      usleep(10000); // 10ms delay
-#endif
-      if (pcResponse != NULL) {
-        free(pcResponse);
-        pcResponse = NULL;
-      }
-    }
-  }
+  eRetType_t eRet = eHTTP_PostWithRetry(pcTarget, acBody);
 
   if (eRet == RET_TYPE_SUCCESS) {
     // Success - empty response is OK for configure operations
     printf("[GPIO HTTP] Pin '%s' configured as %s\n", psConfig->pcPinName,
            psConfig->eDirection == GPIO_DIR_INPUT ? "INPUT" : "OUTPUT");
-    if (pcResponse != NULL) {
-      free(pcResponse);
-    }
   } else {
-    printf("[GPIO HTTP] [ERROR] Failed to configure pin '%s' after %d "
-           "attempts: %d\n",
-           psConfig->pcPinName, iRetries, eRet);
-    if (pcResponse != NULL) {
-      free(pcResponse);
-    }
+    printf("[GPIO HTTP] [ERROR] Failed to configure pin '%s': %d\n",
+           psConfig->pcPinName, eRet);
   }
 
   return eRet;
@@ -232,26 +241,34 @@ eRetType_t eGpioHTTPRead(const char *pcPinName, bool *pbValue) {
     return RET_TYPE_NOT_INITIALIZED;
   }
 
-  char acURL[MAX_URL_LEN];
-  snprintf(acURL, sizeof(acURL), "%s/api/gpio/%s", HTTP_BASE_URL, pcPinName);
+  sHTTPPin_t sScratch;
+  pcHTTPTarget_t pcTarget = NULL;
+  if (!bHTTP_BuildTarget(pcPinName, false, &sScratch, &pcTarget)) {
+    return RET_TYPE_INVALID_PARAMETER;
+  }
 
-  char *pcResponse = NULL;
-  eRetType_t eRet = eHTTP_GetRequest(acURL, &pcResponse);
+  // Fallback: assume LOW if the simulator is unavailable or the read fails
+  *pbValue = false;
 
-  if (eRet == RET_TYPE_SUCCESS && pcResponse != NULL) {
-    // Parse JSON: {"value": 1} or {"value": 0}
-    int iValue = 0;
-    if (sscanf(pcResponse, "{\"value\":%d}", &iValue) == 1 ||
-        sscanf(pcResponse, "{\"value\": %d}", &iValue) == 1) {
-      *pbValue = (iValue != 0);
-      free(pcResponse);
-      return RET_TYPE_SUCCESS;
-    }
-    free(pcResponse);
+  if (!bHTTP_LinkReady()) {
+    return RET_TYPE_NOT_AVAILABLE;
+  }
+
+  char acResponse[MAX_RESPONSE_SIZE];
+  eRetType_t eRet =
+      eHTTP_GetRequest(pcTarget, acResponse, sizeof(acResponse));
+  if (eRet != RET_TYPE_SUCCESS) {
+    vHTTP_LinkFailed();
+    return eRet;
+  }
+
+  // Parse JSON: {"value": 1}, {"pin":"LED1","value":true}, ...
+  int iValue = 0;
+  if (bHTTP_JsonGetInt(acResponse, "value", &iValue)) {
+    *pbValue = (iValue != 0);
+    return RET_TYPE_SUCCESS;
   }
 
-  // Fallback: assume LOW if HTTP fails
-  *pbValue = false;
   return RET_TYPE_FAIL;
 }
 
@@ -267,23 +284,245 @@ eRetType_t eGpioHTTPWrite(const char *pcPinName, bool bValue) {
     return RET_TYPE_NOT_INITIALIZED;
   }
 
-  char acURL[MAX_URL_LEN];
-  snprintf(acURL, sizeof(acURL), "%s/api/gpio/%s", HTTP_BASE_URL, pcPinName);
+  sHTTPPin_t sScratch;
+  pcHTTPTarget_t pcTarget = NULL;
+  if (!bHTTP_BuildTarget(pcPinName, false, &sScratch, &pcTarget)) {
+    return RET_TYPE_INVALID_PARAMETER;
+  }
+
+  // Remember the latest value so a reconnect restores it
+  sHTTPPin_t *psPin = psHTTP_FindPin(pcPinName);
+  if (psPin != NULL) {
+    psPin->bHasValue = true;
+    psPin->bValue = bValue;
+  }
+
+  if (!bHTTP_LinkReady()) {
+    return RET_TYPE_NOT_AVAILABLE;
+  }
+
+  return eHTTP_PostWithRetry(pcTarget, bValue ? "{\"value\":1}"
+                                              : "{\"value\":0}");
+}
+
+// Private Functions ===========================================================
+
+/**
+ * @brief Find the cached state for a pin
+ */
+static sHTTPPin_t *psHTTP_FindPin(const char *pcPinName) {
+  for (uint8_t i = 0; i < g_u8HTTPPinCount; i++) {
+    if (strcmp(g_asHTTPPins[i].acPinName, pcPinName) == 0) {
+      return &g_asHTTPPins[i];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Fill name and request paths for a pin (cache slot or caller scratch)
+ */
+static bool bHTTP_FillPinPaths(sHTTPPin_t *psPin, const char *pcPinName) {
+  size_t u32NameLen = strlen(pcPinName);
+  if (u32NameLen == 0 || u32NameLen >= MAX_PIN_NAME_LEN) {
+    return false;
+  }
+  memcpy(psPin->acPinName, pcPinName, u32NameLen + 1);
+
+#ifdef _WIN32
+  char acPath[MAX_URL_LEN];
+  snprintf(acPath, sizeof(acPath), "%s%s", HTTP_API_PATH, pcPinName);
+  MultiByteToWideChar(CP_UTF8, 0, acPath, -1, psPin->awValuePath,
+                      MAX_URL_LEN);
+  snprintf(acPath, sizeof(acPath), "%s%s/configure", HTTP_API_PATH,
+           pcPinName);
+  MultiByteToWideChar(CP_UTF8, 0, acPath, -1, psPin->awConfigurePath,
+                      MAX_URL_LEN);
+#else
+  snprintf(psPin->acValueURL, sizeof(psPin->acValueURL), "%s%s%s",
+           HTTP_BASE_URL, HTTP_API_PATH, pcPinName);
+  snprintf(psPin->acConfigureURL, sizeof(psPin->acConfigureURL),
+           "%s%s%s/configure", HTTP_BASE_URL, HTTP_API_PATH, pcPinName);
+#endif
+  return true;
+}
+
+/**
+ * @brief Add a pin to the cache (returns the existing entry if present)
+ */
+static sHTTPPin_t *psHTTP_AddPin(const char *pcPinName) {
+  sHTTPPin_t *psPin = psHTTP_FindPin(pcPinName);
+  if (psPin != NULL) {
+    return psPin;
+  }
+
+  if (g_u8HTTPPinCount >= MAX_PINS) {
+    return NULL;
+  }
+
+  psPin = &g_asHTTPPins[g_u8HTTPPinCount];
+  memset(psPin, 0, sizeof(*psPin));
+  if (!bHTTP_FillPinPaths(psPin, pcPinName)) {
+    return NULL;
+  }
+  g_u8HTTPPinCount++;
+  return psPin;
+}
+
+/**
+ * @brief Resolve the request target for a pin operation
+ *
+ * Configure caches the pin's paths. Reads/writes use the cache and only fall
+ * back to formatting into the caller's stack scratch for unconfigured pins.
+ */
+static bool bHTTP_BuildTarget(const char *pcPinName, bool bConfigure,
+                              sHTTPPin_t *psScratch,
+                              pcHTTPTarget_t *ppcTarget) {
+  const sHTTPPin_t *psPin =
+      bConfigure ? psHTTP_AddPin(pcPinName) : psHTTP_FindPin(pcPinName);
+  if (psPin == NULL) {
+    if (!bHTTP_FillPinPaths(psScratch, pcPinName)) {
+      return false;
+    }
+    psPin = psScratch;
+  }
+
+#ifdef _WIN32
+  *ppcTarget = bConfigure ? psPin->awConfigurePath : psPin->awValuePath;
+#else
+  *ppcTarget = bConfigure ? psPin->acConfigureURL : psPin->acValueURL;
+#endif
+  return true;
+}
+
+// Connection Health ===========================================================
+
+static uint32_t u32HTTP_NowMs(void) {
+#ifdef _WIN32
+  return (uint32_t)GetTickCount();
+#else
+  struct timespec sNow;
+  clock_gettime(CLOCK_MONOTONIC, &sNow);
+  return (uint32_t)((uint64_t)sNow.tv_sec * 1000u +
+                    (uint64_t)sNow.tv_nsec / 1000000u);
+#endif
+}
+
+/**
+ * @brief Open the circuit after a failed request or probe
+ */
+static void vHTTP_LinkFailed(void) {
+  if (g_eHTTPLinkState != HTTP_LINK_DOWN) {
+    printf("[GPIO HTTP] [WARNING] Simulator unreachable at %s; failing fast "
+           "until it returns.\n",
+           HTTP_BASE_URL);
+    g_u32HTTPBackoffMs = HTTP_BACKOFF_MIN_MS;
+  }
+
+  g_eHTTPLinkState = HTTP_LINK_DOWN;
+  g_u32HTTPRetryAtMs = u32HTTP_NowMs() + g_u32HTTPBackoffMs;
+
+  g_u32HTTPBackoffMs *= 2;
+  if (g_u32HTTPBackoffMs > HTTP_BACKOFF_MAX_MS) {
+    g_u32HTTPBackoffMs = HTTP_BACKOFF_MAX_MS;
+  }
+}
+
+/**
+ * @brief Re-send configuration and last output value of every known pin
+ * @return false if the simulator dropped again (circuit re-opened)
+ */
+static bool bHTTP_ResyncPins(void) {
+  char acResponse[MAX_RESPONSE_SIZE];
+  char acBody[64];
+  uint8_t u8Synced = 0;
+
+  for (uint8_t i = 0; i < g_u8HTTPPinCount; i++) {
+    sHTTPPin_t *psPin = &g_asHTTPPins[i];
+    if (!psPin->bConfigured) {
+      continue;
+    }
+
+#ifdef _WIN32
+    pcHTTPTarget_t pcConfigure = psPin->awConfigurePath;
+    pcHTTPTarget_t pcValue = psPin->awValuePath;
+#else
+    pcHTTPTarget_t pcConfigure = psPin->acConfigureURL;
+    pcHTTPTarget_t pcValue = psPin->acValueURL;
+#endif
+
+    snprintf(acBody, sizeof(acBody), "{\"direction\":%d,\"pull\":%d}",
+             (int)psPin->eDirection, (int)psPin->ePull);
+    if (eHTTP_PostRequest(pcConfigure, acBody, acResponse,
+                          sizeof(acResponse)) != RET_TYPE_SUCCESS) {
+      vHTTP_LinkFailed();
+      return false;
+    }
+
+    if (psPin->bHasValue && psPin->eDirection == GPIO_DIR_OUTPUT &&
+        eHTTP_PostRequest(pcValue,
+                          psPin->bValue ? "{\"value\":1}" : "{\"value\":0}",
+                          acResponse,
+                          sizeof(acResponse)) != RET_TYPE_SUCCESS) {
+      vHTTP_LinkFailed();
+      return false;
+    }
+    u8Synced++;
+  }
+
+  printf("[GPIO HTTP] [OK] Simulator reachable, %u pins synced.\n", u8Synced);
+  return true;
+}
+
+/**
+ * @brief Circuit breaker gate in front of every request
+ *
+ * Up: pass. Down and backoff pending: fail fast. Otherwise (first use or
+ * backoff expired) send one health probe; on success re-sync all pins.
+ */
+static bool bHTTP_LinkReady(void) {
+  if (g_eHTTPLinkState == HTTP_LINK_UP) {
+    return true;
+  }
+
+  if (g_eHTTPLinkState == HTTP_LINK_DOWN &&
+      (int32_t)(u32HTTP_NowMs() - g_u32HTTPRetryAtMs) < 0) {
+    return false;
+  }
+
+#ifdef _WIN32
+  pcHTTPTarget_t pcHealth = L"/api/gpio/health";
+#else
+  pcHTTPTarget_t pcHealth = HTTP_BASE_URL HTTP_API_PATH "health";
+#endif
+  char acResponse[MAX_RESPONSE_SIZE];
+
+  if (eHTTP_GetRequest(pcHealth, acResponse, sizeof(acResponse)) !=
+      RET_TYPE_SUCCESS) {
+    vHTTP_LinkFailed();
+    return false;
+  }
 
-  char acBody[128];
-  snprintf(acBody, sizeof(acBody), "{\"value\":%d}", bValue ? 1 : 0);
+  g_eHTTPLinkState = HTTP_LINK_UP;
+  g_u32HTTPBackoffMs = HTTP_BACKOFF_MIN_MS;
+  return bHTTP_ResyncPins();
+}
 
-  // Retry logic for write operations (handles transient timeouts)
-  char *pcResponse = NULL;
+/**
+ * @brief POST with one quick retry; a final failure opens the circuit
+ */
+static eRetType_t eHTTP_PostWithRetry(pcHTTPTarget_t pcTarget,
+                                      const char *pcBody) {
+  char acResponse[MAX_RESPONSE_SIZE];
   eRetType_t eRet = RET_TYPE_FAIL;
   int iRetries = 2; // 2 attempts total (1 initial + 1 retry) - localhost should
                     // respond fast
 
   for (int i = 0; i < iRetries; i++) {
-    eRet = eHTTP_PostRequest(acURL, acBody, &pcResponse);
+    eRet = eHTTP_PostRequest(pcTarget, pcBody, acResponse, sizeof(acResponse));
 
     if (eRet == RET_TYPE_SUCCESS) {
-      break; // Success - exit retry loop
+      return eRet;
     }
 
     // Wait a bit before retry (only if not last attempt)
@@ -293,47 +532,185 @@ eRetType_t eGpioHTTPWrite(const char *pcPinName, bool bValue) {
 #else
       usleep(10000); // 10ms delay
 #endif
-      if (pcResponse != NULL) {
-        free(pcResponse);
-        pcResponse = NULL;
+    }
+  }
+
+  vHTTP_LinkFailed();
+  return eRet;
+}
+
+// JSON Scanner ================================================================
+
+static const char *pcJsonSkipWs(const char *pc) {
+  while (*pc == ' ' || *pc == '\t' || *pc == '\r' || *pc == '\n') {
+    pc++;
+  }
+  return pc;
+}
+
+/**
+ * @brief Skip a JSON string starting at the opening quote
+ * @return Pointer past the closing quote, or NULL if unterminated
+ */
+static const char *pcJsonSkipString(const char *pc) {
+  pc++; // opening quote
+  while (*pc != '\0' && *pc != '"') {
+    if (*pc == '\\' && pc[1] != '\0') {
+      pc++;
+    }
+    pc++;
+  }
+  return (*pc == '"') ? pc + 1 : NULL;
+}
+
+/**
+ * @brief Skip any JSON value (string, number, literal, object or array)
+ * @return Pointer past the value, or NULL on malformed input
+ */
+static const char *pcJsonSkipValue(const char *pc) {
+  if (*pc == '"') {
+    return pcJsonSkipString(pc);
+  }
+
+  if (*pc == '{' || *pc == '[') {
+    int iDepth = 0;
+    while (*pc != '\0') {
+      if (*pc == '"') {
+        pc = pcJsonSkipString(pc);
+        if (pc == NULL) {
+          return NULL;
+        }
+        continue;
+      }
+      if (*pc == '{' || *pc == '[') {
+        iDepth++;
+      } else if (*pc == '}' || *pc == ']') {
+        if (--iDepth == 0) {
+          return pc + 1;
+        }
       }
+      pc++;
     }
+    return NULL;
   }
 
-  if (pcResponse != NULL) {
-    free(pcResponse);
+  // Number or literal: runs until a delimiter
+  while (*pc != '\0' && *pc != ',' && *pc != '}' && *pc != ']' &&
+         *pc != ' ' && *pc != '\t' && *pc != '\r' && *pc != '\n') {
+    pc++;
   }
+  return pc;
+}
 
-  return eRet;
+/**
+ * @brief Single-pass lookup of a top-level integer/boolean member
+ *
+ * Tolerates arbitrary whitespace and member order, skips nested values and
+ * accepts numbers as well as true/false. No copies, no allocation.
+ */
+static bool bHTTP_JsonGetInt(const char *pcJson, const char *pcKey,
+                             int *piValue) {
+  if (pcJson == NULL || pcKey == NULL || piValue == NULL) {
+    return false;
+  }
+
+  size_t u32KeyLen = strlen(pcKey);
+  const char *pc = pcJsonSkipWs(pcJson);
+  if (*pc != '{') {
+    return false;
+  }
+  pc++;
+
+  for (;;) {
+    pc = pcJsonSkipWs(pc);
+    if (*pc != '"') {
+      return false; // '}' (key not present) or malformed
+    }
+
+    const char *pcName = pc + 1;
+    pc = pcJsonSkipString(pc);
+    if (pc == NULL) {
+      return false;
+    }
+    bool bMatch = ((size_t)(pc - 1 - pcName) == u32KeyLen) &&
+                  (memcmp(pcName, pcKey, u32KeyLen) == 0);
+
+    pc = pcJsonSkipWs(pc);
+    if (*pc != ':') {
+      return false;
+    }
+    pc = pcJsonSkipWs(pc + 1);
+
+    if (bMatch) {
+      if (strncmp(pc, "true", 4) == 0) {
+        *piValue = 1;
+        return true;
+      }
+      if (strncmp(pc, "false", 5) == 0) {
+        *piValue = 0;
+        return true;
+      }
+
+      bool bNegative = false;
+      if (*pc == '-') {
+        bNegative = true;
+        pc++;
+      }
+      if (*pc < '0' || *pc > '9') {
+        return false;
+      }
+      int iValue = 0;
+      while (*pc >= '0' && *pc <= '9') {
+        iValue = iValue * 10 + (*pc - '0');
+        pc++;
+      }
+      *piValue = bNegative ? -iValue : iValue;
+      return true;
+    }
+
+    pc = pcJsonSkipValue(pc);
+    if (pc == NULL) {
+      return false;
+    }
+    pc = pcJsonSkipWs(pc);
+    if (*pc != ',') {
+      return false;
+    }
+    pc++;
+  }
 }
 
-// Private Functions ===========================================================
+// HTTP Transport ==============================================================
 
-static eRetType_t eHTTP_GetRequest(const char *pcURL, char **ppcResponse) {
-  return eHTTP_MakeRequest(pcURL, "GET", NULL, ppcResponse);
+static eRetType_t eHTTP_GetRequest(pcHTTPTarget_t pcTarget, char *pcResponse,
+                                   size_t u32ResponseSize) {
+  return eHTTP_MakeRequest(pcTarget, false, NULL, pcResponse,
+                           u32ResponseSize);
 }
 
-static eRetType_t eHTTP_PostRequest(const char *pcURL, const char *pcBody,
-                                    char **ppcResponse) {
-  return eHTTP_MakeRequest(pcURL, "POST", pcBody, ppcResponse);
+static eRetType_t eHTTP_PostRequest(pcHTTPTarget_t pcTarget,
+                                    const char *pcBody, char *pcResponse,
+                                    size_t u32ResponseSize) {
+  return eHTTP_MakeRequest(pcTarget, true, pcBody, pcResponse,
+                           u32ResponseSize);
 }
 
-static eRetType_t eHTTP_MakeRequest(const char *pcURL, const char *pcMethod,
-                                    const char *pcBody, char **ppcResponse) {
-  if (pcURL == NULL || pcMethod == NULL || ppcResponse == NULL) {
+/**
+ * @brief Perform one HTTP request into a caller-supplied response buffer
+ *
+ * The response is always NUL-terminated (empty string for an empty body) and
+ * truncated to u32ResponseSize - 1 bytes. Nothing is allocated on the heap.
+ */
+static eRetType_t eHTTP_MakeRequest(pcHTTPTarget_t pcTarget, bool bPost,
+                                    const char *pcBody, char *pcResponse,
+                                    size_t u32ResponseSize) {
+  if (pcTarget == NULL || pcResponse == NULL || u32ResponseSize == 0) {
     return RET_TYPE_NULL_POINTER;
   }
 
-  *ppcResponse = NULL;
+  pcResponse[0] = '\0';
 
 #ifdef _WIN32
-  // Parse URL manually (simpler than WinHttpCrackUrl for MinGW compatibility)
-  // Expected format: http://localhost:8080/api/gpio/...
-  const char *pcPath = strstr(pcURL, "/api/");
-  if (pcPath == NULL) {
-    return RET_TYPE_FAIL;
-  }
-
   // Use cached session and connection (created during Init) - much faster!
   if (g_hHTTPSession == NULL || g_hHTTPConnect == NULL) {
     return RET_TYPE_NOT_INITIALIZED;
@@ -341,32 +718,10 @@ static eRetType_t eHTTP_MakeRequest(const char *pcURL, const char *pcMethod,
 
   HINTERNET hConnect = g_hHTTPConnect;
 
-  // Convert path to wide string
-  size_t u32PathLen = strlen(pcPath);
-  wchar_t *pwPath = (wchar_t *)malloc((u32PathLen + 1) * sizeof(wchar_t));
-  if (pwPath == NULL) {
-    // Don't close shared handles - they're reused
-    return RET_TYPE_MEMORY_ERROR;
-  }
-  MultiByteToWideChar(CP_UTF8, 0, pcPath, -1, pwPath, (int)(u32PathLen + 1));
-
-  // Convert method to wide string
-  size_t u32MethodLen = strlen(pcMethod);
-  wchar_t *pwMethod = (wchar_t *)malloc((u32MethodLen + 1) * sizeof(wchar_t));
-  if (pwMethod == NULL) {
-    free(pwPath);
-    // Don't close shared handles - they're reused
-    return RET_TYPE_MEMORY_ERROR;
-  }
-  MultiByteToWideChar(CP_UTF8, 0, pcMethod, -1, pwMethod,
-                      (int)(u32MethodLen + 1));
-
-  // Open request
-  HINTERNET hRequest =
-      WinHttpOpenRequest(hConnect, pwMethod, pwPath, NULL, WINHTTP_NO_REFERER,
-                         WINHTTP_DEFAULT_ACCEPT_TYPES, 0);
-  free(pwPath);
-  free(pwMethod);
+  // Open request (path is precomputed wide string, method is a literal)
+  HINTERNET hRequest = WinHttpOpenRequest(
+      hConnect, bPost ? L"POST" : L"GET", pcTarget, NULL, WINHTTP_NO_REFERER,
+      WINHTTP_DEFAULT_ACCEPT_TYPES, 0);
 
   if (hRequest == NULL) {
     // Don't close shared handles - they're reused
@@ -374,7 +729,7 @@ static eRetType_t eHTTP_MakeRequest(const char *pcURL, const char *pcMethod,
   }
 
   // Add content type for POST
-  if (strcmp(pcMethod, "POST") == 0 && pcBody != NULL) {
+  if (bPost && pcBody != NULL) {
     WinHttpAddRequestHeaders(hRequest, L"Content-Type: application/json\r\n",
                              -1, WINHTTP_ADDREQ_FLAG_ADD);
   }
@@ -415,92 +770,96 @@ static eRetType_t eHTTP_MakeRequest(const char *pcURL, const char *pcMethod,
     }
   }
 
-  // Read response
-  DWORD dwBytesAvailable = 0;
-  DWORD dwBytesRead = 0;
-  char *pcBuffer = NULL;
+  // Read response straight into the caller's buffer. Anything beyond its
+  // capacity is drained into a small stack sink so the connection stays
+  // reusable.
   DWORD dwTotalBytesRead = 0;
-  DWORD dwBufferSize = MAX_RESPONSE_SIZE;
+  DWORD dwCapacity = (DWORD)(u32ResponseSize - 1);
+  char acSink[64];
 
-  pcBuffer = (char *)malloc(dwBufferSize);
-  if (pcBuffer == NULL) {
-    WinHttpCloseHandle(hRequest);
-    // Don't close shared handles - they're reused
-    return RET_TYPE_MEMORY_ERROR;
-  }
-
-  do {
-    if (!WinHttpQueryDataAvailable(hRequest, &dwBytesAvailable))
-      break;
-    if (dwBytesAvailable == 0)
-      break;
+  for (;;) {
+    DWORD dwBytesRead = 0;
+    char *pcDest = acSink;
+    DWORD dwChunk = sizeof(acSink);
 
-    if (dwTotalBytesRead + dwBytesAvailable > dwBufferSize) {
-      dwBufferSize = dwTotalBytesRead + dwBytesAvailable + 1;
-      char *pcNewBuffer = (char *)realloc(pcBuffer, dwBufferSize);
-      if (pcNewBuffer == NULL)
-        break;
-      pcBuffer = pcNewBuffer;
+    if (dwTotalBytesRead < dwCapacity) {
+      pcDest = pcResponse + dwTotalBytesRead;
+      dwChunk = dwCapacity - dwTotalBytesRead;
     }
 
-    if (!WinHttpReadData(hRequest, pcBuffer + dwTotalBytesRead,
-                         dwBytesAvailable, &dwBytesRead))
+    if (!WinHttpReadData(hRequest, pcDest, dwChunk, &dwBytesRead) ||
+        dwBytesRead == 0)
       break;
 
-    dwTotalBytesRead += dwBytesRead;
-  } while (dwBytesAvailable > 0);
+    if (pcDest != acSink) {
+      dwTotalBytesRead += dwBytesRead;
+    }
+  }
 
   // Success - empty response is OK (some endpoints return no body)
-  if (dwTotalBytesRead > 0) {
-    pcBuffer[dwTotalBytesRead] = '\0';
-    *ppcResponse = pcBuffer;
-  } else {
-    // Empty response - still success (HTTP 200 with no body)
-    free(pcBuffer);
-    *ppcResponse = NULL;
-  }
+  pcResponse[dwTotalBytesRead] = '\0';
 
   WinHttpCloseHandle(hRequest); // Close request handle only
   // Don't close shared session/connection - they're reused for next request
   return RET_TYPE_SUCCESS;
 
 #else
-  // Linux/Mac: Use curl via popen
+  // Linux/Mac: Use curl via popen. -w appends the 3-digit HTTP status to
+  // the body: success comes from it (2xx, as on Windows), not the body.
   char acCommand[512];
-  if (strcmp(pcMethod, "POST") == 0 && pcBody != NULL) {
+  if (bPost && pcBody != NULL) {
     snprintf(acCommand, sizeof(acCommand),
-             "curl -s --max-time 0.5 -X POST -H \"Content-Type: "
-             "application/json\" -d '%s' \"%s\"",
-             pcBody, pcURL);
+             "curl -s --max-time 0.5 -w '%%{http_code}' -X POST -H "
+             "\"Content-Type: application/json\" -d '%s' \"%s\"",
+             pcBody, pcTarget);
   } else {
-    snprintf(acCommand, sizeof(acCommand), "curl -s --max-time 0.5 \"%s\"",
-             pcURL);
+    snprintf(acCommand, sizeof(acCommand),
+             "curl -s --max-time 0.5 -w '%%{http_code}' \"%s\"", pcTarget);
   }
 
   FILE *pFile = popen(acCommand, "r");
   if (pFile != NULL) {
-    char acBuffer[MAX_RESPONSE_SIZE] = {0};
-    size_t u32TotalRead = 0;
-    size_t u32BytesRead;
-
-    while ((u32BytesRead = fread(acBuffer + u32TotalRead, 1,
-                                 sizeof(acBuffer) - u32TotalRead - 1, pFile)) >
-           0) {
-      u32TotalRead += u32BytesRead;
-      if (u32TotalRead >= sizeof(acBuffer) - 1)
+    // Output past the caller's buffer is drained into a small stack sink, so
+    // curl is not cut off and the status at the end is still seen
+    size_t u32TotalRead = 0; // Bytes in pcResponse
+    size_t u32Output = 0;    // Bytes of curl output, status included
+    size_t u32Capacity = u32ResponseSize - 1;
+    char acStatus[3] = {0}; // Last 3 bytes of output
+    char acSink[64];
+
+    for (;;) {
+      char *pcDest = acSink;
+      size_t u32Chunk = sizeof(acSink);
+
+      if (u32TotalRead < u32Capacity) {
+        pcDest = pcResponse + u32TotalRead;
+        u32Chunk = u32Capacity - u32TotalRead;
+      }
+
+      size_t u32BytesRead = fread(pcDest, 1, u32Chunk, pFile);
+      if (u32BytesRead == 0)
         break;
+
+      for (size_t i = 0; i < u32BytesRead; i++) {
+        acStatus[0] = acStatus[1];
+        acStatus[1] = acStatus[2];
+        acStatus[2] = pcDest[i];
+      }
+      u32Output += u32BytesRead;
+      if (pcDest != acSink) {
+        u32TotalRead += u32BytesRead;
+      }
     }
 
     int iStatus = pclose(pFile);
 
-    if (iStatus == 0 && u32TotalRead > 0) {
-      *ppcResponse = (char *)malloc(u32TotalRead + 1);
-      if (*ppcResponse != NULL) {
-        memcpy(*ppcResponse, acBuffer, u32TotalRead);
-        (*ppcResponse)[u32TotalRead] = '\0';
-        return RET_TYPE_SUCCESS;
-      }
+    // Success - empty response is OK (some endpoints return no body)
+    if (iStatus == 0 && u32Output >= 3 && acStatus[0] == '2') {
+      size_t u32Body = u32Output - 3; // Status off the end of the body
+      pcResponse[u32Body < u32TotalRead ? u32Body : u32TotalRead] = '\0';
+      return RET_TYPE_SUCCESS;
     }
+    pcResponse[0] = '\0';
   }
 #endif
 
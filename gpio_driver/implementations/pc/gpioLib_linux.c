@@ -0,0 +1,515 @@
+//==============================================================================
+// GPIO Library - Linux GPIO Character Device Implementation
+//------------------------------------------------------------------------------
+//! @file
+//! @brief GPIO implementation on /dev/gpiochipN using the v2 line uAPI
+//!
+//! All configured lines of a chip are requested with one
+//! GPIO_V2_GET_LINE_IOCTL at init. Reads and writes are single
+//! GET/SET_VALUES ioctls on that request using a per-pin bit mask, and
+//! input lines report both edges through the same request fd.
+//!
+//! Pin mapping comes from g_psGpioPinConfigs (pcLinuxChip/u32LinuxLine,
+//! generated from config.json). Test without hardware using the kernel's
+//! gpio-sim module: see scripts/gpio_sim_setup.sh.
+//------------------------------------------------------------------------------
+
+#ifdef __linux__
+
+#define _GNU_SOURCE
+
+// Includes ====================================================================
+#include "../../common.h"
+#include "../../config/gpio_config.h" // Configuration for all pins
+#include "../../gpioLib.h"
+#include "gpioLib_linux.h"
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/gpio.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+// Constants ===================================================================
+#define MAX_PINS 32
+#define LINUX_MAX_CHIPS 4
+#define LINUX_CONSUMER "gpio_hal"
+#define LINUX_EDGE_FLAGS                                                       \
+  (GPIO_V2_LINE_FLAG_EDGE_RISING | GPIO_V2_LINE_FLAG_EDGE_FALLING)
+
+// Type Definitions ============================================================
+typedef struct {
+  const char *pcChip;  // As given in the config
+  int iLineFd;         // Line request fd (-1 = not requested)
+  uint8_t u8LineCount; // Lines in the request (bit index = position)
+  uint64_t u64OutputValues; // Last written output values, kept on reconfig
+} sLinuxChip_t;
+
+typedef struct {
+  const char *pcPinName;
+  uint32_t u32Line;
+  uint8_t u8Chip; // Index in g_asLinuxChips
+  uint8_t u8Bit;  // Position in the chip's line request
+  eGpioDirection_t eDirection;
+  eGpioPull_t ePull;
+} sLinuxPin_t;
+
+// Static Variables ============================================================
+static bool g_bLinuxInitialized = false;
+static sLinuxChip_t g_asLinuxChips[LINUX_MAX_CHIPS];
+static uint8_t g_u8LinuxChipCount = 0;
+static sLinuxPin_t g_asLinuxPins[MAX_PINS];
+static uint8_t g_u8LinuxPinCount = 0;
+
+// Private Function Prototypes ================================================
+static sLinuxPin_t *psLinux_FindPin(const char *pcPinName);
+static int iLinux_FindOrAddChip(const char *pcChip);
+static int iLinux_OpenChip(const char *pcChip);
+static uint64_t u64Linux_PinFlags(const sLinuxPin_t *psPin);
+static void vLinux_BuildConfig(uint8_t u8Chip,
+                               struct gpio_v2_line_config *psConfig);
+static bool bLinux_RequestChip(uint8_t u8Chip);
+
+// Forward Declarations =======================================================
+eRetType_t eGpioLinuxConfigure(const sGpioConfig_t *psConfig);
+
+// Functions ===================================================================
+
+/**
+ * @brief Initialize the Linux GPIO interface
+ * Groups the configured pins by chip and requests each chip's lines at once
+ */
+void vGpioLinuxInit(void) {
+  if (g_bLinuxInitialized) {
+    return;
+  }
+
+  printf("[GPIO LINUX] Initializing Linux GPIO chardev implementation...\n");
+
+  const sGpioPinConfig_t *psPinConfig = g_psGpioPinConfigs;
+  while (psPinConfig->pcPinName != NULL) {
+    if (psPinConfig->pcLinuxChip == NULL) {
+      printf("[GPIO LINUX] [WARNING] %s has no linux mapping, skipped.\n",
+             psPinConfig->pcPinName);
+      psPinConfig++;
+      continue;
+    }
+
+    int iChip = iLinux_FindOrAddChip(psPinConfig->pcLinuxChip);
+    if (iChip < 0 || g_u8LinuxPinCount >= MAX_PINS ||
+        g_asLinuxChips[iChip].u8LineCount >= GPIO_V2_LINES_MAX) {
+      printf("[GPIO LINUX] [ERROR] Too many pins/chips, %s skipped.\n",
+             psPinConfig->pcPinName);
+      psPinConfig++;
+      continue;
+    }
+
+    sLinuxPin_t *psPin = &g_asLinuxPins[g_u8LinuxPinCount++];
+    psPin->pcPinName = psPinConfig->pcPinName;
+    psPin->u32Line = psPinConfig->u32LinuxLine;
+    psPin->u8Chip = (uint8_t)iChip;
+    psPin->u8Bit = g_asLinuxChips[iChip].u8LineCount++;
+    psPin->eDirection = psPinConfig->eDirection;
+    psPin->ePull = psPinConfig->ePull;
+    psPinConfig++;
+  }
+
+  uint8_t u8ConfiguredCount = 0;
+  for (uint8_t i = 0; i < g_u8LinuxChipCount; i++) {
+    if (bLinux_RequestChip(i)) {
+      u8ConfiguredCount += g_asLinuxChips[i].u8LineCount;
+    }
+  }
+
+  g_bLinuxInitialized = true;
+  printf("[GPIO LINUX] Initialization complete. Requested %u lines on %u "
+         "chip(s).\n",
+         u8ConfiguredCount, g_u8LinuxChipCount);
+}
+
+/**
+ * @brief Reconfigure a mapped pin (direction/pull) on its live request
+ */
+eRetType_t eGpioLinuxConfigure(const sGpioConfig_t *psConfig) {
+  if (psConfig == NULL || psConfig->pcPinName == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+
+  if (!g_bLinuxInitialized) {
+    return RET_TYPE_NOT_INITIALIZED;
+  }
+
+  sLinuxPin_t *psPin = psLinux_FindPin(psConfig->pcPinName);
+  if (psPin == NULL) {
+    return RET_TYPE_NOT_FOUND; // Only pins mapped in config.json exist
+  }
+
+  sLinuxChip_t *psChip = &g_asLinuxChips[psPin->u8Chip];
+  if (psChip->iLineFd < 0) {
+    return RET_TYPE_NOT_AVAILABLE;
+  }
+
+  psPin->eDirection = psConfig->eDirection;
+  psPin->ePull = psConfig->ePull;
+
+  struct gpio_v2_line_config sLineConfig;
+  vLinux_BuildConfig(psPin->u8Chip, &sLineConfig);
+  if (ioctl(psChip->iLineFd, GPIO_V2_LINE_SET_CONFIG_IOCTL, &sLineConfig) <
+      0) {
+    printf("[GPIO LINUX] [ERROR] Reconfigure %s failed: %s\n",
+           psPin->pcPinName, strerror(errno));
+    return RET_TYPE_FAIL;
+  }
+  return RET_TYPE_SUCCESS;
+}
+
+/**
+ * @brief Read a GPIO pin state
+ */
+eRetType_t eGpioLinuxRead(const char *pcPinName, bool *pbValue) {
+  if (pcPinName == NULL || pbValue == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+  return eGpioLinuxReadMany(&pcPinName, pbValue, 1);
+}
+
+/**
+ * @brief Write a GPIO pin state
+ */
+eRetType_t eGpioLinuxWrite(const char *pcPinName, bool bValue) {
+  if (pcPinName == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+  return eGpioLinuxWriteMany(&pcPinName, &bValue, 1);
+}
+
+eRetType_t eGpioLinuxReadMany(const char *const *ppcPinNames, bool *pbValues,
+                              uint8_t u8Count) {
+  if (ppcPinNames == NULL || pbValues == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+
+  if (!g_bLinuxInitialized) {
+    return RET_TYPE_NOT_INITIALIZED;
+  }
+
+  struct gpio_v2_line_values asValues[LINUX_MAX_CHIPS];
+  memset(asValues, 0, sizeof(asValues));
+
+  for (uint8_t i = 0; i < u8Count; i++) {
+    const sLinuxPin_t *psPin = psLinux_FindPin(ppcPinNames[i]);
+    if (psPin == NULL) {
+      return RET_TYPE_NOT_FOUND;
+    }
+    asValues[psPin->u8Chip].mask |= 1ull << psPin->u8Bit;
+  }
+
+  for (uint8_t u8Chip = 0; u8Chip < g_u8LinuxChipCount; u8Chip++) {
+    if (asValues[u8Chip].mask == 0) {
+      continue;
+    }
+    if (g_asLinuxChips[u8Chip].iLineFd < 0) {
+      return RET_TYPE_NOT_AVAILABLE;
+    }
+    if (ioctl(g_asLinuxChips[u8Chip].iLineFd, GPIO_V2_LINE_GET_VALUES_IOCTL,
+              &asValues[u8Chip]) < 0) {
+      return RET_TYPE_FAIL;
+    }
+  }
+
+  for (uint8_t i = 0; i < u8Count; i++) {
+    const sLinuxPin_t *psPin = psLinux_FindPin(ppcPinNames[i]);
+    pbValues[i] = ((asValues[psPin->u8Chip].bits >> psPin->u8Bit) & 1u) != 0;
+  }
+  return RET_TYPE_SUCCESS;
+}
+
+eRetType_t eGpioLinuxWriteMany(const char *const *ppcPinNames,
+                               const bool *pbValues, uint8_t u8Count) {
+  if (ppcPinNames == NULL || pbValues == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+
+  if (!g_bLinuxInitialized) {
+    return RET_TYPE_NOT_INITIALIZED;
+  }
+
+  struct gpio_v2_line_values asValues[LINUX_MAX_CHIPS];
+  memset(asValues, 0, sizeof(asValues));
+
+  for (uint8_t i = 0; i < u8Count; i++) {
+    const sLinuxPin_t *psPin = psLinux_FindPin(ppcPinNames[i]);
+    if (psPin == NULL) {
+      return RET_TYPE_NOT_FOUND;
+    }
+    if (psPin->eDirection != GPIO_DIR_OUTPUT) {
+      return RET_TYPE_INVALID_STATE; // The kernel rejects driving inputs
+    }
+    uint64_t u64Bit = 1ull << psPin->u8Bit;
+    asValues[psPin->u8Chip].mask |= u64Bit;
+    if (pbValues[i]) {
+      asValues[psPin->u8Chip].bits |= u64Bit;
+    } else {
+      asValues[psPin->u8Chip].bits &= ~u64Bit;
+    }
+  }
+
+  for (uint8_t u8Chip = 0; u8Chip < g_u8LinuxChipCount; u8Chip++) {
+    sLinuxChip_t *psChip = &g_asLinuxChips[u8Chip];
+    if (asValues[u8Chip].mask == 0) {
+      continue;
+    }
+    if (psChip->iLineFd < 0) {
+      return RET_TYPE_NOT_AVAILABLE;
+    }
+    if (ioctl(psChip->iLineFd, GPIO_V2_LINE_SET_VALUES_IOCTL,
+              &asValues[u8Chip]) < 0) {
+      return RET_TYPE_FAIL;
+    }
+    psChip->u64OutputValues = (psChip->u64OutputValues &
+                               ~asValues[u8Chip].mask) |
+                              asValues[u8Chip].bits;
+  }
+  return RET_TYPE_SUCCESS;
+}
+
+eRetType_t eGpioLinuxWaitEvent(sGpioLinuxEvent_t *psEvent, int iTimeoutMs) {
+  if (psEvent == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+
+  if (!g_bLinuxInitialized) {
+    return RET_TYPE_NOT_INITIALIZED;
+  }
+
+  struct pollfd asPoll[LINUX_MAX_CHIPS];
+  uint8_t au8Chip[LINUX_MAX_CHIPS];
+  nfds_t u32Fds = 0;
+  for (uint8_t i = 0; i < g_u8LinuxChipCount; i++) {
+    if (g_asLinuxChips[i].iLineFd >= 0) {
+      asPoll[u32Fds].fd = g_asLinuxChips[i].iLineFd;
+      asPoll[u32Fds].events = POLLIN;
+      au8Chip[u32Fds++] = i;
+    }
+  }
+  if (u32Fds == 0) {
+    return RET_TYPE_NOT_AVAILABLE;
+  }
+
+  if (poll(asPoll, u32Fds, iTimeoutMs) <= 0) {
+    return RET_TYPE_NOT_AVAILABLE;
+  }
+
+  for (nfds_t i = 0; i < u32Fds; i++) {
+    if ((asPoll[i].revents & POLLIN) == 0) {
+      continue;
+    }
+    struct gpio_v2_line_event sEvent;
+    if (read(asPoll[i].fd, &sEvent, sizeof(sEvent)) != sizeof(sEvent)) {
+      continue;
+    }
+    for (uint8_t j = 0; j < g_u8LinuxPinCount; j++) {
+      if (g_asLinuxPins[j].u8Chip == au8Chip[i] &&
+          g_asLinuxPins[j].u32Line == sEvent.offset) {
+        psEvent->pcPinName = g_asLinuxPins[j].pcPinName;
+        psEvent->bRising = (sEvent.id == GPIO_V2_LINE_EVENT_RISING_EDGE);
+        psEvent->u64TimestampNs = sEvent.timestamp_ns;
+        return RET_TYPE_SUCCESS;
+      }
+    }
+  }
+  return RET_TYPE_NOT_AVAILABLE;
+}
+
+// Private Functions ===========================================================
+
+static sLinuxPin_t *psLinux_FindPin(const char *pcPinName) {
+  if (pcPinName == NULL) {
+    return NULL;
+  }
+  for (uint8_t i = 0; i < g_u8LinuxPinCount; i++) {
+    if (strcmp(g_asLinuxPins[i].pcPinName, pcPinName) == 0) {
+      return &g_asLinuxPins[i];
+    }
+  }
+  return NULL;
+}
+
+static int iLinux_FindOrAddChip(const char *pcChip) {
+  for (uint8_t i = 0; i < g_u8LinuxChipCount; i++) {
+    if (strcmp(g_asLinuxChips[i].pcChip, pcChip) == 0) {
+      return i;
+    }
+  }
+  if (g_u8LinuxChipCount >= LINUX_MAX_CHIPS) {
+    return -1;
+  }
+  sLinuxChip_t *psChip = &g_asLinuxChips[g_u8LinuxChipCount];
+  memset(psChip, 0, sizeof(*psChip));
+  psChip->pcChip = pcChip;
+  psChip->iLineFd = -1;
+  return g_u8LinuxChipCount++;
+}
+
+/**
+ * @brief Open a chip by name ("gpiochip0"), path, or label (gpio-sim banks
+ * get a new gpiochipN on every setup, but keep their label)
+ */
+static int iLinux_OpenChip(const char *pcChip) {
+  char acPath[288];
+  if (pcChip[0] == '/') {
+    snprintf(acPath, sizeof(acPath), "%s", pcChip);
+  } else {
+    snprintf(acPath, sizeof(acPath), "/dev/%s", pcChip);
+  }
+
+  int iFd = open(acPath, O_RDWR | O_CLOEXEC);
+  if (iFd >= 0 || pcChip[0] == '/') {
+    return iFd;
+  }
+
+  DIR *psDir = opendir("/dev");
+  if (psDir == NULL) {
+    return -1;
+  }
+  struct dirent *psEntry;
+  while ((psEntry = readdir(psDir)) != NULL) {
+    if (strncmp(psEntry->d_name, "gpiochip", 8) != 0) {
+      continue;
+    }
+    snprintf(acPath, sizeof(acPath), "/dev/%s", psEntry->d_name);
+    iFd = open(acPath, O_RDWR | O_CLOEXEC);
+    if (iFd < 0) {
+      continue;
+    }
+    struct gpiochip_info sInfo;
+    if (ioctl(iFd, GPIO_GET_CHIPINFO_IOCTL, &sInfo) == 0 &&
+        strncmp(sInfo.label, pcChip, sizeof(sInfo.label)) == 0) {
+      closedir(psDir);
+      return iFd;
+    }
+    close(iFd);
+  }
+  closedir(psDir);
+  return -1;
+}
+
+static uint64_t u64Linux_PinFlags(const sLinuxPin_t *psPin) {
+  uint64_t u64Flags;
+  if (psPin->eDirection == GPIO_DIR_OUTPUT) {
+    u64Flags = GPIO_V2_LINE_FLAG_OUTPUT;
+  } else {
+    u64Flags = GPIO_V2_LINE_FLAG_INPUT | LINUX_EDGE_FLAGS;
+  }
+
+  switch (psPin->ePull) {
+  case GPIO_PULL_UP:
+    u64Flags |= GPIO_V2_LINE_FLAG_BIAS_PULL_UP;
+    break;
+  case GPIO_PULL_DOWN:
+    u64Flags |= GPIO_V2_LINE_FLAG_BIAS_PULL_DOWN;
+    break;
+  default:
+    break; // Leave bias as the board configured it
+  }
+  return u64Flags;
+}
+
+/**
+ * @brief Build a line config for every requested line of a chip
+ *
+ * Lines sharing the same flags share one attribute (the uAPI allows 10),
+ * and output lines get their last written value so reconfiguring never
+ * glitches an output.
+ */
+static void vLinux_BuildConfig(uint8_t u8Chip,
+                               struct gpio_v2_line_config *psConfig) {
+  memset(psConfig, 0, sizeof(*psConfig));
+  psConfig->flags = GPIO_V2_LINE_FLAG_INPUT | LINUX_EDGE_FLAGS;
+
+  uint64_t u64OutputMask = 0;
+  for (uint8_t i = 0; i < g_u8LinuxPinCount; i++) {
+    const sLinuxPin_t *psPin = &g_asLinuxPins[i];
+    if (psPin->u8Chip != u8Chip) {
+      continue;
+    }
+
+    uint64_t u64Bit = 1ull << psPin->u8Bit;
+    uint64_t u64Flags = u64Linux_PinFlags(psPin);
+    if (psPin->eDirection == GPIO_DIR_OUTPUT) {
+      u64OutputMask |= u64Bit;
+    }
+    if (u64Flags == psConfig->flags) {
+      continue; // Default applies
+    }
+
+    uint32_t j = 0;
+    while (j < psConfig->num_attrs &&
+           psConfig->attrs[j].attr.flags != u64Flags) {
+      j++;
+    }
+    if (j == psConfig->num_attrs) {
+      psConfig->attrs[j].attr.id = GPIO_V2_LINE_ATTR_ID_FLAGS;
+      psConfig->attrs[j].attr.flags = u64Flags;
+      psConfig->num_attrs++; // At most 6 distinct flag sets exist
+    }
+    psConfig->attrs[j].mask |= u64Bit;
+  }
+
+  if (u64OutputMask != 0) {
+    struct gpio_v2_line_config_attribute *psAttr =
+        &psConfig->attrs[psConfig->num_attrs++];
+    psAttr->attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+    psAttr->attr.values = g_asLinuxChips[u8Chip].u64OutputValues;
+    psAttr->mask = u64OutputMask;
+  }
+}
+
+static bool bLinux_RequestChip(uint8_t u8Chip) {
+  sLinuxChip_t *psChip = &g_asLinuxChips[u8Chip];
+
+  int iChipFd = iLinux_OpenChip(psChip->pcChip);
+  if (iChipFd < 0) {
+    printf("[GPIO LINUX] [ERROR] Cannot open chip %s: %s\n", psChip->pcChip,
+           strerror(errno));
+    return false;
+  }
+
+  struct gpio_v2_line_request sRequest;
+  memset(&sRequest, 0, sizeof(sRequest));
+  for (uint8_t i = 0; i < g_u8LinuxPinCount; i++) {
+    if (g_asLinuxPins[i].u8Chip == u8Chip) {
+      sRequest.offsets[g_asLinuxPins[i].u8Bit] = g_asLinuxPins[i].u32Line;
+    }
+  }
+  strncpy(sRequest.consumer, LINUX_CONSUMER, sizeof(sRequest.consumer) - 1);
+  vLinux_BuildConfig(u8Chip, &sRequest.config);
+  sRequest.num_lines = psChip->u8LineCount;
+
+  int iRet = ioctl(iChipFd, GPIO_V2_GET_LINE_IOCTL, &sRequest);
+  int iErrno = errno;
+  close(iChipFd); // The line request fd stays valid on its own
+  if (iRet < 0) {
+    printf("[GPIO LINUX] [ERROR] Line request on %s failed: %s\n",
+           psChip->pcChip, strerror(iErrno));
+    return false;
+  }
+
+  psChip->iLineFd = sRequest.fd;
+  return true;
+}
+
+// Export interface structure
+const sGpioInterface_t sGpioInterfaceLinux = {
+    .vHalGpioInitFunc = vGpioLinuxInit,
+    .eHalGpioConfigureFunc = eGpioLinuxConfigure,
+    .eHalGpioReadFunc = eGpioLinuxRead,
+    .eHalGpioWriteFunc = eGpioLinuxWrite};
+
+#endif // __linux__
@@ -0,0 +1,60 @@
+//==============================================================================
+// GPIO Library - Linux GPIO Character Device Implementation Header
+//------------------------------------------------------------------------------
+//! @file
+//! @brief Linux /dev/gpiochipN (uAPI v2) GPIO implementation header
+//------------------------------------------------------------------------------
+
+#ifndef GPIO_LIB_LINUX_H
+#define GPIO_LIB_LINUX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Includes ====================================================================
+#include "gpioLib.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Type Definitions ============================================================
+
+/**
+ * @brief Edge event on an input line
+ */
+typedef struct {
+  const char *pcPinName;   // Pin name from the configuration
+  bool bRising;            // true = rising edge, false = falling edge
+  uint64_t u64TimestampNs; // Kernel timestamp (CLOCK_MONOTONIC)
+} sGpioLinuxEvent_t;
+
+// External Variables ==========================================================
+extern const sGpioInterface_t sGpioInterfaceLinux;
+
+// Function Prototypes =========================================================
+
+/**
+ * @brief Read several pins with one GET_VALUES ioctl per chip
+ */
+eRetType_t eGpioLinuxReadMany(const char *const *ppcPinNames, bool *pbValues,
+                              uint8_t u8Count);
+
+/**
+ * @brief Write several pins with one SET_VALUES ioctl per chip
+ */
+eRetType_t eGpioLinuxWriteMany(const char *const *ppcPinNames,
+                               const bool *pbValues, uint8_t u8Count);
+
+/**
+ * @brief Wait for the next edge on any configured input
+ * @param iTimeoutMs poll() timeout (-1 = block, 0 = non-blocking)
+ * @return RET_TYPE_SUCCESS with psEvent filled, RET_TYPE_NOT_AVAILABLE on
+ *         timeout
+ */
+eRetType_t eGpioLinuxWaitEvent(sGpioLinuxEvent_t *psEvent, int iTimeoutMs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPIO_LIB_LINUX_H
@@ -0,0 +1,357 @@
+//==============================================================================
+// GPIO Library - Shared-Memory GPIO Implementation (Co-Simulation)
+//------------------------------------------------------------------------------
+//! @file
+//! @brief GPIO implementation over a POSIX shared-memory segment
+//!
+//! Pin values live in atomic bitsets inside a segment that any number of
+//! processes can map (see gpioLib_shm_layout.h). Reads are a single atomic
+//! load, writes a single atomic OR/AND; waiters are woken through a futex on
+//! the change counter (Linux) or by polling it (other POSIX hosts).
+//------------------------------------------------------------------------------
+
+#ifndef _WIN32
+
+#define _GNU_SOURCE
+
+// Includes ====================================================================
+#include "../../common.h"
+#include "../../config/gpio_config.h" // Configuration for all pins
+#include "../../gpioLib.h"
+#include "gpioLib_shm.h"
+#include "gpioLib_shm_layout.h"
+#include <fcntl.h>
+#include <limits.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+// Constants ===================================================================
+#define MAX_PINS 32
+#define SHM_POLL_INTERVAL_NS 1000000L // Non-futex hosts: 1 ms
+
+// Type Definitions ============================================================
+typedef struct {
+  char acPinName[GPIO_SHM_MAX_PIN_NAME_LEN];
+  uint16_t u16Index; // Bit position in the segment
+} sShmPin_t;
+
+// Static Variables ============================================================
+static bool g_bSHMInitialized = false;
+static sGpioShmSegment_t *g_psShm = NULL;
+static sShmPin_t g_asSHMPins[MAX_PINS];
+static uint8_t g_u8SHMPinCount = 0;
+
+// Private Function Prototypes ================================================
+static bool bSHM_Map(void);
+static sShmPin_t *psSHM_FindPin(const char *pcPinName);
+static int iSHM_FindSlot(const char *pcPinName, uint32_t u32Count);
+static int iSHM_Register(const char *pcPinName, eGpioPull_t ePull);
+static void vSHM_NotifyChange(void);
+
+// Forward Declarations =======================================================
+eRetType_t eGpioSHMConfigure(const sGpioConfig_t *psConfig);
+
+// Functions ===================================================================
+
+/**
+ * @brief Initialize the shared-memory GPIO interface
+ * Maps (creating if needed) the segment and registers all pins from config
+ */
+void vGpioSHMInit(void) {
+  if (g_bSHMInitialized) {
+    return;
+  }
+
+  const char *pcName = getenv(GPIO_SHM_NAME_ENV);
+  printf("[GPIO SHM] Initializing shared-memory GPIO implementation (%s)...\n",
+         (pcName != NULL) ? pcName : GPIO_SHM_NAME);
+
+  if (!bSHM_Map()) {
+    printf("[GPIO SHM] [ERROR] Cannot map shared-memory segment.\n");
+    return;
+  }
+
+  g_bSHMInitialized = true;
+
+  const sGpioPinConfig_t *psPinConfig = g_psGpioPinConfigs;
+  uint8_t u8ConfiguredCount = 0;
+
+  while (psPinConfig->pcPinName != NULL) {
+    sGpioConfig_t sConfig = {.pcPinName = psPinConfig->pcPinName,
+                             .eDirection = psPinConfig->eDirection,
+                             .ePull = psPinConfig->ePull};
+
+    if (eGpioSHMConfigure(&sConfig) == RET_TYPE_SUCCESS) {
+      u8ConfiguredCount++;
+    }
+    psPinConfig++;
+  }
+
+  printf("[GPIO SHM] Initialization complete. Configured %u pins from "
+         "config.\n",
+         u8ConfiguredCount);
+}
+
+/**
+ * @brief Configure a GPIO pin (registers it in the segment if new)
+ */
+eRetType_t eGpioSHMConfigure(const sGpioConfig_t *psConfig) {
+  if (psConfig == NULL || psConfig->pcPinName == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+
+  if (!g_bSHMInitialized) {
+    return RET_TYPE_NOT_INITIALIZED;
+  }
+
+  size_t u32NameLen = strlen(psConfig->pcPinName);
+  if (u32NameLen == 0 || u32NameLen >= GPIO_SHM_MAX_PIN_NAME_LEN) {
+    return RET_TYPE_INVALID_PARAMETER;
+  }
+
+  sShmPin_t *psPin = psSHM_FindPin(psConfig->pcPinName);
+  if (psPin == NULL) {
+    if (g_u8SHMPinCount >= MAX_PINS) {
+      return RET_TYPE_FAIL;
+    }
+    int iIndex = iSHM_Register(psConfig->pcPinName, psConfig->ePull);
+    if (iIndex < 0) {
+      return RET_TYPE_MEMORY_ERROR; // Segment pin table full
+    }
+    psPin = &g_asSHMPins[g_u8SHMPinCount++];
+    memcpy(psPin->acPinName, psConfig->pcPinName, u32NameLen + 1);
+    psPin->u16Index = (uint16_t)iIndex;
+  }
+
+  uint64_t u64Mask = 1ull << (psPin->u16Index & 63);
+  uint64_t *pu64Output = &g_psShm->au64Output[psPin->u16Index >> 6];
+  if (psConfig->eDirection == GPIO_DIR_OUTPUT) {
+    __atomic_fetch_or(pu64Output, u64Mask, __ATOMIC_RELEASE);
+  } else {
+    __atomic_fetch_and(pu64Output, ~u64Mask, __ATOMIC_RELEASE);
+  }
+  __atomic_store_n(&g_psShm->au8Pull[psPin->u16Index],
+                   (uint8_t)psConfig->ePull, __ATOMIC_RELAXED);
+
+  return RET_TYPE_SUCCESS;
+}
+
+/**
+ * @brief Read a GPIO pin state (one atomic load)
+ */
+eRetType_t eGpioSHMRead(const char *pcPinName, bool *pbValue) {
+  if (pcPinName == NULL || pbValue == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+
+  if (!g_bSHMInitialized) {
+    return RET_TYPE_NOT_INITIALIZED;
+  }
+
+  const sShmPin_t *psPin = psSHM_FindPin(pcPinName);
+  if (psPin == NULL) {
+    *pbValue = false;
+    return RET_TYPE_NOT_FOUND;
+  }
+
+  uint64_t u64Word = __atomic_load_n(&g_psShm->au64Value[psPin->u16Index >> 6],
+                                     __ATOMIC_ACQUIRE);
+  *pbValue = ((u64Word >> (psPin->u16Index & 63)) & 1u) != 0;
+  return RET_TYPE_SUCCESS;
+}
+
+/**
+ * @brief Write a GPIO pin state (one atomic OR/AND, wake only on change)
+ */
+eRetType_t eGpioSHMWrite(const char *pcPinName, bool bValue) {
+  if (pcPinName == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+
+  if (!g_bSHMInitialized) {
+    return RET_TYPE_NOT_INITIALIZED;
+  }
+
+  const sShmPin_t *psPin = psSHM_FindPin(pcPinName);
+  if (psPin == NULL) {
+    return RET_TYPE_NOT_FOUND;
+  }
+
+  uint64_t u64Mask = 1ull << (psPin->u16Index & 63);
+  uint64_t *pu64Word = &g_psShm->au64Value[psPin->u16Index >> 6];
+  uint64_t u64Old =
+      bValue ? __atomic_fetch_or(pu64Word, u64Mask, __ATOMIC_RELEASE)
+             : __atomic_fetch_and(pu64Word, ~u64Mask, __ATOMIC_RELEASE);
+
+  if (((u64Old & u64Mask) != 0) != bValue) {
+    vSHM_NotifyChange();
+  }
+  return RET_TYPE_SUCCESS;
+}
+
+eRetType_t eGpioShmWaitChange(uint32_t *pu32Seq, uint32_t u32TimeoutMs) {
+  if (pu32Seq == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+
+  if (!g_bSHMInitialized) {
+    return RET_TYPE_NOT_INITIALIZED;
+  }
+
+  uint32_t u32Seq = __atomic_load_n(&g_psShm->u32ChangeSeq, __ATOMIC_ACQUIRE);
+  if (u32Seq != *pu32Seq) {
+    *pu32Seq = u32Seq;
+    return RET_TYPE_SUCCESS;
+  }
+
+#ifdef __linux__
+  struct timespec sTimeout;
+  sTimeout.tv_sec = u32TimeoutMs / 1000;
+  sTimeout.tv_nsec = (long)(u32TimeoutMs % 1000) * 1000000L;
+  __atomic_add_fetch(&g_psShm->u32Waiters, 1, __ATOMIC_SEQ_CST);
+  // Returns at once if the counter moved after the load above
+  syscall(SYS_futex, &g_psShm->u32ChangeSeq, FUTEX_WAIT, u32Seq, &sTimeout,
+          NULL, 0);
+  __atomic_sub_fetch(&g_psShm->u32Waiters, 1, __ATOMIC_SEQ_CST);
+#else
+  struct timespec sPoll = {.tv_sec = 0, .tv_nsec = SHM_POLL_INTERVAL_NS};
+  for (uint32_t u32Waited = 0; u32Waited < u32TimeoutMs; u32Waited++) {
+    if (__atomic_load_n(&g_psShm->u32ChangeSeq, __ATOMIC_ACQUIRE) != u32Seq) {
+      break;
+    }
+    nanosleep(&sPoll, NULL);
+  }
+#endif
+
+  *pu32Seq = __atomic_load_n(&g_psShm->u32ChangeSeq, __ATOMIC_ACQUIRE);
+  return (*pu32Seq != u32Seq) ? RET_TYPE_SUCCESS : RET_TYPE_NOT_AVAILABLE;
+}
+
+// Private Functions ===========================================================
+
+static sShmPin_t *psSHM_FindPin(const char *pcPinName) {
+  for (uint8_t i = 0; i < g_u8SHMPinCount; i++) {
+    if (strcmp(g_asSHMPins[i].acPinName, pcPinName) == 0) {
+      return &g_asSHMPins[i];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Open (or create) and map the segment, checking its layout version
+ */
+static bool bSHM_Map(void) {
+  const char *pcName = getenv(GPIO_SHM_NAME_ENV);
+  if (pcName == NULL) {
+    pcName = GPIO_SHM_NAME;
+  }
+
+  int iFd = shm_open(pcName, O_RDWR | O_CREAT, 0666);
+  if (iFd < 0) {
+    return false;
+  }
+
+  // Concurrent creators all grow it to the same size; never shrink
+  struct stat sStat;
+  if (fstat(iFd, &sStat) != 0 ||
+      ((size_t)sStat.st_size < sizeof(sGpioShmSegment_t) &&
+       ftruncate(iFd, sizeof(sGpioShmSegment_t)) != 0)) {
+    close(iFd);
+    return false;
+  }
+
+  void *pvMap = mmap(NULL, sizeof(sGpioShmSegment_t), PROT_READ | PROT_WRITE,
+                     MAP_SHARED, iFd, 0);
+  close(iFd);
+  if (pvMap == MAP_FAILED) {
+    return false;
+  }
+
+  // A zero-filled segment is already a valid empty table
+  sGpioShmSegment_t *psShm = (sGpioShmSegment_t *)pvMap;
+  uint32_t u32Expected = 0;
+  __atomic_compare_exchange_n(&psShm->u32Magic, &u32Expected, GPIO_SHM_MAGIC,
+                              false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+  if (__atomic_load_n(&psShm->u32Magic, __ATOMIC_ACQUIRE) != GPIO_SHM_MAGIC) {
+    printf("[GPIO SHM] [ERROR] %s has an incompatible layout.\n", pcName);
+    munmap(pvMap, sizeof(sGpioShmSegment_t));
+    return false;
+  }
+
+  g_psShm = psShm;
+  return true;
+}
+
+static int iSHM_FindSlot(const char *pcPinName, uint32_t u32Count) {
+  for (uint32_t i = 0; i < u32Count; i++) {
+    if (strncmp(g_psShm->aacName[i], pcPinName, GPIO_SHM_MAX_PIN_NAME_LEN) ==
+        0) {
+      return (int)i;
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief Find the pin's slot in the segment, adding it if no process has
+ * @return Slot index, or -1 if the segment is full
+ */
+static int iSHM_Register(const char *pcPinName, eGpioPull_t ePull) {
+  uint32_t u32Count = __atomic_load_n(&g_psShm->u32PinCount, __ATOMIC_ACQUIRE);
+  int iIndex = iSHM_FindSlot(pcPinName, u32Count);
+  if (iIndex >= 0) {
+    return iIndex;
+  }
+
+  while (__atomic_exchange_n(&g_psShm->u32RegisterLock, 1, __ATOMIC_ACQUIRE)) {
+    sched_yield();
+  }
+
+  // Another process may have added it while we waited
+  u32Count = __atomic_load_n(&g_psShm->u32PinCount, __ATOMIC_ACQUIRE);
+  iIndex = iSHM_FindSlot(pcPinName, u32Count);
+  if (iIndex < 0 && u32Count < GPIO_SHM_MAX_PINS) {
+    iIndex = (int)u32Count;
+    strncpy(g_psShm->aacName[iIndex], pcPinName, GPIO_SHM_MAX_PIN_NAME_LEN - 1);
+    g_psShm->au8Pull[iIndex] = (uint8_t)ePull;
+    __atomic_store_n(&g_psShm->u32PinCount, u32Count + 1, __ATOMIC_RELEASE);
+  }
+
+  __atomic_store_n(&g_psShm->u32RegisterLock, 0, __ATOMIC_RELEASE);
+  return iIndex;
+}
+
+static void vSHM_NotifyChange(void) {
+  __atomic_add_fetch(&g_psShm->u32ChangeSeq, 1, __ATOMIC_SEQ_CST);
+#ifdef __linux__
+  // Skip the syscall unless someone is blocked in eGpioShmWaitChange
+  if (__atomic_load_n(&g_psShm->u32Waiters, __ATOMIC_SEQ_CST) != 0) {
+    syscall(SYS_futex, &g_psShm->u32ChangeSeq, FUTEX_WAKE, INT_MAX, NULL, NULL,
+            0);
+  }
+#endif
+}
+
+// Export interface structure
+const sGpioInterface_t sGpioInterfaceSHM = {
+    .vHalGpioInitFunc = vGpioSHMInit,
+    .eHalGpioConfigureFunc = eGpioSHMConfigure,
+    .eHalGpioReadFunc = eGpioSHMRead,
+    .eHalGpioWriteFunc = eGpioSHMWrite};
+
+#endif // _WIN32
@@ -0,0 +1,38 @@
+//==============================================================================
+// GPIO Library - Shared-Memory GPIO Implementation Header
+//------------------------------------------------------------------------------
+//! @file
+//! @brief POSIX shared-memory GPIO implementation header (co-simulation)
+//------------------------------------------------------------------------------
+
+#ifndef GPIO_LIB_SHM_H
+#define GPIO_LIB_SHM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Includes ====================================================================
+#include "gpioLib.h"
+#include <stdint.h>
+
+// External Variables ==========================================================
+extern const sGpioInterface_t sGpioInterfaceSHM;
+
+// Function Prototypes =========================================================
+
+/**
+ * @brief Block until any pin value in the segment changes
+ * @param pu32Seq In: last change sequence seen (returns at once if the
+ *                segment has moved past it); out: current sequence
+ * @param u32TimeoutMs Maximum wait
+ * @return RET_TYPE_SUCCESS on change, RET_TYPE_NOT_AVAILABLE on timeout,
+ *         RET_TYPE_NOT_INITIALIZED before init
+ */
+eRetType_t eGpioShmWaitChange(uint32_t *pu32Seq, uint32_t u32TimeoutMs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPIO_LIB_SHM_H
@@ -0,0 +1,62 @@
+//==============================================================================
+// GPIO Library - Shared-Memory Segment Layout
+//------------------------------------------------------------------------------
+//! @file
+//! @brief Layout of the POSIX shared-memory segment used by gpioLib_shm.c
+//!
+//! Any process on the host (firmware PC build, simulator, test harness) can
+//! shm_open() GPIO_SHM_NAME, mmap() sizeof(sGpioShmSegment_t) bytes and use
+//! the same pin table. An all-zero segment is a valid empty table.
+//!
+//! Rules for writers outside gpioLib_shm.c:
+//!   - pin values and directions are bits in au64Value / au64Output, updated
+//!     with atomic OR/AND (__atomic_fetch_or / __atomic_fetch_and)
+//!   - after changing a value, increment u32ChangeSeq and, if u32Waiters is
+//!     non-zero, FUTEX_WAKE it (not FUTEX_PRIVATE: the word is shared)
+//!   - new pins are added under u32RegisterLock: fill aacName/au8Pull of slot
+//!     u32PinCount, then store u32PinCount + 1 with release ordering
+//------------------------------------------------------------------------------
+
+#ifndef GPIO_LIB_SHM_LAYOUT_H
+#define GPIO_LIB_SHM_LAYOUT_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Constants ===================================================================
+#ifndef GPIO_SHM_NAME
+#define GPIO_SHM_NAME "/gpio_sim"
+#endif
+#define GPIO_SHM_NAME_ENV "GPIO_SHM_NAME" // Runtime override of the name
+#define GPIO_SHM_VERSION 1
+#define GPIO_SHM_MAGIC (0x47504900u | GPIO_SHM_VERSION) // "GPI" + version
+#define GPIO_SHM_MAX_PINS 256
+#define GPIO_SHM_MAX_PIN_NAME_LEN 32
+#define GPIO_SHM_WORDS (GPIO_SHM_MAX_PINS / 64)
+
+// Type Definitions ============================================================
+
+/**
+ * @brief Shared segment (pin index = bit position in the bitsets)
+ */
+typedef struct {
+  uint32_t u32Magic;        // GPIO_SHM_MAGIC once initialized (0 = fresh)
+  uint32_t u32PinCount;     // Registered slots (release-published)
+  uint32_t u32RegisterLock; // Spin lock for pin registration only
+  uint32_t u32ChangeSeq;    // Futex word: bumped on every value change
+  uint32_t u32Waiters;      // Processes blocked on u32ChangeSeq
+  uint32_t u32Reserved;
+  uint64_t au64Value[GPIO_SHM_WORDS];  // 1 = high
+  uint64_t au64Output[GPIO_SHM_WORDS]; // 1 = output, 0 = input
+  uint8_t au8Pull[GPIO_SHM_MAX_PINS];  // eGpioPull_t
+  char aacName[GPIO_SHM_MAX_PINS][GPIO_SHM_MAX_PIN_NAME_LEN];
+} sGpioShmSegment_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPIO_LIB_SHM_LAYOUT_H
@@ -0,0 +1,329 @@
+//==============================================================================
+// GPIO Library - Unix Domain Socket GPIO Implementation (Simulator)
+//------------------------------------------------------------------------------
+//! @file
+//! @brief Binary GPIO implementation over a SOCK_SEQPACKET Unix socket
+//!
+//! One fixed-size request and one reply per operation, no text parsing and
+//! no heap use. Pins are registered by name at configure time; reads and
+//! writes then carry only the server-assigned handle.
+//------------------------------------------------------------------------------
+
+#ifndef _WIN32
+
+// Includes ====================================================================
+#include "../../common.h"
+#include "../../config/gpio_config.h" // Configuration for all pins
+#include "../../gpioLib.h"
+#include "gpioLib_uds_protocol.h"
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Constants ===================================================================
+#define MAX_PINS 32
+#define UDS_REPLY_TIMEOUT_US 100000 // Local server should answer in µs
+
+// Type Definitions ============================================================
+typedef struct {
+  char acPinName[GPIO_UDS_MAX_PIN_NAME_LEN];
+  eGpioDirection_t eDirection;
+  eGpioPull_t ePull;
+  uint16_t u16Handle;
+  bool bRegistered; // Handle valid for the current connection
+} sUdsPin_t;
+
+// Static Variables ============================================================
+static bool g_bUDSInitialized = false;
+static int g_iUDSFd = -1;
+static uint32_t g_u32UDSSeq = 0;
+static sUdsPin_t g_asUDSPins[MAX_PINS];
+static uint8_t g_u8UDSPinCount = 0;
+
+// Private Function Prototypes ================================================
+static bool bUDS_Connect(void);
+static void vUDS_Disconnect(void);
+static eRetType_t eUDS_Transact(sGpioUdsMsg_t *psHdr, size_t u32Size,
+                                sGpioUdsMsg_t *psReply);
+static eRetType_t eUDS_Register(sUdsPin_t *psPin);
+static sUdsPin_t *psUDS_FindPin(const char *pcPinName);
+static eRetType_t eUDS_StatusToRet(uint8_t u8Status);
+
+// Forward Declarations =======================================================
+eRetType_t eGpioUDSConfigure(const sGpioConfig_t *psConfig);
+
+// Functions ===================================================================
+
+/**
+ * @brief Initialize the UDS GPIO interface
+ * Connects to the simulator socket and registers all pins from config
+ */
+void vGpioUDSInit(void) {
+  if (g_bUDSInitialized) {
+    return;
+  }
+
+  g_bUDSInitialized = true;
+
+  const char *pcPath = getenv(GPIO_UDS_SOCKET_ENV);
+  printf("[GPIO UDS] Initializing UDS GPIO implementation (%s)...\n",
+         (pcPath != NULL) ? pcPath : GPIO_UDS_SOCKET_PATH);
+
+  if (!bUDS_Connect()) {
+    printf("[GPIO UDS] [WARNING] Simulator socket not available; pins will "
+           "be registered on first use.\n");
+  }
+
+  const sGpioPinConfig_t *psPinConfig = g_psGpioPinConfigs;
+  uint8_t u8ConfiguredCount = 0;
+
+  while (psPinConfig->pcPinName != NULL) {
+    sGpioConfig_t sConfig = {.pcPinName = psPinConfig->pcPinName,
+                             .eDirection = psPinConfig->eDirection,
+                             .ePull = psPinConfig->ePull};
+
+    if (eGpioUDSConfigure(&sConfig) == RET_TYPE_SUCCESS) {
+      u8ConfiguredCount++;
+    }
+    psPinConfig++;
+  }
+
+  printf("[GPIO UDS] Initialization complete. Configured %u pins from "
+         "config.\n",
+         u8ConfiguredCount);
+}
+
+/**
+ * @brief Configure a GPIO pin (registers it with the server)
+ */
+eRetType_t eGpioUDSConfigure(const sGpioConfig_t *psConfig) {
+  if (psConfig == NULL || psConfig->pcPinName == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+
+  if (!g_bUDSInitialized) {
+    return RET_TYPE_NOT_INITIALIZED;
+  }
+
+  size_t u32NameLen = strlen(psConfig->pcPinName);
+  if (u32NameLen == 0 || u32NameLen >= GPIO_UDS_MAX_PIN_NAME_LEN) {
+    return RET_TYPE_INVALID_PARAMETER;
+  }
+
+  sUdsPin_t *psPin = psUDS_FindPin(psConfig->pcPinName);
+  if (psPin == NULL) {
+    if (g_u8UDSPinCount >= MAX_PINS) {
+      return RET_TYPE_FAIL;
+    }
+    psPin = &g_asUDSPins[g_u8UDSPinCount++];
+    memset(psPin, 0, sizeof(*psPin));
+    memcpy(psPin->acPinName, psConfig->pcPinName, u32NameLen + 1);
+  }
+
+  psPin->eDirection = psConfig->eDirection;
+  psPin->ePull = psConfig->ePull;
+  psPin->bRegistered = false;
+
+  if (g_iUDSFd < 0 && !bUDS_Connect()) {
+    return RET_TYPE_NOT_AVAILABLE; // Registered on reconnect
+  }
+  return eUDS_Register(psPin);
+}
+
+/**
+ * @brief Read a GPIO pin state
+ */
+eRetType_t eGpioUDSRead(const char *pcPinName, bool *pbValue) {
+  if (pcPinName == NULL || pbValue == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+
+  if (!g_bUDSInitialized) {
+    return RET_TYPE_NOT_INITIALIZED;
+  }
+
+  *pbValue = false;
+
+  sUdsPin_t *psPin = psUDS_FindPin(pcPinName);
+  if (psPin == NULL) {
+    return RET_TYPE_NOT_FOUND;
+  }
+  if ((g_iUDSFd < 0 && !bUDS_Connect()) || !psPin->bRegistered) {
+    return RET_TYPE_NOT_AVAILABLE;
+  }
+
+  sGpioUdsMsg_t sRequest = {.u8Op = GPIO_UDS_OP_READ,
+                            .u16Handle = psPin->u16Handle};
+  sGpioUdsMsg_t sReply;
+  eRetType_t eRet = eUDS_Transact(&sRequest, sizeof(sRequest), &sReply);
+  if (eRet == RET_TYPE_SUCCESS) {
+    *pbValue = (sReply.u32Value != 0);
+  }
+  return eRet;
+}
+
+/**
+ * @brief Write a GPIO pin state
+ */
+eRetType_t eGpioUDSWrite(const char *pcPinName, bool bValue) {
+  if (pcPinName == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+
+  if (!g_bUDSInitialized) {
+    return RET_TYPE_NOT_INITIALIZED;
+  }
+
+  sUdsPin_t *psPin = psUDS_FindPin(pcPinName);
+  if (psPin == NULL) {
+    return RET_TYPE_NOT_FOUND;
+  }
+  if ((g_iUDSFd < 0 && !bUDS_Connect()) || !psPin->bRegistered) {
+    return RET_TYPE_NOT_AVAILABLE;
+  }
+
+  sGpioUdsMsg_t sRequest = {.u8Op = GPIO_UDS_OP_WRITE,
+                            .u16Handle = psPin->u16Handle,
+                            .u32Value = bValue ? 1u : 0u};
+  sGpioUdsMsg_t sReply;
+  return eUDS_Transact(&sRequest, sizeof(sRequest), &sReply);
+}
+
+// Private Functions ===========================================================
+
+static sUdsPin_t *psUDS_FindPin(const char *pcPinName) {
+  for (uint8_t i = 0; i < g_u8UDSPinCount; i++) {
+    if (strcmp(g_asUDSPins[i].acPinName, pcPinName) == 0) {
+      return &g_asUDSPins[i];
+    }
+  }
+  return NULL;
+}
+
+static eRetType_t eUDS_StatusToRet(uint8_t u8Status) {
+  switch (u8Status) {
+  case GPIO_UDS_STATUS_OK:
+    return RET_TYPE_SUCCESS;
+  case GPIO_UDS_STATUS_BAD_HANDLE:
+    return RET_TYPE_NOT_FOUND;
+  case GPIO_UDS_STATUS_BAD_REQUEST:
+    return RET_TYPE_INVALID_PARAMETER;
+  default:
+    return RET_TYPE_FAIL;
+  }
+}
+
+/**
+ * @brief Connect to the server and re-register every known pin
+ *
+ * A missing socket fails immediately (ENOENT/ECONNREFUSED), so callers can
+ * attempt this lazily on each operation without stalling.
+ */
+static bool bUDS_Connect(void) {
+  const char *pcPath = getenv(GPIO_UDS_SOCKET_ENV);
+  if (pcPath == NULL) {
+    pcPath = GPIO_UDS_SOCKET_PATH;
+  }
+
+  int iFd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+  if (iFd < 0) {
+    return false;
+  }
+
+  struct sockaddr_un sAddr;
+  memset(&sAddr, 0, sizeof(sAddr));
+  sAddr.sun_family = AF_UNIX;
+  strncpy(sAddr.sun_path, pcPath, sizeof(sAddr.sun_path) - 1);
+
+  if (connect(iFd, (struct sockaddr *)&sAddr, sizeof(sAddr)) != 0) {
+    close(iFd);
+    return false;
+  }
+
+  struct timeval sTimeout = {.tv_sec = 0, .tv_usec = UDS_REPLY_TIMEOUT_US};
+  setsockopt(iFd, SOL_SOCKET, SO_RCVTIMEO, &sTimeout, sizeof(sTimeout));
+  g_iUDSFd = iFd;
+
+  for (uint8_t i = 0; i < g_u8UDSPinCount; i++) {
+    if (eUDS_Register(&g_asUDSPins[i]) != RET_TYPE_SUCCESS && g_iUDSFd < 0) {
+      return false; // Connection dropped during re-registration
+    }
+  }
+  return true;
+}
+
+static void vUDS_Disconnect(void) {
+  if (g_iUDSFd >= 0) {
+    close(g_iUDSFd);
+    g_iUDSFd = -1;
+  }
+  for (uint8_t i = 0; i < g_u8UDSPinCount; i++) {
+    g_asUDSPins[i].bRegistered = false; // Handles are per connection
+  }
+}
+
+static eRetType_t eUDS_Register(sUdsPin_t *psPin) {
+  sGpioUdsConfigureMsg_t sRequest;
+  memset(&sRequest, 0, sizeof(sRequest));
+  sRequest.sHdr.u8Op = GPIO_UDS_OP_CONFIGURE;
+  sRequest.sHdr.u32Value =
+      (uint32_t)psPin->eDirection | ((uint32_t)psPin->ePull << 8);
+  memcpy(sRequest.acName, psPin->acPinName, sizeof(sRequest.acName));
+
+  sGpioUdsMsg_t sReply;
+  eRetType_t eRet = eUDS_Transact(&sRequest.sHdr, sizeof(sRequest), &sReply);
+  if (eRet == RET_TYPE_SUCCESS) {
+    psPin->u16Handle = sReply.u16Handle;
+    psPin->bRegistered = true;
+  }
+  return eRet;
+}
+
+/**
+ * @brief Send one request and wait for its reply
+ *
+ * psHdr is the header at the start of the request (u32Size bytes in all);
+ * its sequence number is set here. A timeout drops the connection, so a
+ * late reply never reaches a later request.
+ */
+static eRetType_t eUDS_Transact(sGpioUdsMsg_t *psHdr, size_t u32Size,
+                                sGpioUdsMsg_t *psReply) {
+  if (g_iUDSFd < 0) {
+    return RET_TYPE_NOT_AVAILABLE;
+  }
+
+  psHdr->u32Seq = ++g_u32UDSSeq;
+
+  if (send(g_iUDSFd, psHdr, u32Size, MSG_NOSIGNAL) != (ssize_t)u32Size) {
+    vUDS_Disconnect();
+    return RET_TYPE_NOT_AVAILABLE;
+  }
+
+  ssize_t iRead;
+  do {
+    iRead = recv(g_iUDSFd, psReply, sizeof(*psReply), 0);
+  } while (iRead < 0 && errno == EINTR);
+
+  if (iRead != (ssize_t)sizeof(*psReply) || psReply->u32Seq != psHdr->u32Seq) {
+    vUDS_Disconnect(); // Timeout, peer closed or malformed reply
+    return RET_TYPE_NOT_AVAILABLE;
+  }
+  return eUDS_StatusToRet(psReply->u8Status);
+}
+
+// Export interface structure
+const sGpioInterface_t sGpioInterfaceUDS = {
+    .vHalGpioInitFunc = vGpioUDSInit,
+    .eHalGpioConfigureFunc = eGpioUDSConfigure,
+    .eHalGpioReadFunc = eGpioUDSRead,
+    .eHalGpioWriteFunc = eGpioUDSWrite};
+
+#endif // _WIN32
@@ -0,0 +1,25 @@
+//==============================================================================
+// GPIO Library - Unix Domain Socket GPIO Implementation Header
+//------------------------------------------------------------------------------
+//! @file
+//! @brief Binary SOCK_SEQPACKET GPIO implementation header (simulator)
+//------------------------------------------------------------------------------
+
+#ifndef GPIO_LIB_UDS_H
+#define GPIO_LIB_UDS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Includes ====================================================================
+#include "gpioLib.h"
+
+// External Variables ==========================================================
+extern const sGpioInterface_t sGpioInterfaceUDS;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPIO_LIB_UDS_H
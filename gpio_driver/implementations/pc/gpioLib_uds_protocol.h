@@ -0,0 +1,74 @@
+//==============================================================================
+// GPIO Library - Unix Domain Socket Wire Protocol
+//------------------------------------------------------------------------------
+//! @file
+//! @brief Fixed-size binary messages shared by gpioLib_uds.c and the
+//!        simulator's UDS server (SOCK_SEQPACKET, host byte order)
+//!
+//! Every request gets exactly one reply carrying the same u32Seq. Pins are
+//! registered once by name (GPIO_UDS_OP_CONFIGURE); the reply's u16Handle is
+//! used for all later reads and writes so the hot path carries no strings.
+//------------------------------------------------------------------------------
+
+#ifndef GPIO_LIB_UDS_PROTOCOL_H
+#define GPIO_LIB_UDS_PROTOCOL_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Constants ===================================================================
+#ifndef GPIO_UDS_SOCKET_PATH
+#define GPIO_UDS_SOCKET_PATH "/tmp/gpio_sim.sock"
+#endif
+#define GPIO_UDS_SOCKET_ENV "GPIO_UDS_SOCKET" // Runtime override of the path
+#define GPIO_UDS_MAX_PIN_NAME_LEN 32
+
+// Type Definitions ============================================================
+
+/**
+ * @brief Operation codes
+ */
+typedef enum {
+  GPIO_UDS_OP_PING = 0,      // Health check, no payload
+  GPIO_UDS_OP_CONFIGURE = 1, // sGpioUdsConfigureMsg_t -> handle in reply
+  GPIO_UDS_OP_READ = 2,      // u16Handle -> u32Value in reply
+  GPIO_UDS_OP_WRITE = 3      // u16Handle + u32Value
+} eGpioUdsOp_t;
+
+/**
+ * @brief Reply status (mirrors the eRetType_t values used on the client)
+ */
+typedef enum {
+  GPIO_UDS_STATUS_OK = 0,
+  GPIO_UDS_STATUS_BAD_HANDLE = 1,
+  GPIO_UDS_STATUS_BAD_REQUEST = 2,
+  GPIO_UDS_STATUS_FULL = 3
+} eGpioUdsStatus_t;
+
+/**
+ * @brief Request/reply header - the whole message for PING/READ/WRITE
+ */
+typedef struct {
+  uint8_t u8Op;      // eGpioUdsOp_t
+  uint8_t u8Status;  // eGpioUdsStatus_t (reply only)
+  uint16_t u16Handle;
+  uint32_t u32Value; // WRITE/READ: 0/1; CONFIGURE: direction | pull << 8
+  uint32_t u32Seq;   // Echoed in the reply
+} sGpioUdsMsg_t;
+
+/**
+ * @brief CONFIGURE request: header + NUL-padded pin name
+ */
+typedef struct {
+  sGpioUdsMsg_t sHdr;
+  char acName[GPIO_UDS_MAX_PIN_NAME_LEN];
+} sGpioUdsConfigureMsg_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPIO_LIB_UDS_PROTOCOL_H
@@ -0,0 +1,483 @@
+//==============================================================================
+// Line Transport (PC) - stdin / TCP / pseudo-terminal "UART"
+//------------------------------------------------------------------------------
+//! @file
+//! @brief epoll-driven line I/O standing in for the MCU UART on PC builds
+//------------------------------------------------------------------------------
+
+#ifdef __linux__
+#define _GNU_SOURCE // fopencookie, ptsname, accept4
+#endif
+
+// Includes ====================================================================
+#include "line_transport.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+
+// Constants ===================================================================
+#define LT_RX_BUFFER_SIZE (LINE_TRANSPORT_MAX_LINE * 4)
+#define LT_MAX_EVENTS 4
+
+// Type Definitions ============================================================
+typedef enum { LT_MODE_STDIN, LT_MODE_TCP, LT_MODE_PTY } eLtMode_t;
+
+// Static Variables ============================================================
+static bool g_bLtOpen = false;
+static eLtMode_t g_eLtMode = LT_MODE_STDIN;
+static int g_iLtEpollFd = -1;
+static int g_iLtListenFd = -1;   // TCP only
+static int g_iLtPtySlaveFd = -1; // Held open so the master never sees EOF
+static int g_iLtInFd = -1;       // Current input (stdin, client, PTY master)
+static int g_iLtOutFd = -1;      // Current output (-1 = no peer)
+static bool g_bLtWantWrite = false;
+static bool g_bLtInNoEpoll = false; // stdin redirected from a regular file
+
+static char g_acLtRx[LT_RX_BUFFER_SIZE];
+static uint32_t g_u32LtRxLen = 0;
+static bool g_bLtRxDiscard = false; // Dropping an over-long line
+static bool g_bLtRxInFrame = false; // Buffer starts inside a 0x00 frame
+
+static char g_acLtTx[LINE_TRANSPORT_TX_SIZE];
+static uint32_t g_u32LtTxLen = 0;
+static uint32_t g_u32LtDropped = 0;
+static uint32_t g_u32LtRxOverruns = 0; // Over-long lines dropped
+
+// Private Function Prototypes ================================================
+static void vLt_Watch(int iFd, uint32_t u32Events, bool bAdd);
+static void vLt_Flush(void);
+static void vLt_ClosePeer(void);
+static void vLt_Accept(void);
+static void vLt_Read(void);
+static bool bLt_FindEnd(bool *pbFrame, uint32_t *pu32End);
+static bool bLt_HasLine(void);
+static ssize_t iLt_CookieWrite(void *pvCookie, const char *pcBuf,
+                               size_t u32Size);
+static bool bLt_OpenTcp(const char *pcPort);
+static bool bLt_OpenPty(const char *pcLink);
+
+// Functions ===================================================================
+
+eRetType_t eLineTransportInit(const char *pcSpec) {
+  if (g_bLtOpen) {
+    return RET_TYPE_ALREADY_EXISTS;
+  }
+  if (pcSpec == NULL) {
+    pcSpec = getenv(LINE_TRANSPORT_ENV);
+  }
+  if (pcSpec == NULL || pcSpec[0] == '\0') {
+    pcSpec = "stdin";
+  }
+
+  g_iLtEpollFd = epoll_create1(EPOLL_CLOEXEC);
+  if (g_iLtEpollFd < 0) {
+    return RET_TYPE_FAIL;
+  }
+
+  bool bOk;
+  if (strcmp(pcSpec, "stdin") == 0) {
+    g_eLtMode = LT_MODE_STDIN;
+    g_iLtInFd = STDIN_FILENO;
+    g_iLtOutFd = -1; // Responses use the process stdout as is
+    struct epoll_event sEv = {.events = EPOLLIN, .data.fd = g_iLtInFd};
+    if (epoll_ctl(g_iLtEpollFd, EPOLL_CTL_ADD, g_iLtInFd, &sEv) != 0) {
+      g_bLtInNoEpoll = (errno == EPERM); // Files are always readable
+    }
+    bOk = true;
+  } else if (strncmp(pcSpec, "tcp:", 4) == 0) {
+    g_eLtMode = LT_MODE_TCP;
+    bOk = bLt_OpenTcp(pcSpec + 4);
+  } else if (strncmp(pcSpec, "pty", 3) == 0 &&
+             (pcSpec[3] == '\0' || pcSpec[3] == ':')) {
+    g_eLtMode = LT_MODE_PTY;
+    bOk = bLt_OpenPty((pcSpec[3] == ':') ? pcSpec + 4 : NULL);
+  } else {
+    fprintf(stderr, "[LINE] [ERROR] Unknown transport '%s'\n", pcSpec);
+    close(g_iLtEpollFd);
+    g_iLtEpollFd = -1;
+    return RET_TYPE_INVALID_PARAMETER;
+  }
+
+  if (!bOk) {
+    close(g_iLtEpollFd);
+    g_iLtEpollFd = -1;
+    return RET_TYPE_FAIL;
+  }
+
+  if (g_eLtMode != LT_MODE_STDIN) {
+    // Bind stdout to the transport, like the AVR adapter binds it to UART0
+    cookie_io_functions_t sIo = {.write = iLt_CookieWrite};
+    FILE *psStream = fopencookie(NULL, "w", sIo);
+    if (psStream != NULL) {
+      setvbuf(psStream, NULL, _IOLBF, LINE_TRANSPORT_MAX_LINE);
+      fflush(stdout);
+      stdout = psStream;
+    }
+  }
+
+  g_bLtOpen = true;
+  return RET_TYPE_SUCCESS;
+}
+
+bool bLineTransportPoll(int iTimeoutMs) {
+  if (!g_bLtOpen) {
+    return false;
+  }
+  if (bLt_HasLine()) {
+    iTimeoutMs = 0; // Still service I/O, but do not wait
+  }
+
+  if (g_bLtInNoEpoll && g_iLtInFd >= 0) {
+    vLt_Read();
+    return bLt_HasLine();
+  }
+
+  struct epoll_event asEvents[LT_MAX_EVENTS];
+  int iCount = epoll_wait(g_iLtEpollFd, asEvents, LT_MAX_EVENTS, iTimeoutMs);
+  for (int i = 0; i < iCount; i++) {
+    int iFd = asEvents[i].data.fd;
+    if (iFd == g_iLtListenFd) {
+      vLt_Accept();
+      continue;
+    }
+    if (iFd != g_iLtInFd) {
+      continue; // Peer replaced earlier in this batch
+    }
+    if (asEvents[i].events & EPOLLOUT) {
+      vLt_Flush();
+    }
+    if (asEvents[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+      vLt_Read();
+    }
+  }
+  return bLt_HasLine();
+}
+
+bool bLineTransportNextMessage(char *pcBuf, uint32_t u32Size,
+                                uint32_t *pu32Len, bool *pbFrame) {
+  if (pcBuf == NULL || u32Size == 0 || pu32Len == NULL || pbFrame == NULL) {
+    return false;
+  }
+
+  for (;;) {
+    bool bFrame = g_bLtRxInFrame;
+    uint32_t u32End = 0;
+    if (!bLt_FindEnd(&bFrame, &u32End)) {
+      return false;
+    }
+
+    // bFrame is the mode after the terminator; a 0x00 while in text mode
+    // opens a frame and drops the partial line before it
+    bool bWasFrame = g_bLtRxInFrame;
+    bool bOpensFrame = !bWasFrame && bFrame;
+    uint32_t u32Len = u32End;
+    // Longer than the caller's buffer: dropped whole, never run cut short
+    bool bTooLong = !bOpensFrame && u32Len >= u32Size;
+    if (bTooLong) {
+      g_u32LtRxOverruns++;
+    } else if (!bOpensFrame) {
+      memcpy(pcBuf, g_acLtRx, u32Len);
+      pcBuf[u32Len] = '\0';
+    }
+
+    g_u32LtRxLen -= u32End + 1;
+    memmove(g_acLtRx, g_acLtRx + u32End + 1, g_u32LtRxLen);
+    g_bLtRxInFrame = bFrame;
+    if (!bOpensFrame && !bTooLong && u32Len > 0) {
+      *pu32Len = u32Len;
+      *pbFrame = bWasFrame;
+      return true; // Skips the empty half of "\r\n" and "00 00"
+    }
+  }
+}
+
+bool bLineTransportIsOpen(void) { return g_bLtOpen; }
+
+uint32_t u32LineTransportDroppedBytes(void) { return g_u32LtDropped; }
+
+uint32_t u32LineTransportRxOverruns(void) { return g_u32LtRxOverruns; }
+
+// Private Functions ===========================================================
+
+static void vLt_Watch(int iFd, uint32_t u32Events, bool bAdd) {
+  struct epoll_event sEv = {.events = u32Events, .data.fd = iFd};
+  epoll_ctl(g_iLtEpollFd, bAdd ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, iFd, &sEv);
+}
+
+/**
+ * @brief Find the next terminator from the start of the RX buffer
+ *
+ * Text mode ends at '\n', '\r' or a 0x00 (which opens a frame); frame mode
+ * ends only at 0x00. *pbFrame is the mode at the start on entry and the mode
+ * after the terminator on return.
+ */
+static bool bLt_FindEnd(bool *pbFrame, uint32_t *pu32End) {
+  for (uint32_t i = 0; i < g_u32LtRxLen; i++) {
+    char c = g_acLtRx[i];
+    if (c == '\0') {
+      *pbFrame = !*pbFrame || i == 0; // "00 00": closing, then opening
+      *pu32End = i;
+      return true;
+    }
+    if (!*pbFrame && (c == '\n' || c == '\r')) {
+      *pu32End = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool bLt_HasLine(void) {
+  // Any terminator: the next NextMessage() call consumes something
+  bool bFrame = g_bLtRxInFrame;
+  uint32_t u32End = 0;
+  return bLt_FindEnd(&bFrame, &u32End);
+}
+
+/**
+ * @brief Write as much buffered output as the peer accepts right now
+ */
+static void vLt_Flush(void) {
+  uint32_t u32Sent = 0;
+  while (g_iLtOutFd >= 0 && u32Sent < g_u32LtTxLen) {
+    ssize_t iWritten =
+        write(g_iLtOutFd, g_acLtTx + u32Sent, g_u32LtTxLen - u32Sent);
+    if (iWritten > 0) {
+      u32Sent += (uint32_t)iWritten;
+      continue;
+    }
+    if (iWritten < 0 && errno == EINTR) {
+      continue;
+    }
+    if (iWritten < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+      vLt_ClosePeer();
+      return;
+    }
+    break; // Peer is slow: keep the rest for EPOLLOUT
+  }
+
+  g_u32LtTxLen -= u32Sent;
+  memmove(g_acLtTx, g_acLtTx + u32Sent, g_u32LtTxLen);
+
+  bool bWantWrite = (g_u32LtTxLen > 0 && g_iLtOutFd >= 0);
+  if (bWantWrite != g_bLtWantWrite && g_iLtInFd >= 0) {
+    vLt_Watch(g_iLtInFd, bWantWrite ? (EPOLLIN | EPOLLOUT) : EPOLLIN, false);
+    g_bLtWantWrite = bWantWrite;
+  }
+}
+
+/**
+ * @brief stdout sink for tcp/pty: append and drain, never block the firmware
+ */
+static ssize_t iLt_CookieWrite(void *pvCookie, const char *pcBuf,
+                               size_t u32Size) {
+  (void)pvCookie;
+  if (g_iLtOutFd < 0) {
+    return (ssize_t)u32Size; // No peer: output goes nowhere, like a UART
+  }
+
+  size_t u32Space = sizeof(g_acLtTx) - g_u32LtTxLen;
+  size_t u32Copy = (u32Size < u32Space) ? u32Size : u32Space;
+  memcpy(g_acLtTx + g_u32LtTxLen, pcBuf, u32Copy);
+  g_u32LtTxLen += (uint32_t)u32Copy;
+  g_u32LtDropped += (uint32_t)(u32Size - u32Copy);
+
+  vLt_Flush();
+  return (ssize_t)u32Size;
+}
+
+static void vLt_ClosePeer(void) {
+  if (g_eLtMode == LT_MODE_TCP && g_iLtInFd >= 0) {
+    epoll_ctl(g_iLtEpollFd, EPOLL_CTL_DEL, g_iLtInFd, NULL);
+    close(g_iLtInFd);
+    g_iLtInFd = -1;
+    g_iLtOutFd = -1;
+  } else if (g_eLtMode == LT_MODE_STDIN && g_iLtInFd >= 0) {
+    if (!g_bLtInNoEpoll) {
+      epoll_ctl(g_iLtEpollFd, EPOLL_CTL_DEL, g_iLtInFd, NULL);
+    }
+    g_iLtInFd = -1; // stdin at EOF: keep running with no input
+    return; // Lines already read are still dispatched
+  }
+  g_u32LtTxLen = 0;
+  g_u32LtRxLen = 0;
+  g_bLtRxDiscard = false;
+  g_bLtRxInFrame = false;
+  g_bLtWantWrite = false;
+}
+
+static void vLt_Accept(void) {
+  int iFd = accept4(g_iLtListenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+  if (iFd < 0) {
+    return;
+  }
+  vLt_ClosePeer(); // Newest client wins (host tool reconnected)
+
+  int iOne = 1;
+  setsockopt(iFd, IPPROTO_TCP, TCP_NODELAY, &iOne, sizeof(iOne));
+  g_iLtInFd = iFd;
+  g_iLtOutFd = iFd;
+  vLt_Watch(iFd, EPOLLIN, true);
+}
+
+static void vLt_Read(void) {
+  for (;;) {
+    if (g_u32LtRxLen == sizeof(g_acLtRx)) {
+      if (bLt_HasLine()) {
+        return; // Let the main loop drain complete lines first
+      }
+      g_u32LtRxLen = 0; // Over-long line: drop it up to its terminator
+      g_bLtRxDiscard = true;
+      g_u32LtRxOverruns++;
+    }
+
+    ssize_t iRead = read(g_iLtInFd, g_acLtRx + g_u32LtRxLen,
+                         sizeof(g_acLtRx) - g_u32LtRxLen);
+    if (iRead > 0) {
+      uint32_t u32Start = g_u32LtRxLen;
+      g_u32LtRxLen += (uint32_t)iRead;
+      if (g_bLtRxDiscard) {
+        // Up to '\n' for a line, 0x00 for a frame (or a frame opening)
+        char *pcEnd = memchr(g_acLtRx + u32Start, '\0', (size_t)iRead);
+        char *pcNl = g_bLtRxInFrame
+                         ? NULL
+                         : memchr(g_acLtRx + u32Start, '\n', (size_t)iRead);
+        if (pcNl != NULL && (pcEnd == NULL || pcNl < pcEnd)) {
+          pcEnd = pcNl;
+        } else if (pcEnd != NULL) {
+          g_bLtRxInFrame = !g_bLtRxInFrame;
+        }
+        if (pcEnd == NULL) {
+          g_u32LtRxLen = 0;
+          return;
+        }
+        g_u32LtRxLen -= (uint32_t)(pcEnd + 1 - g_acLtRx);
+        memmove(g_acLtRx, pcEnd + 1, g_u32LtRxLen);
+        g_bLtRxDiscard = false;
+      }
+      return; // Level-triggered: epoll reports the fd again if more is queued
+    }
+    if (iRead < 0 && errno == EINTR) {
+      continue;
+    }
+    if (iRead < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return;
+    }
+    if (g_eLtMode != LT_MODE_PTY) {
+      vLt_ClosePeer(); // EOF / reset
+    }
+    return;
+  }
+}
+
+static bool bLt_OpenTcp(const char *pcPort) {
+  int iPort = atoi(pcPort);
+  if (iPort <= 0 || iPort > 65535) {
+    fprintf(stderr, "[LINE] [ERROR] Bad TCP port '%s'\n", pcPort);
+    return false;
+  }
+
+  g_iLtListenFd =
+      socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (g_iLtListenFd < 0) {
+    return false;
+  }
+  int iOne = 1;
+  setsockopt(g_iLtListenFd, SOL_SOCKET, SO_REUSEADDR, &iOne, sizeof(iOne));
+
+  struct sockaddr_in sAddr;
+  memset(&sAddr, 0, sizeof(sAddr));
+  sAddr.sin_family = AF_INET;
+  sAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  sAddr.sin_port = htons((uint16_t)iPort);
+  if (bind(g_iLtListenFd, (struct sockaddr *)&sAddr, sizeof(sAddr)) != 0 ||
+      listen(g_iLtListenFd, 1) != 0) {
+    fprintf(stderr, "[LINE] [ERROR] Cannot listen on 127.0.0.1:%d: %s\n",
+            iPort, strerror(errno));
+    close(g_iLtListenFd);
+    g_iLtListenFd = -1;
+    return false;
+  }
+
+  vLt_Watch(g_iLtListenFd, EPOLLIN, true);
+  fprintf(stderr, "[LINE] Listening on tcp://127.0.0.1:%d\n", iPort);
+  return true;
+}
+
+static bool bLt_OpenPty(const char *pcLink) {
+  int iMaster = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+  if (iMaster < 0 || grantpt(iMaster) != 0 || unlockpt(iMaster) != 0) {
+    fprintf(stderr, "[LINE] [ERROR] Cannot create PTY: %s\n", strerror(errno));
+    if (iMaster >= 0) {
+      close(iMaster);
+    }
+    return false;
+  }
+
+  const char *pcSlave = ptsname(iMaster);
+  g_iLtPtySlaveFd = open(pcSlave, O_RDWR | O_NOCTTY | O_CLOEXEC);
+  if (g_iLtPtySlaveFd >= 0) {
+    // Raw mode: no echo, no line discipline, like a serial port
+    struct termios sTio;
+    if (tcgetattr(g_iLtPtySlaveFd, &sTio) == 0) {
+      cfmakeraw(&sTio);
+      tcsetattr(g_iLtPtySlaveFd, TCSANOW, &sTio);
+    }
+  }
+  fcntl(iMaster, F_SETFL, fcntl(iMaster, F_GETFL) | O_NONBLOCK);
+
+  if (pcLink != NULL && pcLink[0] != '\0') {
+    unlink(pcLink);
+    if (symlink(pcSlave, pcLink) != 0) {
+      fprintf(stderr, "[LINE] [WARNING] Cannot link %s: %s\n", pcLink,
+              strerror(errno));
+    }
+  }
+
+  g_iLtInFd = iMaster;
+  g_iLtOutFd = iMaster;
+  vLt_Watch(iMaster, EPOLLIN, true);
+  fprintf(stderr, "[LINE] PTY ready: %s%s%s\n", pcSlave,
+          (pcLink != NULL) ? " -> " : "", (pcLink != NULL) ? pcLink : "");
+  return true;
+}
+
+#else // Non-Linux hosts: no transport; the firmware runs without a UART
+
+eRetType_t eLineTransportInit(const char *pcSpec) {
+  (void)pcSpec;
+  return RET_TYPE_NOT_AVAILABLE;
+}
+
+bool bLineTransportPoll(int iTimeoutMs) {
+  (void)iTimeoutMs;
+  return false;
+}
+
+bool bLineTransportNextMessage(char *pcBuf, uint32_t u32Size,
+                                uint32_t *pu32Len, bool *pbFrame) {
+  (void)pcBuf;
+  (void)u32Size;
+  (void)pu32Len;
+  (void)pbFrame;
+  return false;
+}
+
+bool bLineTransportIsOpen(void) { return false; }
+
+uint32_t u32LineTransportDroppedBytes(void) { return 0; }
+
+uint32_t u32LineTransportRxOverruns(void) { return 0; }
+
+#endif // __linux__
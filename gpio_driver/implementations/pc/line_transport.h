@@ -0,0 +1,86 @@
+//==============================================================================
+// Line Transport (PC) - stdin / TCP / pseudo-terminal "UART"
+//------------------------------------------------------------------------------
+//! @file
+//! @brief epoll-driven line I/O standing in for the MCU UART on PC builds
+//!
+//! Selected with GPIO_LINE_TRANSPORT (default "stdin"):
+//!   stdin            read lines from stdin, respond on stdout
+//!   tcp:<port>       one client at a time on 127.0.0.1:<port> (newest wins)
+//!   pty[:<link>]     create a pseudo-terminal, optionally symlinked to <link>
+//!                    (e.g. pty:/tmp/ttyHAL) so host tools open it like a
+//!                    serial port
+//!
+//! Bytes between two 0x00 delimiters are a binary frame rather than a line
+//! (see hal_embedded_mcp/mcu/common/mcp_frame.h); '\n' inside one is data.
+//!
+//! For tcp/pty, stdout is rebound to the transport (as the AVR adapter binds
+//! it to UART0); writes are buffered and drained without blocking. Logs stay
+//! on stderr.
+//------------------------------------------------------------------------------
+
+#ifndef LINE_TRANSPORT_H
+#define LINE_TRANSPORT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Includes ====================================================================
+#include "common.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Constants ===================================================================
+#define LINE_TRANSPORT_ENV "GPIO_LINE_TRANSPORT"
+#define LINE_TRANSPORT_MAX_LINE 256
+#define LINE_TRANSPORT_TX_SIZE 16384
+
+// Function Prototypes =========================================================
+
+/**
+ * @brief Open the transport described by pcSpec (NULL = env or "stdin")
+ * @return RET_TYPE_ALREADY_EXISTS if open, RET_TYPE_INVALID_PARAMETER for an
+ *         unknown spec, RET_TYPE_FAIL if the socket/PTY cannot be created
+ */
+eRetType_t eLineTransportInit(const char *pcSpec);
+
+/**
+ * @brief Wait up to iTimeoutMs for I/O; returns early once a line is pending
+ * @return true if at least one complete line is buffered
+ */
+bool bLineTransportPoll(int iTimeoutMs);
+
+/**
+ * @brief Pop the next complete line (without terminator, NUL-terminated) or
+ *        binary frame (COBS bytes between the 0x00 delimiters)
+ * @param pu32Len Bytes stored, excluding the NUL
+ * @param pbFrame true for a binary frame
+ * @return false if nothing complete is buffered. A message that does not fit
+ *         u32Size with its NUL is dropped (u32LineTransportRxOverruns).
+ */
+bool bLineTransportNextMessage(char *pcBuf, uint32_t u32Size,
+                                uint32_t *pu32Len, bool *pbFrame);
+
+/**
+ * @brief Whether eLineTransportInit() succeeded
+ */
+bool bLineTransportIsOpen(void);
+
+/**
+ * @brief Bytes dropped because the peer stopped reading (TX buffer full)
+ */
+uint32_t u32LineTransportDroppedBytes(void);
+
+/**
+ * @brief Received lines dropped for not fitting the RX buffer or the
+ *        caller's (bLineTransportNextMessage). Nothing else is lost on
+ *        input: a full buffer stops reading and the peer waits.
+ */
+uint32_t u32LineTransportRxOverruns(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LINE_TRANSPORT_H
@@ -1,17 +1,50 @@
 // ==============================================================================
-// Platform Adapter - PC (Windows/HTTP)
+// Platform Adapter - PC (Windows/HTTP/UDS/SHM/Linux GPIO)
 // ==============================================================================
 // Connects the universal app_main.c to the PC-specific GPIO implementations
 // ==============================================================================
 
+#ifndef _WIN32
+#define _DEFAULT_SOURCE // usleep/clock_gettime under -std=c99
+#endif
+
 #include "gpioLib.h"
 #include <stdint.h>
 
+#ifdef PLATFORM_LINE_TRANSPORT
+#include "config/gpio_config.h" // HAL names by pin handle
+#include "helpers/gpio_helper.h"
+#include "line_transport.h"
+#include "uart_line_callback.h"
+#include <stdio.h>
+#endif
+
+#ifdef PLATFORM_VIRTUAL_TIME
+#include "virtual_time.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#elif !defined(_WIN32)
+#include <time.h> // For clock_gettime
+#endif
+
 // Platform-Specific Includes
 #if defined(PLATFORM_WINDOWS)
 #include "gpioLib_windows.h"
 #include <windows.h>
 
+#elif defined(PLATFORM_UDS)
+#include "gpioLib_uds.h"
+#include <unistd.h> // For usleep
+
+#elif defined(PLATFORM_SHM)
+#include "gpioLib_shm.h"
+#include <unistd.h> // For usleep
+
+#elif defined(PLATFORM_LINUX_GPIO)
+#include "gpioLib_linux.h"
+#include <unistd.h> // For usleep
+
 #else // Default to HTTP
 #ifdef _WIN32
 #include <windows.h> // For Sleep
@@ -28,12 +61,55 @@
 const sGpioInterface_t *psGetPlatformGpioInterface(void) {
 #if defined(PLATFORM_WINDOWS)
   return &sGpioInterfaceWindows;
+#elif defined(PLATFORM_UDS)
+  return &sGpioInterfaceUDS;
+#elif defined(PLATFORM_SHM)
+  return &sGpioInterfaceSHM;
+#elif defined(PLATFORM_LINUX_GPIO)
+  return &sGpioInterfaceLinux;
 #else
   return &sGpioInterfaceHTTP;
 #endif
 }
 
+#ifdef PLATFORM_VIRTUAL_TIME
+// Virtual time: delays advance the simulated clock instantly and fire any
+// events scheduled in between. GPIO_VIRTUAL_TIME_LIMIT_MS ends the process
+// once that much simulated time has elapsed (soak/regression runs).
+static void vPlatformCheckTimeLimit(void) {
+  static bool bLimitRead = false;
+  static uint64_t u64LimitUs = 0;
+  if (!bLimitRead) {
+    const char *pcLimit = getenv("GPIO_VIRTUAL_TIME_LIMIT_MS");
+    u64LimitUs = (pcLimit != NULL) ? strtoull(pcLimit, NULL, 10) * 1000u : 0;
+    bLimitRead = true;
+  }
+  if (u64LimitUs != 0 && u64VirtualTimeNowUs() >= u64LimitUs) {
+    printf("[VTIME] Limit of %llu ms virtual time reached.\n",
+           (unsigned long long)(u64LimitUs / 1000u));
+    fflush(stdout);
+    exit(0);
+  }
+}
+
+void vPlatformDelayMs(uint32_t u32Ms) {
+  vVirtualTimeAdvanceUs((uint64_t)u32Ms * 1000u);
+  vPlatformCheckTimeLimit();
+}
+
+uint32_t u32PlatformGetTickMs(void) {
+  return (uint32_t)(u64VirtualTimeNowUs() / 1000u);
+}
+#else
 void vPlatformDelayMs(uint32_t u32Ms) {
+#ifdef PLATFORM_LINE_TRANSPORT
+  // Sleep in the transport's event loop: a received line ends the delay
+  // early, so command latency is not bounded by the main loop period
+  if (bLineTransportIsOpen()) {
+    (void)bLineTransportPoll((int)u32Ms);
+    return;
+  }
+#endif
 #ifdef _WIN32
   Sleep(u32Ms);
 #else
@@ -41,6 +117,128 @@ void vPlatformDelayMs(uint32_t u32Ms) {
 #endif
 }
 
+uint32_t u32PlatformGetTickMs(void) {
+#ifdef _WIN32
+  return (uint32_t)GetTickCount();
+#else
+  struct timespec sNow;
+  clock_gettime(CLOCK_MONOTONIC, &sNow);
+  return (uint32_t)((uint64_t)sNow.tv_sec * 1000u +
+                    (uint64_t)sNow.tv_nsec / 1000000u);
+#endif
+}
+#endif
+
+#ifdef PLATFORM_LINE_TRANSPORT
+// ==============================================================================
+// UART Line Handling (stdin / TCP / PTY, see line_transport.h)
+// ==============================================================================
+
+/** Twin input level of a pin. The simulator backends own input levels, so
+ *  it goes through the HAL. */
+void vPlatformApplyDtPin(uint32_t u32Pin, bool bValue) {
+  const sGpioInterface_t *psGpio = psHalGetGpioInterface();
+  if (psGpio == NULL || psGpio->eHalGpioWriteFunc == NULL)
+    return;
+  const char *pcPin = g_psGpioPinConfigs[u32Pin].pcPinName;
+  eRetType_t eRet = psGpio->eHalGpioWriteFunc(pcPin, bValue);
+  if (eRet != RET_TYPE_SUCCESS) {
+    fprintf(stderr, "[GPIO PC] [ERROR] DT inject %s failed (%d)\n", pcPin,
+            (int)eRet);
+  }
+}
+
+void vApplyReceivedJsonLine(const char *pcLine) {
+  (void)bGpioHelperParseDtLine(pcLine, vPlatformApplyDtPin);
+}
+
+/* Transport buffer refills per call: reading on past a twin flood reaches
+ * the commands queued behind it, without letting the flood hold the loop */
+#define PC_RX_REFILLS 4
+
+/* Digital Twin lines read in one call are parsed as they arrive and wait
+ * here, as the newest level of each pin they name, while the commands read
+ * with them run first. A flood on some pins never loses another pin's line. */
+static uint8_t g_au8PcDtMask[GPIO_HELPER_MAX_PINS / 8];  // Pins pending
+static uint8_t g_au8PcDtLevel[GPIO_HELPER_MAX_PINS / 8]; // Their levels
+
+static void vPcNoteDtPin(uint32_t u32Pin, bool bValue) {
+  if (u32Pin >= GPIO_HELPER_MAX_PINS)
+    return;
+  uint8_t u8Bit = (uint8_t)(1u << (u32Pin & 7));
+  g_au8PcDtMask[u32Pin >> 3] |= u8Bit;
+  if (bValue)
+    g_au8PcDtLevel[u32Pin >> 3] |= u8Bit;
+  else
+    g_au8PcDtLevel[u32Pin >> 3] &= (uint8_t)~u8Bit;
+}
+
+bool bUartDispatchPendingLine(void) {
+  static bool bInitTried = false;
+  if (!bInitTried) {
+    bInitTried = true;
+    if (eLineTransportInit(NULL) != RET_TYPE_SUCCESS) {
+      fprintf(stderr, "[GPIO PC] [ERROR] Line transport unavailable\n");
+    }
+  }
+
+  char acLine[LINE_TRANSPORT_MAX_LINE];
+  uint32_t u32Len = 0;
+  bool bFrame = false;
+  bool bAny = false;
+  for (uint32_t u32Refill = 0;
+       u32Refill < PC_RX_REFILLS && bLineTransportPoll(0); u32Refill++) {
+    while (bLineTransportNextMessage(acLine, sizeof(acLine), &u32Len,
+                                     &bFrame)) {
+      if (bFrame)
+        vOnUartFrameReceived((const uint8_t *)acLine, (uint16_t)u32Len);
+      else if (acLine[0] == '{')
+        (void)bGpioHelperParseDtLine(acLine, vPcNoteDtPin);
+      else
+        vOnUartLineReceived(acLine);
+      bAny = true;
+    }
+  }
+  for (uint32_t u32Pin = 0; u32Pin < GPIO_HELPER_MAX_PINS; u32Pin++) {
+    uint8_t u8Bit = (uint8_t)(1u << (u32Pin & 7));
+    if (g_au8PcDtMask[u32Pin >> 3] & u8Bit) {
+      g_au8PcDtMask[u32Pin >> 3] &= (uint8_t)~u8Bit;
+      vPlatformApplyDtPin(u32Pin, (g_au8PcDtLevel[u32Pin >> 3] & u8Bit) != 0);
+    }
+  }
+  fflush(stdout); // Responses leave now, not when the buffer fills
+  return bAny;
+}
+
+static bool g_bUartFramed = false; // Host asked for "proto cobs"
+
+void vUartSetFramed(bool bFramed) { g_bUartFramed = bFramed; }
+
+bool bUartIsFramed(void) { return g_bUartFramed; }
+
+/* The transport stops reading while its buffer is full and the kernel holds
+ * the rest, so the host needs no window; only over-long lines are lost */
+void vUartGetRxFlow(uint8_t *pu8Slots, uint8_t *pu8Free,
+                    uint32_t *pu32Overruns) {
+  *pu8Slots = UART_RX_SLOTS_UNBOUNDED;
+  *pu8Free = UART_RX_SLOTS_UNBOUNDED;
+  *pu32Overruns = u32LineTransportRxOverruns();
+}
+
+uint32_t u32UartTakeRxOverruns(void) {
+  static uint32_t u32Taken = 0;
+  uint32_t u32Total = u32LineTransportRxOverruns();
+  uint32_t u32New = u32Total - u32Taken;
+  u32Taken = u32Total;
+  return u32New;
+}
+
+/* Binary frames share stdout with the text responses, so they stay in order */
+void vUartWriteRaw(const uint8_t *pu8Data, uint16_t u16Len) {
+  fwrite(pu8Data, 1, u16Len, stdout);
+}
+#endif
+
 // ==============================================================================
 // Helper / Digital Twin Bridge Implementation
 // ==============================================================================
@@ -49,14 +247,29 @@ void vPlatformDelayMs(uint32_t u32Ms) {
 #include <stdio.h>
 
 void vHelperSend(const char *pcCmd, const char *pcPin, int iValue) {
-  // On PC/HTTP platform, the low-level driver (gpioLib_http) handles
-  // synchronization with the simulator directly via HTTP.
+  // On PC/HTTP, PC/UDS and PC/SHM platforms, the low-level driver handles
+  // synchronization with the simulator directly.
   // We can just log here for debugging purposes.
   // printf("[Bridge Mock] {\"t\":\"%s\",\"p\":\"%s\",\"v\":%d}\n", pcCmd,
   // pcPin, iValue);
+  (void)pcCmd;
+  (void)pcPin;
+  (void)iValue;
+}
+
+void vHelperSendMany(const char *pcCmd, const char *const *ppcPins,
+                     const int *piValues, uint32_t u32Count) {
+  // Driver already synchronized every pin (see vHelperSend)
+  (void)pcCmd;
+  (void)ppcPins;
+  (void)piValues;
+  (void)u32Count;
 }
 
 void vHelperSendString(const char *pcCmd, const char *pcPin,
                        const char *pcValue) {
   // Mock implementation
+  (void)pcCmd;
+  (void)pcPin;
+  (void)pcValue;
 }
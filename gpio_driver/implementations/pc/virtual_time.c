@@ -0,0 +1,179 @@
+//==============================================================================
+// Virtual Time - Discrete-Event Clock for PC Builds
+//------------------------------------------------------------------------------
+//! @file
+//! @brief Virtual clock with a binary min-heap event queue
+//------------------------------------------------------------------------------
+
+// Includes ====================================================================
+#include "virtual_time.h"
+#include <stddef.h>
+
+// Type Definitions ============================================================
+typedef struct {
+  uint64_t u64AtUs;
+  uint32_t u32Seq; // Schedule order: breaks ties so equal times stay FIFO
+  uint32_t u32Id;
+  pfVirtualTimeEvent_t pfEvent;
+  void *pvContext;
+} sVirtualTimeEvent_t;
+
+// Static Variables ============================================================
+static uint64_t g_u64VirtualNowUs = 0;
+static sVirtualTimeEvent_t g_asVirtualEvents[VIRTUAL_TIME_MAX_EVENTS];
+static uint32_t g_u32VirtualEventCount = 0;
+static uint32_t g_u32VirtualSeq = 0;
+static uint32_t g_u32VirtualNextId = 1;
+
+// Private Function Prototypes ================================================
+static bool bVT_Before(const sVirtualTimeEvent_t *psA,
+                       const sVirtualTimeEvent_t *psB);
+static void vVT_SiftUp(uint32_t u32Index);
+static void vVT_SiftDown(uint32_t u32Index);
+static void vVT_RemoveAt(uint32_t u32Index);
+
+// Functions ===================================================================
+
+void vVirtualTimeReset(void) {
+  g_u64VirtualNowUs = 0;
+  g_u32VirtualEventCount = 0;
+  g_u32VirtualSeq = 0;
+}
+
+uint64_t u64VirtualTimeNowUs(void) { return g_u64VirtualNowUs; }
+
+eRetType_t eVirtualTimeScheduleAt(uint64_t u64AtUs,
+                                  pfVirtualTimeEvent_t pfEvent,
+                                  void *pvContext, uint32_t *pu32Id) {
+  if (pfEvent == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+  if (g_u32VirtualEventCount >= VIRTUAL_TIME_MAX_EVENTS) {
+    return RET_TYPE_MEMORY_ERROR;
+  }
+
+  sVirtualTimeEvent_t *psEvent = &g_asVirtualEvents[g_u32VirtualEventCount];
+  psEvent->u64AtUs =
+      (u64AtUs < g_u64VirtualNowUs) ? g_u64VirtualNowUs : u64AtUs;
+  psEvent->u32Seq = g_u32VirtualSeq++;
+  psEvent->u32Id = g_u32VirtualNextId++;
+  psEvent->pfEvent = pfEvent;
+  psEvent->pvContext = pvContext;
+  if (pu32Id != NULL) {
+    *pu32Id = psEvent->u32Id;
+  }
+
+  vVT_SiftUp(g_u32VirtualEventCount++);
+  return RET_TYPE_SUCCESS;
+}
+
+eRetType_t eVirtualTimeCancel(uint32_t u32Id) {
+  for (uint32_t i = 0; i < g_u32VirtualEventCount; i++) {
+    if (g_asVirtualEvents[i].u32Id == u32Id) {
+      vVT_RemoveAt(i);
+      return RET_TYPE_SUCCESS;
+    }
+  }
+  return RET_TYPE_NOT_FOUND;
+}
+
+void vVirtualTimeAdvanceUs(uint64_t u64DeltaUs) {
+  uint64_t u64TargetUs = g_u64VirtualNowUs + u64DeltaUs;
+
+  while (g_u32VirtualEventCount > 0 &&
+         g_asVirtualEvents[0].u64AtUs <= u64TargetUs) {
+    sVirtualTimeEvent_t sEvent = g_asVirtualEvents[0];
+    vVT_RemoveAt(0); // Pop first: the callback may schedule or cancel
+
+    if (sEvent.u64AtUs > g_u64VirtualNowUs) {
+      g_u64VirtualNowUs = sEvent.u64AtUs;
+    }
+    sEvent.pfEvent(sEvent.pvContext);
+  }
+
+  // A callback that itself delayed may already be past the target
+  if (u64TargetUs > g_u64VirtualNowUs) {
+    g_u64VirtualNowUs = u64TargetUs;
+  }
+}
+
+eRetType_t eVirtualTimeRunUntil(uint64_t u64UntilUs, void (*pfStep)(void)) {
+  if (u64UntilUs < g_u64VirtualNowUs) {
+    return RET_TYPE_INVALID_PARAMETER;
+  }
+
+  while (g_u64VirtualNowUs < u64UntilUs) {
+    uint64_t u64BeforeUs = g_u64VirtualNowUs;
+    if (pfStep != NULL) {
+      pfStep();
+    }
+    if (g_u64VirtualNowUs == u64BeforeUs) {
+      // Idle step: skip ahead to the next thing that can happen
+      uint64_t u64NextUs = u64UntilUs;
+      if (g_u32VirtualEventCount > 0 &&
+          g_asVirtualEvents[0].u64AtUs < u64NextUs) {
+        u64NextUs = g_asVirtualEvents[0].u64AtUs;
+      }
+      vVirtualTimeAdvanceUs(u64NextUs - g_u64VirtualNowUs);
+    }
+  }
+  return RET_TYPE_SUCCESS;
+}
+
+// Private Functions ===========================================================
+
+static bool bVT_Before(const sVirtualTimeEvent_t *psA,
+                       const sVirtualTimeEvent_t *psB) {
+  if (psA->u64AtUs != psB->u64AtUs) {
+    return psA->u64AtUs < psB->u64AtUs;
+  }
+  return (int32_t)(psA->u32Seq - psB->u32Seq) < 0;
+}
+
+static void vVT_SiftUp(uint32_t u32Index) {
+  while (u32Index > 0) {
+    uint32_t u32Parent = (u32Index - 1) / 2;
+    if (!bVT_Before(&g_asVirtualEvents[u32Index],
+                    &g_asVirtualEvents[u32Parent])) {
+      break;
+    }
+    sVirtualTimeEvent_t sTmp = g_asVirtualEvents[u32Index];
+    g_asVirtualEvents[u32Index] = g_asVirtualEvents[u32Parent];
+    g_asVirtualEvents[u32Parent] = sTmp;
+    u32Index = u32Parent;
+  }
+}
+
+static void vVT_SiftDown(uint32_t u32Index) {
+  for (;;) {
+    uint32_t u32Left = 2 * u32Index + 1;
+    uint32_t u32Smallest = u32Index;
+    if (u32Left < g_u32VirtualEventCount &&
+        bVT_Before(&g_asVirtualEvents[u32Left],
+                   &g_asVirtualEvents[u32Smallest])) {
+      u32Smallest = u32Left;
+    }
+    if (u32Left + 1 < g_u32VirtualEventCount &&
+        bVT_Before(&g_asVirtualEvents[u32Left + 1],
+                   &g_asVirtualEvents[u32Smallest])) {
+      u32Smallest = u32Left + 1;
+    }
+    if (u32Smallest == u32Index) {
+      return;
+    }
+    sVirtualTimeEvent_t sTmp = g_asVirtualEvents[u32Index];
+    g_asVirtualEvents[u32Index] = g_asVirtualEvents[u32Smallest];
+    g_asVirtualEvents[u32Smallest] = sTmp;
+    u32Index = u32Smallest;
+  }
+}
+
+static void vVT_RemoveAt(uint32_t u32Index) {
+  g_u32VirtualEventCount--;
+  if (u32Index == g_u32VirtualEventCount) {
+    return;
+  }
+  g_asVirtualEvents[u32Index] = g_asVirtualEvents[g_u32VirtualEventCount];
+  vVT_SiftDown(u32Index);
+  vVT_SiftUp(u32Index);
+}
@@ -0,0 +1,82 @@
+//==============================================================================
+// Virtual Time - Discrete-Event Clock for PC Builds
+//------------------------------------------------------------------------------
+//! @file
+//! @brief Simulated time base: delays advance it instantly, scheduled events
+//!        fire in timestamp order
+//!
+//! Built into the PC platform adapter with PLATFORM_VIRTUAL_TIME, so that
+//! vPlatformDelayMs() and u32PlatformGetTickMs() run on this clock instead of
+//! the wall clock. Tests schedule stimuli (e.g. a button press at t = 5 s)
+//! and call eVirtualTimeRunUntil() to execute firmware up to a given time.
+//------------------------------------------------------------------------------
+
+#ifndef VIRTUAL_TIME_H
+#define VIRTUAL_TIME_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Includes ====================================================================
+#include "common.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Constants ===================================================================
+#define VIRTUAL_TIME_MAX_EVENTS 64
+
+// Type Definitions ============================================================
+typedef void (*pfVirtualTimeEvent_t)(void *pvContext);
+
+// Function Prototypes =========================================================
+
+/**
+ * @brief Reset the clock to 0 and drop all pending events
+ */
+void vVirtualTimeReset(void);
+
+/**
+ * @brief Current virtual time in microseconds
+ */
+uint64_t u64VirtualTimeNowUs(void);
+
+/**
+ * @brief Schedule a callback at an absolute virtual time
+ * @param u64AtUs Fire time (clamped to now if in the past)
+ * @param pu32Id Receives an id for eVirtualTimeCancel() (may be NULL)
+ * @return RET_TYPE_MEMORY_ERROR if VIRTUAL_TIME_MAX_EVENTS are pending
+ */
+eRetType_t eVirtualTimeScheduleAt(uint64_t u64AtUs,
+                                  pfVirtualTimeEvent_t pfEvent,
+                                  void *pvContext, uint32_t *pu32Id);
+
+/**
+ * @brief Cancel a pending event
+ * @return RET_TYPE_NOT_FOUND if it already fired or never existed
+ */
+eRetType_t eVirtualTimeCancel(uint32_t u32Id);
+
+/**
+ * @brief Advance the clock, firing due events in (time, schedule) order
+ *
+ * Each callback sees the clock at its own fire time. Callbacks may schedule
+ * further events; those due within the window fire in the same call.
+ */
+void vVirtualTimeAdvanceUs(uint64_t u64DeltaUs);
+
+/**
+ * @brief Run until the clock reaches u64UntilUs
+ *
+ * Calls pfStep (typically vAppLoop, whose delays advance the clock)
+ * repeatedly; when a step does not advance time, or pfStep is NULL, jumps
+ * straight to the next event or to u64UntilUs.
+ * @return RET_TYPE_INVALID_PARAMETER if u64UntilUs is in the past
+ */
+eRetType_t eVirtualTimeRunUntil(uint64_t u64UntilUs, void (*pfStep)(void));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VIRTUAL_TIME_H
@@ -138,6 +138,7 @@ static sPinState_t *psFindPin(const char *pcPinName) {
 // Forward Declarations =======================================================
 eRetType_t eGpioSTM32Configure(const sGpioConfig_t *psConfig);
 eRetType_t eGpioSTM32Read(const char *pcPinName, bool *pbValue);
+eRetType_t eGpioSTM32ReadPin(uint32_t u32Pin, bool *pbValue);
 eRetType_t eGpioSTM32Write(const char *pcPinName, bool bValue);
 
 // Functions ===================================================================
@@ -303,6 +304,26 @@ eRetType_t eGpioSTM32Read(const char *pcPinName, bool *pbValue) {
     return RET_TYPE_FAIL;
   }
 
+  return eGpioSTM32ReadPin((uint32_t)(psPin - g_psPins), pbValue);
+}
+
+/**
+ * @brief Read a GPIO pin state by config index: no name lookup
+ */
+eRetType_t eGpioSTM32ReadPin(uint32_t u32Pin, bool *pbValue) {
+  if (pbValue == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+
+  if (!g_bInitialized) {
+    return RET_TYPE_NOT_INITIALIZED;
+  }
+
+  if (u32Pin >= g_u8PinCount) {
+    return RET_TYPE_INVALID_PARAMETER;
+  }
+  sPinState_t *psPin = &g_psPins[u32Pin];
+
   // Read from STM32 GPIO IDR register using libopencm3
   bool bPinValue = gpio_get(psPin->u32GpioPort, psPin->u16GpioPin) != 0;
   *pbValue = bPinValue;
@@ -349,6 +370,7 @@ const sGpioInterface_t sGpioInterfaceSTM32 = {
     .vHalGpioInitFunc = vGpioSTM32Init,
     .eHalGpioConfigureFunc = eGpioSTM32Configure,
     .eHalGpioReadFunc = eGpioSTM32Read,
-    .eHalGpioWriteFunc = eGpioSTM32Write};
+    .eHalGpioWriteFunc = eGpioSTM32Write,
+    .eHalGpioReadPinFunc = eGpioSTM32ReadPin};
 
 #endif // PLATFORM_STM32
@@ -12,6 +12,7 @@
 // For this example adapter we assume a hypothetical HAL_Delay is available
 // In a real project you might include "main.h" or "stm32f1xx_hal.h"
 extern void HAL_Delay(uint32_t Delay);
+extern uint32_t HAL_GetTick(void); // SysTick, 1 ms
 
 // ==============================================================================
 // Contract Implementation
@@ -23,6 +24,8 @@ const sGpioInterface_t *psGetPlatformGpioInterface(void) {
 
 void vPlatformDelayMs(uint32_t u32Ms) { HAL_Delay(u32Ms); }
 
+uint32_t u32PlatformGetTickMs(void) { return HAL_GetTick(); }
+
 // ==============================================================================
 // Helper / Digital Twin Bridge Implementation
 // ==============================================================================
@@ -37,6 +40,16 @@ void vHelperSend(const char *pcCmd, const char *pcPin, int iValue) {
   printf("{\"t\":\"%s\",\"p\":\"%s\",\"v\":%d}\n", pcCmd, pcPin, iValue);
 }
 
+void vHelperSendMany(const char *pcCmd, const char *const *ppcPins,
+                     const int *piValues, uint32_t u32Count) {
+  // Example: {"t":"GPIO","s":{"LED1":1,"LED2":0}}
+  printf("{\"t\":\"%s\",\"s\":{", pcCmd);
+  for (uint32_t i = 0; i < u32Count; i++) {
+    printf("%s\"%s\":%d", (i > 0) ? "," : "", ppcPins[i], piValues[i]);
+  }
+  printf("}}\n");
+}
+
 void vHelperSendString(const char *pcCmd, const char *pcPin,
                        const char *pcValue) {
   printf("{\"t\":\"%s\",\"p\":\"%s\",\"v\":\"%s\"}\n", pcCmd, pcPin, pcValue);
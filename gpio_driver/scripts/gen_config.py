@@ -62,6 +62,14 @@ def generate_config(json_data):
             c_code += f'        .u8ArduinoPin = {ard["pin"]},\n'
             c_code += "        #endif\n"
 
+        # Linux GPIO character device Config
+        if "linux" in pin:
+            lnx = pin["linux"]
+            c_code += "        #ifdef PLATFORM_LINUX_GPIO\n"
+            c_code += f'        .pcLinuxChip = "{lnx.get("chip", "gpiochip0")}",\n'
+            c_code += f'        .u32LinuxLine = {lnx["line"]},\n'
+            c_code += "        #endif\n"
+
         c_code += "    },\n"
 
     c_code += "    { .pcPinName = NULL } // Terminator\n"
@@ -0,0 +1,54 @@
+#!/bin/sh
+# ==============================================================================
+# GPIO Driver - gpio-sim test chip for the Linux chardev backend
+# Use: sudo ./gpio_sim_setup.sh [up|down|pull <line> <up|down>]
+# ==============================================================================
+# Creates a software GPIO chip with the kernel's gpio-sim module, labelled
+# "gpio-hal-sim" so config.json can refer to it by label regardless of which
+# gpiochipN it gets. Lines 0 and 1 are LED1 and BUTTON1 in the default config.
+# "pull" drives a simulated input, which also produces an edge event.
+# ==============================================================================
+
+set -e
+
+LABEL="gpio-hal-sim"
+NUM_LINES=8
+CONFIGFS=/sys/kernel/config
+SIM_DIR="$CONFIGFS/gpio-sim/gpio_hal"
+
+sim_sysfs_dir() {
+    DEV=$(cat "$SIM_DIR/dev_name")
+    CHIP=$(cat "$SIM_DIR/bank0/chip_name")
+    echo "/sys/devices/platform/$DEV/$CHIP"
+}
+
+case "${1:-up}" in
+up)
+    modprobe gpio-sim
+    mountpoint -q "$CONFIGFS" || mount -t configfs none "$CONFIGFS"
+    if [ -d "$SIM_DIR" ]; then
+        echo "gpio-sim chip already exists: /dev/$(cat "$SIM_DIR/bank0/chip_name")"
+        exit 0
+    fi
+    mkdir -p "$SIM_DIR/bank0"
+    echo "$LABEL" > "$SIM_DIR/bank0/label"
+    echo "$NUM_LINES" > "$SIM_DIR/bank0/num_lines"
+    echo 1 > "$SIM_DIR/live"
+    CHIP=$(cat "$SIM_DIR/bank0/chip_name")
+    chmod a+rw "/dev/$CHIP"
+    echo "Created /dev/$CHIP (label $LABEL, $NUM_LINES lines)"
+    ;;
+pull)
+    echo "pull-$3" > "$(sim_sysfs_dir)/sim_gpio$2/pull"
+    ;;
+down)
+    [ -d "$SIM_DIR" ] || exit 0
+    echo 0 > "$SIM_DIR/live"
+    rmdir "$SIM_DIR/bank0" "$SIM_DIR"
+    echo "Removed gpio-sim chip $LABEL"
+    ;;
+*)
+    echo "Usage: $0 [up|down|pull <line> <up|down>]"
+    exit 1
+    ;;
+esac
@@ -0,0 +1,229 @@
+//==============================================================================
+// GPIO Simulator - Benchmark
+//------------------------------------------------------------------------------
+//! @file
+//! @brief Measures the native simulator and the HTTP GPIO backend against it
+//!
+//! Runs the server on a background thread in this process, then:
+//!   1. keep-alive round trips (one request in flight)
+//!   2. pipelined requests (batches of PIPELINE_DEPTH in flight)
+//!   3. sGpioInterfaceHTTP write/read through the real backend (port 8080)
+//!   4. sGpioInterfaceUDS write/read through the binary socket backend
+//!
+//! Usage: ./gpio_sim_bench [iterations]   (default 20000; HTTP uses 1/100)
+//------------------------------------------------------------------------------
+
+#define _GNU_SOURCE
+
+#include "gpio_sim_server.h"
+#include "gpioLib.h"
+#include "implementations/pc/gpioLib_uds_protocol.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_PORT 8080 // gpioLib_http.c targets localhost:8080
+#define PIPELINE_DEPTH 32
+
+#define BENCH_UDS_PATH "/tmp/gpio_sim_bench.sock"
+
+extern const sGpioInterface_t sGpioInterfaceHTTP;
+extern const sGpioInterface_t sGpioInterfaceUDS;
+
+static volatile int g_bServerRun = 1;
+
+static void *pvServerThread(void *pvArg) {
+  (void)pvArg;
+  while (g_bServerRun) {
+    eGpioSimServerPoll(20);
+  }
+  return NULL;
+}
+
+static double dNowUs(void) {
+  struct timespec sNow;
+  clock_gettime(CLOCK_MONOTONIC, &sNow);
+  return (double)sNow.tv_sec * 1e6 + (double)sNow.tv_nsec / 1e3;
+}
+
+static int iConnect(uint16_t u16Port) {
+  int iFd = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in sAddr;
+  memset(&sAddr, 0, sizeof(sAddr));
+  sAddr.sin_family = AF_INET;
+  sAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  sAddr.sin_port = htons(u16Port);
+  if (iFd < 0 || connect(iFd, (struct sockaddr *)&sAddr, sizeof(sAddr)) != 0) {
+    return -1;
+  }
+  int iOne = 1;
+  setsockopt(iFd, IPPROTO_TCP, TCP_NODELAY, &iOne, sizeof(iOne));
+  return iFd;
+}
+
+/**
+ * @brief Read exactly u32Count HTTP responses (Content-Length framed)
+ */
+static int iReadResponses(int iFd, int iCount) {
+  static char acBuf[65536];
+  static size_t u32Len = 0;
+
+  while (iCount > 0) {
+    char *pcEnd = memmem(acBuf, u32Len, "\r\n\r\n", 4);
+    if (pcEnd != NULL) {
+      size_t u32Header = (size_t)(pcEnd + 4 - acBuf);
+      char *pcCl = memmem(acBuf, u32Header, "Content-Length:", 15);
+      size_t u32Body = (pcCl != NULL) ? strtoul(pcCl + 15, NULL, 10) : 0;
+      if (u32Len >= u32Header + u32Body) {
+        memmove(acBuf, acBuf + u32Header + u32Body,
+                u32Len - u32Header - u32Body);
+        u32Len -= u32Header + u32Body;
+        iCount--;
+        continue;
+      }
+    }
+    ssize_t iRead = recv(iFd, acBuf + u32Len, sizeof(acBuf) - u32Len, 0);
+    if (iRead <= 0) {
+      return -1;
+    }
+    u32Len += (size_t)iRead;
+  }
+  return 0;
+}
+
+static void vReport(const char *pcName, int iOps, double dUs) {
+  printf("  %-28s %8d ops  %9.0f ops/s  %8.2f us/op\n", pcName, iOps,
+         iOps / (dUs / 1e6), dUs / iOps);
+}
+
+int main(int argc, char **argv) {
+  int iIterations = (argc > 1) ? atoi(argv[1]) : 20000;
+  if (iIterations <= 0) {
+    iIterations = 20000;
+  }
+
+  uint16_t u16Port = 0;
+  if (eGpioSimServerStart(BENCH_PORT, &u16Port) != RET_TYPE_SUCCESS) {
+    fprintf(stderr, "[BENCH] Cannot start simulator on port %u\n", BENCH_PORT);
+    return 1;
+  }
+  if (eGpioSimServerStartUds(BENCH_UDS_PATH) != RET_TYPE_SUCCESS) {
+    fprintf(stderr, "[BENCH] Cannot listen on %s\n", BENCH_UDS_PATH);
+    return 1;
+  }
+  setenv(GPIO_UDS_SOCKET_ENV, BENCH_UDS_PATH, 1);
+  pthread_t sThread;
+  pthread_create(&sThread, NULL, pvServerThread, NULL);
+
+  printf("[BENCH] Native GPIO simulator on 127.0.0.1:%u\n", u16Port);
+
+  static const char acWrite[] =
+      "POST /api/gpio/LED1 HTTP/1.1\r\nHost: localhost\r\n"
+      "Content-Type: application/json\r\nContent-Length: 11\r\n\r\n"
+      "{\"value\":1}";
+  static const char acRead[] =
+      "GET /api/gpio/LED1 HTTP/1.1\r\nHost: localhost\r\n\r\n";
+
+  int iFd = iConnect(u16Port);
+  if (iFd < 0) {
+    fprintf(stderr, "[BENCH] Cannot connect\n");
+    return 1;
+  }
+
+  // 1) Keep-alive, one request in flight
+  double dStart = dNowUs();
+  for (int i = 0; i < iIterations; i++) {
+    const char *pcReq = (i & 1) ? acRead : acWrite;
+    size_t u32Len = (i & 1) ? sizeof(acRead) - 1 : sizeof(acWrite) - 1;
+    if (send(iFd, pcReq, u32Len, 0) < 0 || iReadResponses(iFd, 1) != 0) {
+      fprintf(stderr, "[BENCH] Round trip failed\n");
+      return 1;
+    }
+  }
+  vReport("keep-alive round trip", iIterations, dNowUs() - dStart);
+
+  // 2) Pipelined batches
+  static char acBatch[PIPELINE_DEPTH * sizeof(acWrite)];
+  size_t u32BatchLen = 0;
+  for (int i = 0; i < PIPELINE_DEPTH; i++) {
+    memcpy(acBatch + u32BatchLen, acWrite, sizeof(acWrite) - 1);
+    u32BatchLen += sizeof(acWrite) - 1;
+  }
+  int iBatches = iIterations / PIPELINE_DEPTH;
+  dStart = dNowUs();
+  for (int i = 0; i < iBatches; i++) {
+    if (send(iFd, acBatch, u32BatchLen, 0) < 0 ||
+        iReadResponses(iFd, PIPELINE_DEPTH) != 0) {
+      fprintf(stderr, "[BENCH] Pipelined batch failed\n");
+      return 1;
+    }
+  }
+  vReport("pipelined (depth 32)", iBatches * PIPELINE_DEPTH,
+          dNowUs() - dStart);
+  close(iFd);
+
+  // 3) Real HTTP backend (sGpioInterfaceHTTP) against the simulator
+  int iBackendOps = iIterations / 100;
+  if (iBackendOps < 10) {
+    iBackendOps = 10;
+  }
+  vHalRegisterGpioInterface(&sGpioInterfaceHTTP);
+  const sGpioInterface_t *psGpio = psHalGetGpioInterface();
+  psGpio->vHalGpioInitFunc();
+
+  int iFailures = 0;
+  dStart = dNowUs();
+  for (int i = 0; i < iBackendOps; i++) {
+    if (psGpio->eHalGpioWriteFunc("LED1", (i & 1) != 0) != RET_TYPE_SUCCESS) {
+      iFailures++;
+    }
+  }
+  vReport("sGpioInterfaceHTTP write", iBackendOps, dNowUs() - dStart);
+
+  bool bValue = false;
+  dStart = dNowUs();
+  for (int i = 0; i < iBackendOps; i++) {
+    if (psGpio->eHalGpioReadFunc("LED1", &bValue) != RET_TYPE_SUCCESS) {
+      iFailures++;
+    }
+  }
+  vReport("sGpioInterfaceHTTP read", iBackendOps, dNowUs() - dStart);
+
+  // 4) Binary UDS backend (sGpioInterfaceUDS) against the same pin table
+  vHalRegisterGpioInterface(&sGpioInterfaceUDS);
+  psGpio = psHalGetGpioInterface();
+  psGpio->vHalGpioInitFunc();
+
+  dStart = dNowUs();
+  for (int i = 0; i < iIterations; i++) {
+    if (psGpio->eHalGpioWriteFunc("LED1", (i & 1) != 0) != RET_TYPE_SUCCESS) {
+      iFailures++;
+    }
+  }
+  vReport("sGpioInterfaceUDS write", iIterations, dNowUs() - dStart);
+
+  dStart = dNowUs();
+  for (int i = 0; i < iIterations; i++) {
+    if (psGpio->eHalGpioReadFunc("LED1", &bValue) != RET_TYPE_SUCCESS) {
+      iFailures++;
+    }
+  }
+  vReport("sGpioInterfaceUDS read", iIterations, dNowUs() - dStart);
+
+  g_bServerRun = 0;
+  pthread_join(sThread, NULL);
+
+  sGpioSimStats_t sStats;
+  vGpioSimServerGetStats(&sStats);
+  vGpioSimServerStop();
+  printf("[BENCH] Server answered %llu requests; backend failures: %d\n",
+         (unsigned long long)sStats.u64Requests, iFailures);
+  return (iFailures == 0) ? 0 : 1;
+}
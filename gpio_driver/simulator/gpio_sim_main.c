@@ -0,0 +1,61 @@
+//==============================================================================
+// GPIO Simulator - Native HTTP Server Entry Point
+//------------------------------------------------------------------------------
+//! @file
+//! @brief Standalone simulator: ./gpio_sim_server [port] [socket]
+//!        (defaults: 8080 and $GPIO_UDS_SOCKET or GPIO_UDS_SOCKET_PATH)
+//------------------------------------------------------------------------------
+
+#include "gpio_sim_server.h"
+#include "implementations/pc/gpioLib_uds_protocol.h"
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static volatile sig_atomic_t g_bStop = 0;
+
+static void vOnSignal(int iSignal) {
+  (void)iSignal;
+  g_bStop = 1;
+}
+
+int main(int argc, char **argv) {
+  uint16_t u16Port = 8080;
+  if (argc > 1) {
+    u16Port = (uint16_t)atoi(argv[1]);
+  }
+
+  uint16_t u16Bound = 0;
+  if (eGpioSimServerStart(u16Port, &u16Bound) != RET_TYPE_SUCCESS) {
+    fprintf(stderr, "[GPIO SIM] [ERROR] Cannot listen on 127.0.0.1:%u\n",
+            u16Port);
+    return 1;
+  }
+
+  const char *pcSocket = (argc > 2) ? argv[2] : getenv(GPIO_UDS_SOCKET_ENV);
+  if (pcSocket == NULL) {
+    pcSocket = GPIO_UDS_SOCKET_PATH;
+  }
+  if (eGpioSimServerStartUds(pcSocket) != RET_TYPE_SUCCESS) {
+    fprintf(stderr, "[GPIO SIM] [WARNING] Cannot listen on %s\n", pcSocket);
+  } else {
+    printf("[GPIO SIM] Listening on unix:%s (binary)\n", pcSocket);
+  }
+
+  signal(SIGINT, vOnSignal);
+  signal(SIGTERM, vOnSignal);
+  printf("[GPIO SIM] Listening on http://127.0.0.1:%u/api/gpio/\n", u16Bound);
+  fflush(stdout);
+
+  while (!g_bStop) {
+    eGpioSimServerPoll(200);
+  }
+
+  sGpioSimStats_t sStats;
+  vGpioSimServerGetStats(&sStats);
+  vGpioSimServerStop();
+  printf("[GPIO SIM] Stopped. %llu requests, %llu pin writes.\n",
+         (unsigned long long)sStats.u64Requests,
+         (unsigned long long)sStats.u64Writes);
+  return 0;
+}
@@ -0,0 +1,998 @@
+//==============================================================================
+// GPIO Simulator - Native HTTP Server
+//------------------------------------------------------------------------------
+//! @file
+//! @brief epoll-based stand-in for the Python GPIO simulator (Linux)
+//------------------------------------------------------------------------------
+
+#define _GNU_SOURCE
+
+// Includes ====================================================================
+#include "gpio_sim_server.h"
+#include "implementations/pc/gpioLib_uds_protocol.h"
+#include <errno.h>
+#include <stddef.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+
+// Constants ===================================================================
+#define SIM_API_PREFIX "/api/gpio/"
+#define SIM_IN_BUFFER_SIZE 4096
+#define SIM_OUT_BUFFER_SIZE 32768
+#define SIM_MAX_EVENTS 64
+#define SIM_HASH_SLOTS (GPIO_SIM_MAX_PINS * 2) // Power of two, load <= 0.5
+
+// Worst-case single response: /api/gpio/all with every pin at max name length
+#define SIM_MAX_RESPONSE_SIZE                                                  \
+  (GPIO_SIM_MAX_PINS * (GPIO_SIM_MAX_PIN_NAME_LEN + 8) + 256)
+
+// Type Definitions ============================================================
+typedef struct {
+  char acName[GPIO_SIM_MAX_PIN_NAME_LEN];
+  uint8_t u8NameLen;
+  bool bValue;
+  uint8_t u8Direction;
+  uint8_t u8Pull;
+} sSimPin_t;
+
+typedef struct {
+  int iFd; // -1 = free slot
+  bool bClose;
+  bool bWantWrite;
+  size_t u32InLen;
+  size_t u32OutLen;
+  size_t u32OutSent;
+  char acIn[SIM_IN_BUFFER_SIZE];
+  char acOut[SIM_OUT_BUFFER_SIZE];
+} sSimConn_t;
+
+typedef struct {
+  int iFd;       // -1 = free slot
+  bool bPending; // sReply could not be sent yet (socket buffer full)
+  sGpioUdsMsg_t sReply;
+} sSimUdsConn_t;
+
+// Static Variables ============================================================
+static int g_iSimListenFd = -1;
+static int g_iSimEpollFd = -1;
+static sSimPin_t g_asSimPins[GPIO_SIM_MAX_PINS];
+static uint16_t g_u16SimPinCount = 0;
+static uint16_t g_au16SimHash[SIM_HASH_SLOTS]; // pin index + 1, 0 = empty
+static sSimConn_t g_asSimConns[GPIO_SIM_MAX_CONNECTIONS];
+static sGpioSimStats_t g_sSimStats;
+static int g_iSimUdsListenFd = -1;
+static char g_acSimUdsPath[sizeof(((struct sockaddr_un *)0)->sun_path)];
+static sSimUdsConn_t g_asSimUdsConns[GPIO_SIM_MAX_CONNECTIONS];
+static const char g_cSimUdsListenTag = 0; // epoll tag for the UDS listener
+
+// Pin Table ===================================================================
+
+static uint32_t u32Sim_Hash(const char *pcName, size_t u32Len) {
+  uint32_t u32Hash = 2166136261u; // FNV-1a
+  for (size_t i = 0; i < u32Len; i++) {
+    u32Hash ^= (uint8_t)pcName[i];
+    u32Hash *= 16777619u;
+  }
+  return u32Hash;
+}
+
+/**
+ * @brief Look up a pin by name span, optionally creating it
+ */
+static sSimPin_t *psSim_FindPin(const char *pcName, size_t u32Len,
+                                bool bCreate) {
+  if (u32Len == 0 || u32Len >= GPIO_SIM_MAX_PIN_NAME_LEN) {
+    return NULL;
+  }
+
+  uint32_t u32Slot = u32Sim_Hash(pcName, u32Len) & (SIM_HASH_SLOTS - 1);
+  while (g_au16SimHash[u32Slot] != 0) {
+    sSimPin_t *psPin = &g_asSimPins[g_au16SimHash[u32Slot] - 1];
+    if (psPin->u8NameLen == u32Len &&
+        memcmp(psPin->acName, pcName, u32Len) == 0) {
+      return psPin;
+    }
+    u32Slot = (u32Slot + 1) & (SIM_HASH_SLOTS - 1);
+  }
+
+  if (!bCreate || g_u16SimPinCount >= GPIO_SIM_MAX_PINS) {
+    return NULL;
+  }
+
+  sSimPin_t *psPin = &g_asSimPins[g_u16SimPinCount];
+  memset(psPin, 0, sizeof(*psPin));
+  memcpy(psPin->acName, pcName, u32Len);
+  psPin->u8NameLen = (uint8_t)u32Len;
+  g_au16SimHash[u32Slot] = (uint16_t)(++g_u16SimPinCount);
+  return psPin;
+}
+
+// JSON ========================================================================
+
+static const char *pcSim_SkipWs(const char *pc) {
+  while (*pc == ' ' || *pc == '\t' || *pc == '\r' || *pc == '\n') {
+    pc++;
+  }
+  return pc;
+}
+
+/**
+ * @brief Parse a Content-Length value: decimal digits up to the end of line
+ * @return false for a missing, non-numeric or negative value; a value past
+ *         ULONG_MAX comes back as ULONG_MAX (too large for any buffer)
+ */
+static bool bSim_ParseContentLen(const char *pc, size_t *pu32Len) {
+  while (*pc == ' ' || *pc == '\t') {
+    pc++;
+  }
+  if (*pc < '0' || *pc > '9') {
+    return false;
+  }
+  char *pcEnd = NULL;
+  unsigned long ulLen = strtoul(pc, &pcEnd, 10);
+  while (*pcEnd == ' ' || *pcEnd == '\t') {
+    pcEnd++;
+  }
+  if (*pcEnd != '\r' && *pcEnd != '\n') {
+    return false;
+  }
+  *pu32Len = (ulLen > SIZE_MAX) ? SIZE_MAX : (size_t)ulLen;
+  return true;
+}
+
+/**
+ * @brief Iterate the members of a flat JSON object (NUL-terminated)
+ *
+ * Call with pc pointing at '{' first, then with the returned pointer.
+ * Integer and true/false values set *pbIsInt; other values are skipped.
+ * @return Position after the member, or NULL at the end / on malformed input
+ */
+static const char *pcSim_JsonNext(const char *pc, const char **ppcKey,
+                                  size_t *pu32KeyLen, int *piValue,
+                                  bool *pbIsInt) {
+  pc = pcSim_SkipWs(pc);
+  if (*pc == '{' || *pc == ',') {
+    pc = pcSim_SkipWs(pc + 1);
+  }
+  if (*pc != '"') {
+    return NULL;
+  }
+
+  *ppcKey = ++pc;
+  while (*pc != '\0' && *pc != '"') {
+    pc++;
+  }
+  if (*pc != '"') {
+    return NULL;
+  }
+  *pu32KeyLen = (size_t)(pc - *ppcKey);
+
+  pc = pcSim_SkipWs(pc + 1);
+  if (*pc != ':') {
+    return NULL;
+  }
+  pc = pcSim_SkipWs(pc + 1);
+
+  *pbIsInt = true;
+  if (strncmp(pc, "true", 4) == 0) {
+    *piValue = 1;
+    return pc + 4;
+  }
+  if (strncmp(pc, "false", 5) == 0) {
+    *piValue = 0;
+    return pc + 5;
+  }
+  if (*pc == '-' || (*pc >= '0' && *pc <= '9')) {
+    char *pcEnd = NULL;
+    *piValue = (int)strtol(pc, &pcEnd, 10);
+    return pcEnd;
+  }
+
+  // Skip string / nested / literal values
+  *pbIsInt = false;
+  int iDepth = 0;
+  while (*pc != '\0') {
+    if (*pc == '"') {
+      pc++;
+      while (*pc != '\0' && *pc != '"') {
+        pc += (*pc == '\\' && pc[1] != '\0') ? 2 : 1;
+      }
+      if (*pc == '\0') {
+        return NULL;
+      }
+    } else if (*pc == '{' || *pc == '[') {
+      iDepth++;
+    } else if (*pc == '}' || *pc == ']') {
+      if (iDepth == 0) {
+        return pc;
+      }
+      iDepth--;
+    } else if (*pc == ',' && iDepth == 0) {
+      return pc;
+    }
+    pc++;
+  }
+  return NULL;
+}
+
+/**
+ * @brief Fetch one integer member from a flat JSON object
+ */
+static bool bSim_JsonGetInt(const char *pcJson, const char *pcKey,
+                            int *piValue) {
+  size_t u32Want = strlen(pcKey);
+  const char *pcKeyPos;
+  size_t u32KeyLen;
+  int iValue;
+  bool bIsInt;
+  const char *pc = pcSim_SkipWs(pcJson);
+
+  if (*pc != '{') {
+    return false;
+  }
+  while ((pc = pcSim_JsonNext(pc, &pcKeyPos, &u32KeyLen, &iValue, &bIsInt)) !=
+         NULL) {
+    if (bIsInt && u32KeyLen == u32Want &&
+        memcmp(pcKeyPos, pcKey, u32Want) == 0) {
+      *piValue = iValue;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Connections =================================================================
+
+static void vSim_Reply(sSimConn_t *psConn, int iStatus, const char *pcReason,
+                       const char *pcBody, size_t u32BodyLen) {
+  size_t u32Free = sizeof(psConn->acOut) - psConn->u32OutLen;
+  int iLen = snprintf(psConn->acOut + psConn->u32OutLen, u32Free,
+                      "HTTP/1.1 %d %s\r\n"
+                      "Content-Type: application/json\r\n"
+                      "Content-Length: %u\r\n"
+                      "%s\r\n",
+                      iStatus, pcReason, (unsigned)u32BodyLen,
+                      psConn->bClose ? "Connection: close\r\n" : "");
+  if (iLen < 0 || (size_t)iLen + u32BodyLen > u32Free) {
+    psConn->bClose = true; // Cannot happen given the caller's space check
+    return;
+  }
+  psConn->u32OutLen += (size_t)iLen;
+  memcpy(psConn->acOut + psConn->u32OutLen, pcBody, u32BodyLen);
+  psConn->u32OutLen += u32BodyLen;
+  g_sSimStats.u64Requests++;
+}
+
+static void vSim_ReplyJson(sSimConn_t *psConn, const char *pcBody) {
+  vSim_Reply(psConn, 200, "OK", pcBody, strlen(pcBody));
+}
+
+static void vSim_ReplyError(sSimConn_t *psConn, int iStatus,
+                            const char *pcReason) {
+  char acBody[96];
+  int iLen = snprintf(acBody, sizeof(acBody), "{\"error\":\"%s\"}", pcReason);
+  vSim_Reply(psConn, iStatus, pcReason, acBody, (size_t)iLen);
+}
+
+/**
+ * @brief Build {"LED1":1,...} for every known pin
+ */
+static void vSim_ReplyAll(sSimConn_t *psConn) {
+  char acBody[SIM_MAX_RESPONSE_SIZE];
+  size_t u32Len = 0;
+
+  acBody[u32Len++] = '{';
+  for (uint16_t i = 0; i < g_u16SimPinCount; i++) {
+    const sSimPin_t *psPin = &g_asSimPins[i];
+    u32Len += (size_t)snprintf(acBody + u32Len, sizeof(acBody) - u32Len,
+                               "%s\"%.*s\":%d", (i > 0) ? "," : "",
+                               (int)psPin->u8NameLen, psPin->acName,
+                               psPin->bValue ? 1 : 0);
+  }
+  acBody[u32Len++] = '}';
+  vSim_Reply(psConn, 200, "OK", acBody, u32Len);
+}
+
+/**
+ * @brief Dispatch one parsed request (pcBody is NUL-terminated)
+ */
+static void vSim_Route(sSimConn_t *psConn, bool bPost, const char *pcPath,
+                       size_t u32PathLen, const char *pcBody) {
+  const size_t u32PrefixLen = sizeof(SIM_API_PREFIX) - 1;
+  char acBody[128];
+
+  if (u32PathLen <= u32PrefixLen ||
+      memcmp(pcPath, SIM_API_PREFIX, u32PrefixLen) != 0) {
+    vSim_ReplyError(psConn, 404, "Not Found");
+    return;
+  }
+
+  const char *pcRest = pcPath + u32PrefixLen;
+  size_t u32RestLen = u32PathLen - u32PrefixLen;
+
+  if (u32RestLen == 6 && memcmp(pcRest, "health", 6) == 0) {
+    snprintf(acBody, sizeof(acBody), "{\"status\":\"ok\",\"pins\":%u}",
+             (unsigned)g_u16SimPinCount);
+    vSim_ReplyJson(psConn, acBody);
+    return;
+  }
+
+  if (u32RestLen == 3 && memcmp(pcRest, "all", 3) == 0) {
+    if (bPost) {
+      // Batch write: {"LED1":1,"LED2":0}
+      const char *pcKey;
+      size_t u32KeyLen;
+      int iValue;
+      bool bIsInt;
+      const char *pc = pcSim_SkipWs(pcBody);
+      if (*pc != '{') {
+        vSim_ReplyError(psConn, 400, "Bad Request");
+        return;
+      }
+      while ((pc = pcSim_JsonNext(pc, &pcKey, &u32KeyLen, &iValue,
+                                  &bIsInt)) != NULL) {
+        sSimPin_t *psPin = bIsInt ? psSim_FindPin(pcKey, u32KeyLen, true)
+                                  : NULL;
+        if (psPin != NULL) {
+          psPin->bValue = (iValue != 0);
+          g_sSimStats.u64Writes++;
+        }
+      }
+    }
+    vSim_ReplyAll(psConn);
+    return;
+  }
+
+  // /api/gpio/<pin> or /api/gpio/<pin>/configure
+  size_t u32NameLen = 0;
+  while (u32NameLen < u32RestLen && pcRest[u32NameLen] != '/') {
+    u32NameLen++;
+  }
+  const char *pcSuffix = pcRest + u32NameLen;
+  size_t u32SuffixLen = u32RestLen - u32NameLen;
+  bool bConfigure =
+      (u32SuffixLen == 10 && memcmp(pcSuffix, "/configure", 10) == 0);
+
+  if (u32SuffixLen != 0 && !bConfigure) {
+    vSim_ReplyError(psConn, 404, "Not Found");
+    return;
+  }
+
+  sSimPin_t *psPin = psSim_FindPin(pcRest, u32NameLen, bPost);
+  if (psPin == NULL) {
+    vSim_ReplyError(psConn, bPost ? 400 : 404,
+                    bPost ? "Bad Request" : "Not Found");
+    return;
+  }
+
+  int iValue = 0;
+  if (bConfigure) {
+    if (!bPost) {
+      vSim_ReplyError(psConn, 405, "Method Not Allowed");
+      return;
+    }
+    if (bSim_JsonGetInt(pcBody, "direction", &iValue)) {
+      psPin->u8Direction = (uint8_t)iValue;
+    }
+    if (bSim_JsonGetInt(pcBody, "pull", &iValue)) {
+      psPin->u8Pull = (uint8_t)iValue;
+    }
+    snprintf(acBody, sizeof(acBody),
+             "{\"pin\":\"%.*s\",\"direction\":%u,\"pull\":%u}",
+             (int)psPin->u8NameLen, psPin->acName, psPin->u8Direction,
+             psPin->u8Pull);
+    vSim_ReplyJson(psConn, acBody);
+    return;
+  }
+
+  if (bPost) {
+    if (!bSim_JsonGetInt(pcBody, "value", &iValue)) {
+      vSim_ReplyError(psConn, 400, "Bad Request");
+      return;
+    }
+    psPin->bValue = (iValue != 0);
+    g_sSimStats.u64Writes++;
+  }
+
+  snprintf(acBody, sizeof(acBody), "{\"pin\":\"%.*s\",\"value\":%d}",
+           (int)psPin->u8NameLen, psPin->acName, psPin->bValue ? 1 : 0);
+  vSim_ReplyJson(psConn, acBody);
+}
+
+/**
+ * @brief Answer every complete request in the input buffer (pipelining)
+ *
+ * Stops early while the output buffer lacks room for a worst-case response;
+ * the rest is handled once the socket drains.
+ */
+static void vSim_ProcessInput(sSimConn_t *psConn) {
+  size_t u32Pos = 0;
+
+  while (!psConn->bClose &&
+         sizeof(psConn->acOut) - psConn->u32OutLen >= SIM_MAX_RESPONSE_SIZE) {
+    char *pcReq = psConn->acIn + u32Pos;
+    size_t u32Avail = psConn->u32InLen - u32Pos;
+
+    // Find end of headers
+    size_t u32HeaderLen = 0;
+    for (size_t i = 3; i < u32Avail; i++) {
+      if (pcReq[i] == '\n' && pcReq[i - 1] == '\r' && pcReq[i - 2] == '\n' &&
+          pcReq[i - 3] == '\r') {
+        u32HeaderLen = i + 1;
+        break;
+      }
+    }
+    if (u32HeaderLen == 0) {
+      break; // Incomplete
+    }
+
+    // Request line: METHOD SP PATH SP VERSION
+    char *pcSp1 = memchr(pcReq, ' ', u32HeaderLen);
+    char *pcSp2 = NULL;
+    if (pcSp1 != NULL) {
+      pcSp2 = memchr(pcSp1 + 1, ' ',
+                     u32HeaderLen - (size_t)(pcSp1 + 1 - pcReq));
+    }
+    if (pcSp2 == NULL) {
+      psConn->bClose = true;
+      vSim_ReplyError(psConn, 400, "Bad Request");
+      break;
+    }
+    size_t u32MethodLen = (size_t)(pcSp1 - pcReq);
+    bool bPost = (u32MethodLen == 4 && memcmp(pcReq, "POST", 4) == 0);
+    bool bGet = (u32MethodLen == 3 && memcmp(pcReq, "GET", 3) == 0);
+    const char *pcPath = pcSp1 + 1;
+    size_t u32PathLen = (size_t)(pcSp2 - pcPath);
+    const char *pcQuery = memchr(pcPath, '?', u32PathLen);
+    if (pcQuery != NULL) {
+      u32PathLen = (size_t)(pcQuery - pcPath);
+    }
+    bool bHttp10 = (strncmp(pcSp2 + 1, "HTTP/1.0", 8) == 0);
+
+    // Headers we care about
+    size_t u32ContentLen = 0;
+    bool bBadLen = false;
+    bool bKeepAlive = !bHttp10;
+    const char *pcLine = memchr(pcReq, '\n', u32HeaderLen) + 1;
+    while (pcLine < pcReq + u32HeaderLen - 2) {
+      if (strncasecmp(pcLine, "Content-Length:", 15) == 0) {
+        bBadLen = bBadLen || !bSim_ParseContentLen(pcLine + 15, &u32ContentLen);
+      } else if (strncasecmp(pcLine, "Connection:", 11) == 0) {
+        const char *pcVal = pcSim_SkipWs(pcLine + 11);
+        if (strncasecmp(pcVal, "close", 5) == 0) {
+          bKeepAlive = false;
+        } else if (strncasecmp(pcVal, "keep-alive", 10) == 0) {
+          bKeepAlive = true;
+        }
+      }
+      pcLine =
+          memchr(pcLine, '\n', (size_t)(pcReq + u32HeaderLen - pcLine)) + 1;
+    }
+
+    if (bBadLen) {
+      psConn->bClose = true;
+      vSim_ReplyError(psConn, 400, "Bad Request");
+      break;
+    }
+    // Compared before adding: a huge length would wrap the sum. The headers
+    // sit in acIn, so the difference cannot underflow.
+    if (u32ContentLen >= sizeof(psConn->acIn) - u32HeaderLen) {
+      psConn->bClose = true;
+      vSim_ReplyError(psConn, 413, "Payload Too Large");
+      break;
+    }
+    if (u32HeaderLen + u32ContentLen > u32Avail) {
+      break; // Body incomplete
+    }
+
+    // Terminate the body in place for the JSON helpers, then restore
+    char *pcBody = pcReq + u32HeaderLen;
+    char cSaved = pcBody[u32ContentLen];
+    pcBody[u32ContentLen] = '\0';
+
+    psConn->bClose = !bKeepAlive;
+    if (bGet || bPost) {
+      vSim_Route(psConn, bPost, pcPath, u32PathLen, pcBody);
+    } else {
+      vSim_ReplyError(psConn, 405, "Method Not Allowed");
+    }
+
+    pcBody[u32ContentLen] = cSaved;
+    u32Pos += u32HeaderLen + u32ContentLen;
+  }
+
+  if (u32Pos > 0) {
+    memmove(psConn->acIn, psConn->acIn + u32Pos, psConn->u32InLen - u32Pos);
+    psConn->u32InLen -= u32Pos;
+  }
+}
+
+static void vSim_CloseConn(sSimConn_t *psConn) {
+  epoll_ctl(g_iSimEpollFd, EPOLL_CTL_DEL, psConn->iFd, NULL);
+  close(psConn->iFd);
+  psConn->iFd = -1;
+  g_sSimStats.u32Connections--;
+}
+
+/**
+ * @brief Send pending output; toggles EPOLLOUT interest as needed
+ * @return false if the connection was closed
+ */
+static bool bSim_Flush(sSimConn_t *psConn) {
+  while (psConn->u32OutSent < psConn->u32OutLen) {
+    ssize_t iSent = send(psConn->iFd, psConn->acOut + psConn->u32OutSent,
+                         psConn->u32OutLen - psConn->u32OutSent, MSG_NOSIGNAL);
+    if (iSent < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        break;
+      }
+      if (errno == EINTR) {
+        continue;
+      }
+      vSim_CloseConn(psConn);
+      return false;
+    }
+    psConn->u32OutSent += (size_t)iSent;
+  }
+
+  bool bPending = psConn->u32OutSent < psConn->u32OutLen;
+  if (!bPending) {
+    psConn->u32OutLen = 0;
+    psConn->u32OutSent = 0;
+    if (psConn->bClose) {
+      vSim_CloseConn(psConn);
+      return false;
+    }
+  }
+
+  if (bPending != psConn->bWantWrite) {
+    // Back-pressure: stop reading while a response is still queued
+    struct epoll_event sEv = {.events = bPending ? EPOLLOUT : EPOLLIN,
+                              .data.ptr = psConn};
+    epoll_ctl(g_iSimEpollFd, EPOLL_CTL_MOD, psConn->iFd, &sEv);
+    psConn->bWantWrite = bPending;
+  }
+  return true;
+}
+
+static void vSim_Accept(void) {
+  for (;;) {
+    int iFd = accept4(g_iSimListenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (iFd < 0) {
+      return; // EAGAIN or transient error
+    }
+
+    sSimConn_t *psConn = NULL;
+    for (int i = 0; i < GPIO_SIM_MAX_CONNECTIONS; i++) {
+      if (g_asSimConns[i].iFd < 0) {
+        psConn = &g_asSimConns[i];
+        break;
+      }
+    }
+    if (psConn == NULL) {
+      close(iFd);
+      continue;
+    }
+
+    int iOne = 1;
+    setsockopt(iFd, IPPROTO_TCP, TCP_NODELAY, &iOne, sizeof(iOne));
+
+    psConn->iFd = iFd;
+    psConn->bClose = false;
+    psConn->bWantWrite = false;
+    psConn->u32InLen = 0;
+    psConn->u32OutLen = 0;
+    psConn->u32OutSent = 0;
+
+    struct epoll_event sEv = {.events = EPOLLIN, .data.ptr = psConn};
+    if (epoll_ctl(g_iSimEpollFd, EPOLL_CTL_ADD, iFd, &sEv) != 0) {
+      close(iFd);
+      psConn->iFd = -1;
+      continue;
+    }
+    g_sSimStats.u32Connections++;
+  }
+}
+
+static void vSim_Read(sSimConn_t *psConn) {
+  for (;;) {
+    size_t u32Space = sizeof(psConn->acIn) - 1 - psConn->u32InLen;
+    if (u32Space == 0) {
+      break; // Wait for processing to free room
+    }
+    ssize_t iRead = recv(psConn->iFd, psConn->acIn + psConn->u32InLen,
+                         u32Space, 0);
+    if (iRead > 0) {
+      psConn->u32InLen += (size_t)iRead;
+      continue;
+    }
+    if (iRead < 0 && errno == EINTR) {
+      continue;
+    }
+    if (iRead < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      break;
+    }
+    vSim_CloseConn(psConn); // Peer closed or hard error
+    return;
+  }
+
+  vSim_ProcessInput(psConn);
+  if (psConn->u32OutLen == 0 &&
+      psConn->u32InLen == sizeof(psConn->acIn) - 1) {
+    vSim_CloseConn(psConn); // Header larger than the buffer
+    return;
+  }
+  (void)bSim_Flush(psConn);
+}
+
+// Unix Domain Socket Front End ================================================
+
+static bool bSim_IsUdsConn(const void *pvTag) {
+  const sSimUdsConn_t *psFirst = &g_asSimUdsConns[0];
+  const sSimUdsConn_t *psEnd = &g_asSimUdsConns[GPIO_SIM_MAX_CONNECTIONS];
+  return (const sSimUdsConn_t *)pvTag >= psFirst &&
+         (const sSimUdsConn_t *)pvTag < psEnd;
+}
+
+static void vSim_UdsClose(sSimUdsConn_t *psConn) {
+  epoll_ctl(g_iSimEpollFd, EPOLL_CTL_DEL, psConn->iFd, NULL);
+  close(psConn->iFd);
+  psConn->iFd = -1;
+  g_sSimStats.u32Connections--;
+}
+
+/**
+ * @brief Build the reply for one binary request (handle = pin table index)
+ */
+static void vSim_UdsHandle(const uint8_t *pu8Msg, size_t u32Len,
+                           sGpioUdsMsg_t *psReply) {
+  memset(psReply, 0, sizeof(*psReply));
+  if (u32Len < sizeof(sGpioUdsMsg_t)) {
+    psReply->u8Status = GPIO_UDS_STATUS_BAD_REQUEST;
+    return;
+  }
+
+  memcpy(psReply, pu8Msg, sizeof(*psReply));
+  psReply->u8Status = GPIO_UDS_STATUS_OK;
+  g_sSimStats.u64Requests++;
+
+  switch (psReply->u8Op) {
+  case GPIO_UDS_OP_PING:
+    psReply->u32Value = g_u16SimPinCount;
+    return;
+
+  case GPIO_UDS_OP_CONFIGURE: {
+    if (u32Len < sizeof(sGpioUdsConfigureMsg_t)) {
+      psReply->u8Status = GPIO_UDS_STATUS_BAD_REQUEST;
+      return;
+    }
+    const char *pcName =
+        (const char *)pu8Msg + offsetof(sGpioUdsConfigureMsg_t, acName);
+    size_t u32NameLen = strnlen(pcName, GPIO_UDS_MAX_PIN_NAME_LEN);
+    sSimPin_t *psPin = psSim_FindPin(pcName, u32NameLen, true);
+    if (psPin == NULL) {
+      psReply->u8Status = (u32NameLen == 0 ||
+                           u32NameLen >= GPIO_SIM_MAX_PIN_NAME_LEN)
+                              ? GPIO_UDS_STATUS_BAD_REQUEST
+                              : GPIO_UDS_STATUS_FULL;
+      return;
+    }
+    psPin->u8Direction = (uint8_t)(psReply->u32Value & 0xFF);
+    psPin->u8Pull = (uint8_t)((psReply->u32Value >> 8) & 0xFF);
+    psReply->u16Handle = (uint16_t)(psPin - g_asSimPins);
+    psReply->u32Value = psPin->bValue ? 1u : 0u;
+    return;
+  }
+
+  case GPIO_UDS_OP_READ:
+  case GPIO_UDS_OP_WRITE:
+    if (psReply->u16Handle >= g_u16SimPinCount) {
+      psReply->u8Status = GPIO_UDS_STATUS_BAD_HANDLE;
+      return;
+    }
+    if (psReply->u8Op == GPIO_UDS_OP_WRITE) {
+      g_asSimPins[psReply->u16Handle].bValue = (psReply->u32Value != 0);
+      g_sSimStats.u64Writes++;
+    }
+    psReply->u32Value = g_asSimPins[psReply->u16Handle].bValue ? 1u : 0u;
+    return;
+
+  default:
+    psReply->u8Status = GPIO_UDS_STATUS_BAD_REQUEST;
+    return;
+  }
+}
+
+/**
+ * @brief Send the queued reply; toggles EPOLLOUT interest as needed
+ * @return false if the connection was closed
+ */
+static bool bSim_UdsFlush(sSimUdsConn_t *psConn) {
+  bool bWasPending = psConn->bPending;
+  ssize_t iSent = send(psConn->iFd, &psConn->sReply, sizeof(psConn->sReply),
+                       MSG_NOSIGNAL | MSG_DONTWAIT);
+  if (iSent < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+    vSim_UdsClose(psConn);
+    return false;
+  }
+  psConn->bPending = (iSent < 0);
+
+  if (psConn->bPending != bWasPending) {
+    // Back-pressure: stop reading until the reply is out
+    struct epoll_event sEv = {.events = psConn->bPending ? EPOLLOUT : EPOLLIN,
+                              .data.ptr = psConn};
+    epoll_ctl(g_iSimEpollFd, EPOLL_CTL_MOD, psConn->iFd, &sEv);
+  }
+  return !psConn->bPending;
+}
+
+static void vSim_UdsAccept(void) {
+  for (;;) {
+    int iFd = accept4(g_iSimUdsListenFd, NULL, NULL,
+                      SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (iFd < 0) {
+      return; // EAGAIN or transient error
+    }
+
+    sSimUdsConn_t *psConn = NULL;
+    for (int i = 0; i < GPIO_SIM_MAX_CONNECTIONS; i++) {
+      if (g_asSimUdsConns[i].iFd < 0) {
+        psConn = &g_asSimUdsConns[i];
+        break;
+      }
+    }
+    if (psConn == NULL) {
+      close(iFd);
+      continue;
+    }
+
+    psConn->iFd = iFd;
+    psConn->bPending = false;
+
+    struct epoll_event sEv = {.events = EPOLLIN, .data.ptr = psConn};
+    if (epoll_ctl(g_iSimEpollFd, EPOLL_CTL_ADD, iFd, &sEv) != 0) {
+      close(iFd);
+      psConn->iFd = -1;
+      continue;
+    }
+    g_sSimStats.u32Connections++;
+  }
+}
+
+static void vSim_UdsEvent(sSimUdsConn_t *psConn, uint32_t u32Events) {
+  if (u32Events & (EPOLLERR | EPOLLHUP)) {
+    vSim_UdsClose(psConn);
+    return;
+  }
+  if (psConn->bPending && !bSim_UdsFlush(psConn)) {
+    return;
+  }
+
+  // One datagram per request; drain what is queued, one reply each
+  uint8_t au8Msg[sizeof(sGpioUdsConfigureMsg_t)];
+  for (;;) {
+    ssize_t iRead = recv(psConn->iFd, au8Msg, sizeof(au8Msg), MSG_DONTWAIT);
+    if (iRead < 0 && errno == EINTR) {
+      continue;
+    }
+    if (iRead < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return;
+    }
+    if (iRead <= 0) {
+      vSim_UdsClose(psConn); // Peer closed or hard error
+      return;
+    }
+    vSim_UdsHandle(au8Msg, (size_t)iRead, &psConn->sReply);
+    if (!bSim_UdsFlush(psConn)) {
+      return;
+    }
+  }
+}
+
+// Functions ===================================================================
+
+eRetType_t eGpioSimServerStart(uint16_t u16Port, uint16_t *pu16BoundPort) {
+  if (g_iSimListenFd >= 0) {
+    return RET_TYPE_ALREADY_EXISTS;
+  }
+
+  for (int i = 0; i < GPIO_SIM_MAX_CONNECTIONS; i++) {
+    g_asSimConns[i].iFd = -1;
+    g_asSimUdsConns[i].iFd = -1;
+  }
+  memset(&g_sSimStats, 0, sizeof(g_sSimStats));
+
+  g_iSimListenFd =
+      socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (g_iSimListenFd < 0) {
+    return RET_TYPE_FAIL;
+  }
+
+  int iOne = 1;
+  setsockopt(g_iSimListenFd, SOL_SOCKET, SO_REUSEADDR, &iOne, sizeof(iOne));
+
+  struct sockaddr_in sAddr;
+  memset(&sAddr, 0, sizeof(sAddr));
+  sAddr.sin_family = AF_INET;
+  sAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  sAddr.sin_port = htons(u16Port);
+
+  if (bind(g_iSimListenFd, (struct sockaddr *)&sAddr, sizeof(sAddr)) != 0 ||
+      listen(g_iSimListenFd, SOMAXCONN) != 0) {
+    close(g_iSimListenFd);
+    g_iSimListenFd = -1;
+    return RET_TYPE_FAIL;
+  }
+
+  socklen_t sLen = sizeof(sAddr);
+  getsockname(g_iSimListenFd, (struct sockaddr *)&sAddr, &sLen);
+  if (pu16BoundPort != NULL) {
+    *pu16BoundPort = ntohs(sAddr.sin_port);
+  }
+
+  g_iSimEpollFd = epoll_create1(EPOLL_CLOEXEC);
+  struct epoll_event sEv = {.events = EPOLLIN, .data.ptr = NULL};
+  if (g_iSimEpollFd < 0 ||
+      epoll_ctl(g_iSimEpollFd, EPOLL_CTL_ADD, g_iSimListenFd, &sEv) != 0) {
+    vGpioSimServerStop();
+    return RET_TYPE_FAIL;
+  }
+
+  return RET_TYPE_SUCCESS;
+}
+
+eRetType_t eGpioSimServerStartUds(const char *pcPath) {
+  if (g_iSimEpollFd < 0) {
+    return RET_TYPE_NOT_INITIALIZED;
+  }
+  if (g_iSimUdsListenFd >= 0) {
+    return RET_TYPE_ALREADY_EXISTS;
+  }
+  if (pcPath == NULL) {
+    pcPath = GPIO_UDS_SOCKET_PATH;
+  }
+  if (strlen(pcPath) >= sizeof(g_acSimUdsPath)) {
+    return RET_TYPE_INVALID_PARAMETER;
+  }
+
+  g_iSimUdsListenFd =
+      socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (g_iSimUdsListenFd < 0) {
+    return RET_TYPE_FAIL;
+  }
+
+  struct sockaddr_un sAddr;
+  memset(&sAddr, 0, sizeof(sAddr));
+  sAddr.sun_family = AF_UNIX;
+  strcpy(sAddr.sun_path, pcPath);
+  unlink(pcPath); // Stale socket from a previous run
+
+  struct epoll_event sEv = {.events = EPOLLIN,
+                            .data.ptr = (void *)&g_cSimUdsListenTag};
+  if (bind(g_iSimUdsListenFd, (struct sockaddr *)&sAddr, sizeof(sAddr)) != 0 ||
+      listen(g_iSimUdsListenFd, SOMAXCONN) != 0 ||
+      epoll_ctl(g_iSimEpollFd, EPOLL_CTL_ADD, g_iSimUdsListenFd, &sEv) != 0) {
+    close(g_iSimUdsListenFd);
+    g_iSimUdsListenFd = -1;
+    return RET_TYPE_FAIL;
+  }
+
+  strcpy(g_acSimUdsPath, pcPath);
+  return RET_TYPE_SUCCESS;
+}
+
+eRetType_t eGpioSimServerPoll(int iTimeoutMs) {
+  if (g_iSimEpollFd < 0) {
+    return RET_TYPE_NOT_INITIALIZED;
+  }
+
+  struct epoll_event asEvents[SIM_MAX_EVENTS];
+  int iCount = epoll_wait(g_iSimEpollFd, asEvents, SIM_MAX_EVENTS, iTimeoutMs);
+
+  for (int i = 0; i < iCount; i++) {
+    sSimConn_t *psConn = (sSimConn_t *)asEvents[i].data.ptr;
+    if (psConn == NULL) {
+      vSim_Accept();
+      continue;
+    }
+    if ((const void *)psConn == &g_cSimUdsListenTag) {
+      vSim_UdsAccept();
+      continue;
+    }
+    if (bSim_IsUdsConn(psConn)) {
+      sSimUdsConn_t *psUds = (sSimUdsConn_t *)(void *)psConn;
+      if (psUds->iFd >= 0) {
+        vSim_UdsEvent(psUds, asEvents[i].events);
+      }
+      continue;
+    }
+    if (psConn->iFd < 0) {
+      continue; // Closed earlier in this batch
+    }
+    if (asEvents[i].events & (EPOLLERR | EPOLLHUP)) {
+      vSim_CloseConn(psConn);
+      continue;
+    }
+    if (asEvents[i].events & EPOLLOUT) {
+      if (!bSim_Flush(psConn)) {
+        continue;
+      }
+      // Output drained: resume any pipelined requests held back
+      vSim_ProcessInput(psConn);
+      if (!bSim_Flush(psConn)) {
+        continue;
+      }
+    }
+    if (asEvents[i].events & EPOLLIN) {
+      vSim_Read(psConn);
+    }
+  }
+
+  return RET_TYPE_SUCCESS;
+}
+
+void vGpioSimServerStop(void) {
+  for (int i = 0; i < GPIO_SIM_MAX_CONNECTIONS; i++) {
+    if (g_asSimConns[i].iFd >= 0) {
+      close(g_asSimConns[i].iFd);
+      g_asSimConns[i].iFd = -1;
+    }
+    if (g_asSimUdsConns[i].iFd >= 0) {
+      close(g_asSimUdsConns[i].iFd);
+      g_asSimUdsConns[i].iFd = -1;
+    }
+  }
+  if (g_iSimUdsListenFd >= 0) {
+    close(g_iSimUdsListenFd);
+    g_iSimUdsListenFd = -1;
+    unlink(g_acSimUdsPath);
+  }
+  if (g_iSimEpollFd >= 0) {
+    close(g_iSimEpollFd);
+    g_iSimEpollFd = -1;
+  }
+  if (g_iSimListenFd >= 0) {
+    close(g_iSimListenFd);
+    g_iSimListenFd = -1;
+  }
+  g_sSimStats.u32Connections = 0;
+}
+
+eRetType_t eGpioSimServerSetPin(const char *pcPinName, bool bValue) {
+  if (pcPinName == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+  sSimPin_t *psPin = psSim_FindPin(pcPinName, strlen(pcPinName), true);
+  if (psPin == NULL) {
+    return RET_TYPE_INVALID_PARAMETER;
+  }
+  psPin->bValue = bValue;
+  return RET_TYPE_SUCCESS;
+}
+
+eRetType_t eGpioSimServerGetPin(const char *pcPinName, bool *pbValue) {
+  if (pcPinName == NULL || pbValue == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+  const sSimPin_t *psPin = psSim_FindPin(pcPinName, strlen(pcPinName), false);
+  if (psPin == NULL) {
+    return RET_TYPE_NOT_FOUND;
+  }
+  *pbValue = psPin->bValue;
+  return RET_TYPE_SUCCESS;
+}
+
+void vGpioSimServerGetStats(sGpioSimStats_t *psStats) {
+  if (psStats != NULL) {
+    *psStats = g_sSimStats;
+  }
+}
@@ -0,0 +1,99 @@
+//==============================================================================
+// GPIO Simulator - Native HTTP Server
+//------------------------------------------------------------------------------
+//! @file
+//! @brief epoll-based stand-in for the Python GPIO simulator (Linux)
+//!
+//! Serves the same REST surface the HTTP backend and serial_bridge.py use:
+//!   GET  /api/gpio/health            -> {"status":"ok","pins":N}
+//!   GET  /api/gpio/all               -> {"LED1":1,"BUTTON1":0,...}
+//!   POST /api/gpio/all               <- {"LED1":1,...} (batch write)
+//!   GET  /api/gpio/<pin>             -> {"pin":"LED1","value":1}
+//!   POST /api/gpio/<pin>             <- {"value":1}
+//!   POST /api/gpio/<pin>/configure   <- {"direction":1,"pull":0}
+//!
+//! Single-threaded, HTTP/1.1 keep-alive with pipelining, in-memory pin table.
+//! eGpioSimServerStartUds() adds the binary SOCK_SEQPACKET front end used by
+//! gpioLib_uds.c on the same event loop and pin table.
+//! Link it into a test or benchmark and drive it with eGpioSimServerPoll(),
+//! or run the gpio_sim_server executable.
+//------------------------------------------------------------------------------
+
+#ifndef GPIO_SIM_SERVER_H
+#define GPIO_SIM_SERVER_H
+
+#include "common.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Constants ===================================================================
+#define GPIO_SIM_MAX_PINS 256
+#define GPIO_SIM_MAX_PIN_NAME_LEN 32
+#define GPIO_SIM_MAX_CONNECTIONS 256
+
+// Type Definitions ============================================================
+
+/**
+ * @brief Server counters (for benchmarks and fixtures)
+ */
+typedef struct {
+  uint32_t u32Connections; // Currently open client connections
+  uint64_t u64Requests;    // Requests answered (including errors)
+  uint64_t u64Writes;      // Pin values written (batch counts each pin)
+} sGpioSimStats_t;
+
+// Function Prototypes =========================================================
+
+/**
+ * @brief Bind to 127.0.0.1 and start listening
+ * @param u16Port TCP port (0 = pick a free one)
+ * @param pu16BoundPort Receives the actual port (may be NULL)
+ * @return RET_TYPE_SUCCESS, RET_TYPE_ALREADY_EXISTS if running, or RET_TYPE_FAIL
+ */
+eRetType_t eGpioSimServerStart(uint16_t u16Port, uint16_t *pu16BoundPort);
+
+/**
+ * @brief Also listen on a Unix SOCK_SEQPACKET socket (gpioLib_uds_protocol.h)
+ * @param pcPath Socket path (NULL = GPIO_UDS_SOCKET_PATH); replaced if stale
+ * @return RET_TYPE_SUCCESS, RET_TYPE_NOT_INITIALIZED before
+ *         eGpioSimServerStart(), RET_TYPE_ALREADY_EXISTS, or RET_TYPE_FAIL
+ */
+eRetType_t eGpioSimServerStartUds(const char *pcPath);
+
+/**
+ * @brief Run one event-loop iteration
+ * @param iTimeoutMs epoll timeout (-1 = block, 0 = non-blocking)
+ * @return RET_TYPE_SUCCESS, or RET_TYPE_NOT_INITIALIZED if not started
+ */
+eRetType_t eGpioSimServerPoll(int iTimeoutMs);
+
+/**
+ * @brief Close all connections and the listening socket
+ */
+void vGpioSimServerStop(void);
+
+/**
+ * @brief Set a pin value directly (e.g. inject an input from a test)
+ */
+eRetType_t eGpioSimServerSetPin(const char *pcPinName, bool bValue);
+
+/**
+ * @brief Read a pin value directly
+ * @return RET_TYPE_NOT_FOUND if the pin was never configured or written
+ */
+eRetType_t eGpioSimServerGetPin(const char *pcPinName, bool *pbValue);
+
+/**
+ * @brief Copy the current counters
+ */
+void vGpioSimServerGetStats(sGpioSimStats_t *psStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPIO_SIM_SERVER_H
@@ -9,6 +9,8 @@
 //!        auto-calls vHelperSend() for Digital Twin sync.
 //------------------------------------------------------------------------------
 
+#include <ctype.h>
+#include <stdarg.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -26,74 +28,299 @@
 #include "helpers/gpio_helper.h"
 #include "implementations/logPlatform_console.h"
 #include "logLib.h"
+#include "mcp_sched.h"
+#include "mcp_watch.h"
 #include "tool_registry.h"
 
-#ifdef PLATFORM_AVR
+/* Platforms that deliver received UART lines to vOnUartLineReceived */
+#if defined(PLATFORM_AVR) || defined(PLATFORM_LINE_TRANSPORT) ||              \
+    defined(PLATFORM_FARM)
+#define APP_UART_LINES
+#include "mcp_frame.h"
 #include "uart_line_callback.h"
 #endif
 
 extern const sGpioInterface_t *psGetPlatformGpioInterface(void);
 extern void vPlatformDelayMs(uint32_t u32Ms);
+extern uint32_t u32PlatformGetTickMs(void);
 
 #define DELAY_MS(ms) vPlatformDelayMs((uint32_t)(ms))
 
-/* Tool handlers (implemented in tool_handlers_gpio.c); called from registry. */
-extern void vHandleGpioWrite(const char *pcParams);
-extern void vHandleGpioRead(const char *pcParams);
-
-typedef void (*vToolHandler_t)(const char *pcParams);
-
 typedef struct {
   const char *pcName;
   vToolHandler_t pfHandler;
 } sToolEntry_t;
 
-/** Registry: map UART tool name string -> handler. New tools: add entry here
- *  and implement the handler (e.g. in tool_handlers_gpio.c). */
-static const sToolEntry_t g_asMcpRegistry[] = {{"gpio_write", vHandleGpioWrite},
-                                               {"gpio_read", vHandleGpioRead},
-                                               {NULL, NULL}};
+/** Optional request ID "#<id> " in front of a command (1..MCP_TAG_MAX
+ *  alphanumerics). It is echoed on the response so the host can keep several
+ *  commands in flight and match replies by ID. */
+#define MCP_TAG_MAX 8
+
+#ifdef PLATFORM_FARM
+#define MCP_REQUEST_LOCAL __thread /* Instances run concurrently on workers */
+#else
+#define MCP_REQUEST_LOCAL
+#endif
+
+/** "#<id>" of the command being handled, "" when untagged. */
+static MCP_REQUEST_LOCAL char g_acMcpTag[MCP_TAG_MAX + 2];
+
+static void vHandleClock(const sMcpArgs_t *psArgs);
+#ifdef APP_UART_LINES
+static void vHandleProto(const sMcpArgs_t *psArgs);
+static void vHandleFlow(const sMcpArgs_t *psArgs);
+#endif
+
+/** Built-in tools of the app itself. Config tools (config.json "mcp.tools",
+ *  e.g. gpio_write -> vHandleGpioWrite in tool_handlers_gpio.c) are found by
+ *  the generated pfMcpFindTool() instead. */
+static const sToolEntry_t g_asMcpRegistry[] = {
+    {"clock", vHandleClock},
+#ifdef APP_UART_LINES
+    {"proto", vHandleProto},
+    {"flow", vHandleFlow},
+#endif
+    {NULL, NULL}};
+
+void vMcpRespond(const char *pcFormat, ...) {
+  char acText[96];
+  va_list args;
+  va_start(args, pcFormat);
+  vsnprintf(acText, sizeof(acText), pcFormat, args);
+  va_end(args);
+  /* One printf per line: the farm sends each completed line as one frame */
+  if (g_acMcpTag[0] != '\0')
+    printf("%s %s\n", g_acMcpTag, acText);
+  else
+    printf("%s\n", acText);
+}
+
+/* ----------------------------------------------------------------------------
+ * Argument accessors (tool_registry.h)
+ * --------------------------------------------------------------------------*/
+
+bool bMcpArgCount(const sMcpArgs_t *psArgs, uint8_t u8Min, uint8_t u8Max,
+                  const char *pcUsage) {
+  if (psArgs->u8Count >= u8Min && psArgs->u8Count <= u8Max)
+    return true;
+  vMcpRespond("ERR %.*s need %s", (int)psArgs->u8ToolLen, psArgs->pcTool,
+              pcUsage);
+  return false;
+}
+
+bool bMcpArgPin(const sMcpArgs_t *psArgs, uint8_t u8Index, int32_t *piPin) {
+  const sMcpArg_t *psArg = &psArgs->asArgs[u8Index];
+  *piPin = iMcpFindPin(psArg->pcText, psArg->u8Len);
+  if (*piPin >= 0)
+    return true;
+  vMcpRespond("ERR unknown pin %.*s", (int)psArg->u8Len, psArg->pcText);
+  return false;
+}
+
+/** Decimal digits [pc, pcEnd) up to u32Limit, overflow checked */
+static bool bMcpParseDigits(const char *pc, const char *pcEnd,
+                            uint32_t u32Limit, uint32_t *pu32Value) {
+  if (pc == pcEnd)
+    return false;
+  uint32_t u32Value = 0;
+  for (; pc < pcEnd; pc++) {
+    uint8_t u8Digit = (uint8_t)(*pc - '0');
+    if (u8Digit > 9 || u32Value > (u32Limit - u8Digit) / 10)
+      return false;
+    u32Value = u32Value * 10 + u8Digit;
+  }
+  *pu32Value = u32Value;
+  return true;
+}
+
+/** Decimal int32 with optional sign, overflow checked (no strtol/sscanf) */
+static bool bMcpParseInt(const sMcpArg_t *psArg, int32_t *pi32Value) {
+  const char *pc = psArg->pcText;
+  const char *pcEnd = pc + psArg->u8Len;
+  bool bNeg = false;
+  if (pc < pcEnd && (*pc == '-' || *pc == '+'))
+    bNeg = (*pc++ == '-');
+  /* Magnitude up to 2^31 so INT32_MIN still parses */
+  uint32_t u32Value = 0;
+  if (!bMcpParseDigits(pc, pcEnd, bNeg ? 0x80000000UL : 0x7FFFFFFFUL,
+                       &u32Value))
+    return false;
+  *pi32Value = bNeg ? (int32_t)(0 - u32Value) : (int32_t)u32Value;
+  return true;
+}
+
+bool bMcpArgInt(const sMcpArgs_t *psArgs, uint8_t u8Index,
+                int32_t *pi32Value) {
+  const sMcpArg_t *psArg = &psArgs->asArgs[u8Index];
+  if (bMcpParseInt(psArg, pi32Value))
+    return true;
+  vMcpRespond("ERR arg %u not an integer: %.*s", (unsigned)u8Index + 1,
+              (int)psArg->u8Len, psArg->pcText);
+  return false;
+}
+
+bool bMcpArgU32(const sMcpArgs_t *psArgs, uint8_t u8Index,
+                uint32_t *pu32Value) {
+  const sMcpArg_t *psArg = &psArgs->asArgs[u8Index];
+  if (bMcpParseDigits(psArg->pcText, psArg->pcText + psArg->u8Len,
+                      0xFFFFFFFFUL, pu32Value))
+    return true;
+  vMcpRespond("ERR arg %u not an unsigned integer: %.*s",
+              (unsigned)u8Index + 1, (int)psArg->u8Len, psArg->pcText);
+  return false;
+}
+
+bool bMcpArgBool(const sMcpArgs_t *psArgs, uint8_t u8Index, bool *pbValue) {
+  const sMcpArg_t *psArg = &psArgs->asArgs[u8Index];
+  int32_t i32Value = 0;
+  /* Any integer is accepted, as with the old "%d" parse */
+  if (bMcpParseInt(psArg, &i32Value)) {
+    *pbValue = (i32Value != 0);
+    return true;
+  }
+  vMcpRespond("ERR arg %u not a bool (0/1): %.*s", (unsigned)u8Index + 1,
+              (int)psArg->u8Len, psArg->pcText);
+  return false;
+}
+
+bool bMcpArgPinValue(const sMcpArgs_t *psArgs, uint8_t u8Index, int32_t *piPin,
+                     bool *pbValue) {
+  const sMcpArg_t *psArg = &psArgs->asArgs[u8Index];
+  const char *pcEq = memchr(psArg->pcText, '=', psArg->u8Len);
+  uint8_t u8PinLen = (pcEq != NULL) ? (uint8_t)(pcEq - psArg->pcText) : 0;
+  int32_t i32Value = 0;
+  bool bOk = (u8PinLen > 0);
+  if (bOk) {
+    sMcpArg_t sValue = {pcEq + 1, (uint8_t)(psArg->u8Len - u8PinLen - 1)};
+    bOk = bMcpParseInt(&sValue, &i32Value);
+  }
+  if (!bOk) {
+    vMcpRespond("ERR arg %u need PIN=VALUE: %.*s", (unsigned)u8Index + 1,
+                (int)psArg->u8Len, psArg->pcText);
+    return false;
+  }
+  *piPin = iMcpFindPin(psArg->pcText, u8PinLen);
+  if (*piPin < 0) {
+    vMcpRespond("ERR unknown pin %.*s", (int)u8PinLen, psArg->pcText);
+    return false;
+  }
+  *pbValue = (i32Value != 0);
+  return true;
+}
+
+bool bMcpArgIs(const sMcpArgs_t *psArgs, uint8_t u8Index, const char *pcWord) {
+  const sMcpArg_t *psArg = &psArgs->asArgs[u8Index];
+  return u8Index < psArgs->u8Count && strlen(pcWord) == psArg->u8Len &&
+         memcmp(psArg->pcText, pcWord, psArg->u8Len) == 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Command line parse and dispatch
+ * --------------------------------------------------------------------------*/
+
+/**
+ * Split "tool arg1 arg2 ..." in one pass into spans of pcLine itself (blanks
+ * are ' ' and '\t'); nothing is copied or NUL-terminated, so pcLine must stay
+ * valid while the handler runs. Responds with the error on failure.
+ */
+static bool bMcpSplitArgs(const char *pcLine, sMcpArgs_t *psArgs) {
+  const char *pcSpan = NULL;
+  psArgs->pcTool = NULL;
+  psArgs->u8ToolLen = 0;
+  psArgs->u8Count = 0;
+  for (const char *pc = pcLine;; pc++) {
+    bool bBlank = (*pc == ' ' || *pc == '\t' || *pc == '\0');
+    if (pcSpan == NULL) {
+      if (!bBlank)
+        pcSpan = pc;
+    } else if (bBlank) {
+      size_t u32Len = (size_t)(pc - pcSpan);
+      if (u32Len > UINT8_MAX) {
+        vMcpRespond("ERR token too long");
+        return false;
+      }
+      if (psArgs->pcTool == NULL) {
+        psArgs->pcTool = pcSpan;
+        psArgs->u8ToolLen = (uint8_t)u32Len;
+      } else if (psArgs->u8Count == MCP_MAX_ARGS) {
+        vMcpRespond("ERR too many args (max %u)", (unsigned)MCP_MAX_ARGS);
+        return false;
+      } else {
+        psArgs->asArgs[psArgs->u8Count].pcText = pcSpan;
+        psArgs->asArgs[psArgs->u8Count].u8Len = (uint8_t)u32Len;
+        psArgs->u8Count++;
+      }
+      pcSpan = NULL;
+    }
+    if (*pc == '\0')
+      break;
+  }
+  if (psArgs->pcTool == NULL) {
+    vMcpRespond("ERR empty command");
+    return false;
+  }
+  return true;
+}
 
 /**
  * Where the UART line is "constructed" into a function call.
- * Parse "tool_name param1 param2 ...", lookup tool in g_asMcpRegistry,
- * call the registered handler with the params string. The handler then
- * converts params into the real call (e.g. eGpioHelperWrite("LED1", true))
- * and the helper does vHelperSend() for DT sync.
+ * Parse "[#id] tool_name param1 param2 ...", lookup the tool (generated
+ * pfMcpFindTool(), then g_asMcpRegistry) and call its handler with the
+ * argument spans. The handler converts them with bMcpArg*() into the real
+ * call (e.g. eGpioHelperWrite("LED1", true)) and the helper does
+ * vHelperSend() for DT sync.
  */
 void vMcpHandleLine(const char *pcLine) {
   if (pcLine == NULL || pcLine[0] == '\0')
     return;
 
-  /* 1) Extract first token = tool name (e.g. "gpio_write") */
-  char acTool[32];
-  char acParams[96];
-  int iToolLen = 0;
-  while (pcLine[iToolLen] != '\0' && pcLine[iToolLen] != ' ' && iToolLen < 31)
-    iToolLen++;
-  if (iToolLen == 0)
-    return;
-  memcpy(acTool, pcLine, (size_t)iToolLen);
-  acTool[iToolLen] = '\0';
-
-  /* 2) Rest of line = params (e.g. "LED1 1") */
-  const char *pcRest = pcLine + iToolLen;
-  while (*pcRest == ' ')
-    pcRest++;
-  strncpy(acParams, pcRest, sizeof(acParams) - 1);
-  acParams[sizeof(acParams) - 1] = '\0';
-
-  /* 3) Lookup registry and call handler -> eventually eGpioHelperWrite etc. */
-  for (size_t i = 0; g_asMcpRegistry[i].pcName != NULL; i++) {
-    if (strcmp(acTool, g_asMcpRegistry[i].pcName) == 0) {
-      g_asMcpRegistry[i].pfHandler(acParams);
+  /* 0) Optional request ID, kept for every response to this command */
+  g_acMcpTag[0] = '\0';
+  if (pcLine[0] == '#') {
+    int iTagLen = 1;
+    while (isalnum((unsigned char)pcLine[iTagLen]) && iTagLen <= MCP_TAG_MAX)
+      iTagLen++;
+    // A tag alone is an empty command: answered tagged, below
+    if (iTagLen == 1 || (pcLine[iTagLen] != ' ' && pcLine[iTagLen] != '\0')) {
+      printf("ERR bad request id\n");
       return;
     }
+    memcpy(g_acMcpTag, pcLine, (size_t)iTagLen);
+    g_acMcpTag[iTagLen] = '\0';
+    pcLine += iTagLen;
   }
-  printf("ERR unknown tool %s\n", acTool);
+
+  /* 1) Tool name and argument spans, in place */
+  sMcpArgs_t sArgs;
+  if (!bMcpSplitArgs(pcLine, &sArgs)) {
+    g_acMcpTag[0] = '\0';
+    return;
+  }
+
+  /* 2) Lookup and call handler -> eventually eGpioHelperWrite etc. */
+  vToolHandler_t pfHandler = pfMcpFindTool(sArgs.pcTool, sArgs.u8ToolLen);
+  for (size_t i = 0; pfHandler == NULL && g_asMcpRegistry[i].pcName != NULL;
+       i++) {
+    if (strlen(g_asMcpRegistry[i].pcName) == sArgs.u8ToolLen &&
+        memcmp(g_asMcpRegistry[i].pcName, sArgs.pcTool, sArgs.u8ToolLen) == 0)
+      pfHandler = g_asMcpRegistry[i].pfHandler;
+  }
+  if (pfHandler != NULL)
+    pfHandler(&sArgs);
+  else
+    vMcpRespond("ERR unknown tool %.*s", (int)sArgs.u8ToolLen, sArgs.pcTool);
+  g_acMcpTag[0] = '\0';
 }
 
-#ifdef PLATFORM_AVR
+/** "clock": the MCU tick, so the host can map its time onto it (gpio_write_at
+ *  deadlines are ticks). The host halves the round trip; no state here. */
+static void vHandleClock(const sMcpArgs_t *psArgs) {
+  if (!bMcpArgCount(psArgs, 0, 0, "no arguments"))
+    return;
+  vMcpRespond("CLOCK %lu", (unsigned long)u32PlatformGetTickMs());
+}
+
+#ifdef APP_UART_LINES
 /** UART string arrives here. JSON -> DT path; else -> vMcpHandleLine (parse +
  * dispatch above). */
 void vOnUartLineReceived(const char *pcLine) {
@@ -104,6 +331,111 @@ void vOnUartLineReceived(const char *pcLine) {
   else
     vMcpHandleLine(pcLine);
 }
+
+static void vMcpSendFrame(uint8_t u8Op, uint8_t u8Seq, uint8_t u8Pin,
+                          const uint8_t *pu8Payload, uint8_t u8Len) {
+  sMcpFrame_t sFrame = {.u8Op = u8Op, .u8Seq = u8Seq, .u8Pin = u8Pin};
+  sFrame.u8PayloadLen = u8Len;
+  memcpy(sFrame.au8Payload, pu8Payload, u8Len);
+  uint8_t au8Wire[MCP_FRAME_MAX_WIRE];
+  uint16_t u16Len = u16McpFrameEncode(&sFrame, au8Wire);
+  if (u16Len > 0)
+    vUartWriteRaw(au8Wire, u16Len);
+}
+
+/** "proto text|cobs": format of unsolicited output (DT telemetry). Binary
+ *  requests always get binary responses, text gets text. */
+static void vHandleProto(const sMcpArgs_t *psArgs) {
+  if (!bMcpArgCount(psArgs, 1, 1, "text|cobs"))
+    return;
+  if (bMcpArgIs(psArgs, 0, "cobs")) {
+    vUartSetFramed(true);
+    vMcpRespond("OK");
+  } else if (bMcpArgIs(psArgs, 0, "text")) {
+    vUartSetFramed(false);
+    vMcpRespond("OK");
+  } else {
+    vMcpRespond("ERR proto need text|cobs");
+  }
+}
+
+/** "flow": "FLOW <slots> <free> <overruns>". The host keeps at most <slots>
+ *  commands unanswered: a slot is freed before its command runs, so each
+ *  response hands one credit back. <overruns> counts lines dropped since
+ *  boot; a new drop is also announced by vAppLoop (!RX_OVERRUN). */
+static void vHandleFlow(const sMcpArgs_t *psArgs) {
+  uint8_t u8Slots = 0;
+  uint8_t u8Free = 0;
+  uint32_t u32Overruns = 0;
+  if (!bMcpArgCount(psArgs, 0, 0, "no arguments"))
+    return;
+  vUartGetRxFlow(&u8Slots, &u8Free, &u32Overruns);
+  vMcpRespond("FLOW %u %u %lu", (unsigned)u8Slots, (unsigned)u8Free,
+              (unsigned long)u32Overruns);
+}
+
+/** Binary frame (COBS bytes between the 0x00 delimiters) arrives here. The
+ *  same handlers as the text commands run behind it. */
+void vOnUartFrameReceived(const uint8_t *pu8Frame, uint16_t u16Len) {
+  sMcpFrame_t sReq;
+  if (eMcpFrameDecode(pu8Frame, u16Len, &sReq) != RET_TYPE_SUCCESS)
+    return; /* Corrupt: no trustworthy seq to answer; the host times out */
+
+  uint8_t u8RespOp = (uint8_t)(sReq.u8Op | MCP_FRAME_RESPONSE);
+  uint8_t au8Resp[3] = {(uint8_t)RET_TYPE_SUCCESS, 0, 0};
+  const char *pcPin = (sReq.u8Pin < g_u32McpPinCount)
+                          ? g_apcMcpPinNames[sReq.u8Pin]
+                          : NULL;
+  bool bValue = false;
+
+  switch (sReq.u8Op) {
+  case MCP_FRAME_OP_HELLO:
+    au8Resp[1] = MCP_FRAME_VERSION;
+    au8Resp[2] = (uint8_t)g_u32McpPinCount;
+    vMcpSendFrame(u8RespOp, sReq.u8Seq, MCP_FRAME_PIN_NONE, au8Resp, 3);
+    break;
+  case MCP_FRAME_OP_GPIO_WRITE:
+    if (pcPin == NULL)
+      au8Resp[0] = (uint8_t)RET_TYPE_NOT_FOUND;
+    else if (sReq.u8PayloadLen < 1)
+      au8Resp[0] = (uint8_t)RET_TYPE_INVALID_PARAMETER;
+    else
+      au8Resp[0] = (uint8_t)eGpioHelperWrite(pcPin, sReq.au8Payload[0] != 0);
+    vMcpSendFrame(u8RespOp, sReq.u8Seq, sReq.u8Pin, au8Resp, 1);
+    break;
+  case MCP_FRAME_OP_GPIO_READ:
+    if (pcPin == NULL)
+      au8Resp[0] = (uint8_t)RET_TYPE_NOT_FOUND;
+    else
+      au8Resp[0] = (uint8_t)eGpioHelperReadPin(sReq.u8Pin, &bValue);
+    au8Resp[1] = bValue ? 1 : 0;
+    vMcpSendFrame(u8RespOp, sReq.u8Seq, sReq.u8Pin, au8Resp, 2);
+    break;
+  case MCP_FRAME_OP_DT_GPIO:
+    /* Twin input injection: same hook as {"t":"GPIO","p":..,"v":..} */
+    if (pcPin != NULL && sReq.u8PayloadLen >= 1)
+      vPlatformApplyDtPin(sReq.u8Pin, sReq.au8Payload[0] != 0);
+    break;
+  default:
+    au8Resp[0] = (uint8_t)RET_TYPE_INVALID_PARAMETER;
+    vMcpSendFrame(MCP_FRAME_OP_ERROR | MCP_FRAME_RESPONSE, sReq.u8Seq,
+                  sReq.u8Pin, au8Resp, 1);
+    break;
+  }
+}
+
+/** DT telemetry from the platform's vHelperSend: one DT_GPIO frame instead of
+ *  a JSON line when the host asked for "proto cobs". */
+bool bOnHelperSend(const char *pcCmd, const char *pcPin, int iValue) {
+  if (!bUartIsFramed() || strcmp(pcCmd, "GPIO") != 0)
+    return false;
+  int32_t iPin = iMcpFindPin(pcPin, strlen(pcPin));
+  if (iPin < 0 || iPin >= MCP_FRAME_PIN_NONE)
+    return false; /* Not addressable by a one-byte pin handle */
+  uint8_t u8Value = (iValue != 0) ? 1 : 0;
+  vMcpSendFrame(MCP_FRAME_OP_DT_GPIO, 0, (uint8_t)iPin, &u8Value, 1);
+  return true;
+}
 #endif
 
 bool vAppInit(void) {
@@ -114,10 +446,43 @@ bool vAppInit(void) {
   return true;
 }
 
-/** Manager loop: dispatch pending UART line (so printf/response runs in main). */
+#ifdef PLATFORM_AVR
+/** Timer0 ISR, once per ms: scheduled writes go out at their tick here, not
+ *  at the next pass of the loop (which sleeps 10 ms). */
+void vOnPlatformTick(uint32_t u32NowMs) { vMcpSchedRun(u32NowMs); }
+#endif
+
+#ifdef APP_UART_LINES
+/** Commands lost on RX since the last pass: the host's requests will time
+ *  out, this says why. "!RX_OVERRUN <lost> <total>". */
+static void vReportRxOverruns(void) {
+  uint32_t u32Lost = u32UartTakeRxOverruns();
+  if (u32Lost == 0)
+    return;
+  uint8_t u8Slots = 0;
+  uint8_t u8Free = 0;
+  uint32_t u32Total = 0;
+  vUartGetRxFlow(&u8Slots, &u8Free, &u32Total);
+  printf("!RX_OVERRUN %lu %lu\n", (unsigned long)u32Lost,
+         (unsigned long)u32Total);
+}
+#endif
+
+/** Manager loop: dispatch pending UART lines (so printf/response runs in
+ *  main), then report RX overruns, changes of watched pins (gpio_watch),
+ *  scheduled writes (gpio_write_at), then send the pass's Digital Twin
+ *  changes as one message. Sleeps less when a scheduled write is due
+ *  sooner. */
 void vAppLoop(void) {
   (void)bUartDispatchPendingLine();
-  DELAY_MS(10);
+#ifdef APP_UART_LINES
+  vReportRxOverruns();
+#endif
+  vMcpWatchPoll();
+  vMcpSchedPoll();
+  vGpioHelperKeepalive(u32PlatformGetTickMs());
+  vGpioHelperFlush();
+  DELAY_MS(u32McpSchedIdleMs(10));
 }
 
 int main(void) {
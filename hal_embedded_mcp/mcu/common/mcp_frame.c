@@ -0,0 +1,107 @@
+//==============================================================================
+// HAL Embedded MCP - Binary Frame Codec (COBS + CRC-16)
+//------------------------------------------------------------------------------
+//! @file
+//! @brief See mcp_frame.h for the frame layout
+//------------------------------------------------------------------------------
+
+// Includes ====================================================================
+#include "mcp_frame.h"
+#include <stddef.h>
+#include <string.h>
+
+// Functions ===================================================================
+
+uint16_t u16McpFrameCrc16(const uint8_t *pu8Data, uint16_t u16Len) {
+  uint16_t u16Crc = 0xFFFF;
+  for (uint16_t i = 0; i < u16Len; i++) {
+    u16Crc ^= (uint16_t)((uint16_t)pu8Data[i] << 8);
+    for (uint8_t u8Bit = 0; u8Bit < 8; u8Bit++) {
+      u16Crc = (u16Crc & 0x8000) ? (uint16_t)((u16Crc << 1) ^ 0x1021)
+                                 : (uint16_t)(u16Crc << 1);
+    }
+  }
+  return u16Crc;
+}
+
+uint16_t u16McpFrameEncode(const sMcpFrame_t *psFrame, uint8_t *pu8Out) {
+  if (psFrame == NULL || pu8Out == NULL ||
+      psFrame->u8PayloadLen > MCP_FRAME_MAX_PAYLOAD) {
+    return 0;
+  }
+
+  uint8_t au8Raw[MCP_FRAME_MAX_DECODED];
+  uint16_t u16RawLen = 0;
+  au8Raw[u16RawLen++] = psFrame->u8Op;
+  au8Raw[u16RawLen++] = psFrame->u8Seq;
+  au8Raw[u16RawLen++] = psFrame->u8Pin;
+  memcpy(&au8Raw[u16RawLen], psFrame->au8Payload, psFrame->u8PayloadLen);
+  u16RawLen += psFrame->u8PayloadLen;
+  uint16_t u16Crc = u16McpFrameCrc16(au8Raw, u16RawLen);
+  au8Raw[u16RawLen++] = (uint8_t)(u16Crc & 0xFF);
+  au8Raw[u16RawLen++] = (uint8_t)(u16Crc >> 8);
+
+  // COBS: each zero becomes the distance to the next one (frames < 254 B)
+  uint16_t u16Out = 0;
+  pu8Out[u16Out++] = 0x00;
+  uint16_t u16CodeIdx = u16Out++;
+  uint8_t u8Code = 1;
+  for (uint16_t i = 0; i < u16RawLen; i++) {
+    if (au8Raw[i] == 0x00) {
+      pu8Out[u16CodeIdx] = u8Code;
+      u16CodeIdx = u16Out++;
+      u8Code = 1;
+    } else {
+      pu8Out[u16Out++] = au8Raw[i];
+      u8Code++;
+    }
+  }
+  pu8Out[u16CodeIdx] = u8Code;
+  pu8Out[u16Out++] = 0x00;
+  return u16Out;
+}
+
+eRetType_t eMcpFrameDecode(const uint8_t *pu8Cobs, uint16_t u16Len,
+                           sMcpFrame_t *psFrame) {
+  if (pu8Cobs == NULL || psFrame == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+
+  uint8_t au8Raw[MCP_FRAME_MAX_DECODED];
+  uint16_t u16RawLen = 0;
+  uint16_t i = 0;
+  while (i < u16Len) {
+    uint8_t u8Code = pu8Cobs[i++];
+    if (u8Code == 0x00 || i + u8Code - 1 > u16Len ||
+        u16RawLen + u8Code > sizeof(au8Raw) + 1) {
+      return RET_TYPE_INVALID_PARAMETER;
+    }
+    for (uint8_t j = 1; j < u8Code; j++) {
+      au8Raw[u16RawLen++] = pu8Cobs[i++];
+    }
+    if (u8Code != 0xFF && i < u16Len) {
+      if (u16RawLen >= sizeof(au8Raw)) {
+        return RET_TYPE_INVALID_PARAMETER;
+      }
+      au8Raw[u16RawLen++] = 0x00;
+    }
+  }
+
+  if (u16RawLen < MCP_FRAME_HEADER_SIZE + MCP_FRAME_CRC_SIZE) {
+    return RET_TYPE_INVALID_PARAMETER;
+  }
+  uint16_t u16DataLen = (uint16_t)(u16RawLen - MCP_FRAME_CRC_SIZE);
+  uint16_t u16Crc =
+      (uint16_t)(au8Raw[u16DataLen] | ((uint16_t)au8Raw[u16DataLen + 1] << 8));
+  if (u16McpFrameCrc16(au8Raw, u16DataLen) != u16Crc) {
+    return RET_TYPE_FAIL;
+  }
+
+  psFrame->u8Op = au8Raw[0];
+  psFrame->u8Seq = au8Raw[1];
+  psFrame->u8Pin = au8Raw[2];
+  psFrame->u8PayloadLen = (uint8_t)(u16DataLen - MCP_FRAME_HEADER_SIZE);
+  memcpy(psFrame->au8Payload, &au8Raw[MCP_FRAME_HEADER_SIZE],
+         psFrame->u8PayloadLen);
+  return RET_TYPE_SUCCESS;
+}
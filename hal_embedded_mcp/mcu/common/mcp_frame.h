@@ -0,0 +1,88 @@
+//==============================================================================
+// HAL Embedded MCP - Binary Frame Codec (COBS + CRC-16)
+//------------------------------------------------------------------------------
+//! @file
+//! @brief Compact binary messages that share the UART with the text protocol
+//!
+//! On the wire a frame is 0x00 <COBS bytes> 0x00. Text lines never contain
+//! 0x00, so the receiver tells the two apart by the leading delimiter and
+//! both can be interleaved freely. Decoded, a frame is:
+//!
+//!   [op][seq][pin][payload 0..MCP_FRAME_MAX_PAYLOAD][crc16 lo][crc16 hi]
+//!
+//!   op    MCP_FRAME_OP_*; responses are op | MCP_FRAME_RESPONSE
+//!   seq   request ID, echoed on the response (0 for telemetry)
+//!   pin   pin handle = index in config.json "pins" (MCP_FRAME_PIN_NONE)
+//!   crc16 CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) over op..payload
+//!
+//! Responses start their payload with a status byte (eRetType_t).
+//! helper_utils/hal_frame.py is the host-side counterpart.
+//------------------------------------------------------------------------------
+
+#ifndef MCP_FRAME_H
+#define MCP_FRAME_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Includes ====================================================================
+#include "common.h"
+#include <stdint.h>
+
+// Constants ===================================================================
+#define MCP_FRAME_VERSION 1
+
+#define MCP_FRAME_OP_HELLO 0x01      // -> [status][version][pin count]
+#define MCP_FRAME_OP_GPIO_WRITE 0x02 // [value] -> [status]
+#define MCP_FRAME_OP_GPIO_READ 0x03  // -> [status][value]
+#define MCP_FRAME_OP_DT_GPIO 0x10    // [value], telemetry / DT injection
+#define MCP_FRAME_OP_ERROR 0x7F      // -> [status] for an unknown op
+#define MCP_FRAME_RESPONSE 0x80
+
+#define MCP_FRAME_PIN_NONE 0xFF
+
+#define MCP_FRAME_HEADER_SIZE 3
+#define MCP_FRAME_CRC_SIZE 2
+#define MCP_FRAME_MAX_PAYLOAD 8
+#define MCP_FRAME_MAX_DECODED                                                  \
+  (MCP_FRAME_HEADER_SIZE + MCP_FRAME_MAX_PAYLOAD + MCP_FRAME_CRC_SIZE)
+// COBS adds one byte per 254, plus the two delimiters
+#define MCP_FRAME_MAX_WIRE (MCP_FRAME_MAX_DECODED + 1 + 2)
+
+// Type Definitions ============================================================
+typedef struct {
+  uint8_t u8Op;
+  uint8_t u8Seq;
+  uint8_t u8Pin;
+  uint8_t u8PayloadLen;
+  uint8_t au8Payload[MCP_FRAME_MAX_PAYLOAD];
+} sMcpFrame_t;
+
+// Function Prototypes =========================================================
+
+/**
+ * @brief CRC-16/CCITT-FALSE (bitwise: no table in flash)
+ */
+uint16_t u16McpFrameCrc16(const uint8_t *pu8Data, uint16_t u16Len);
+
+/**
+ * @brief Build the wire form of a frame: 0x00, COBS(header+payload+CRC), 0x00
+ * @param pu8Out At least MCP_FRAME_MAX_WIRE bytes
+ * @return Bytes written, 0 if the payload is too long
+ */
+uint16_t u16McpFrameEncode(const sMcpFrame_t *psFrame, uint8_t *pu8Out);
+
+/**
+ * @brief Decode the COBS bytes between two delimiters and check the CRC
+ * @return RET_TYPE_INVALID_PARAMETER for bad COBS or length, RET_TYPE_FAIL
+ *         for a CRC mismatch
+ */
+eRetType_t eMcpFrameDecode(const uint8_t *pu8Cobs, uint16_t u16Len,
+                           sMcpFrame_t *psFrame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MCP_FRAME_H
@@ -0,0 +1,227 @@
+//==============================================================================
+// HAL Embedded MCP - Scheduled GPIO Writes
+//------------------------------------------------------------------------------
+//! @file
+//! @brief See mcp_sched.h for where the queue is serviced and the report
+//!
+//! On AVR the Timer0 ISR pops the heap and fills the done ring while the
+//! main loop pushes and drains: heap changes in the main loop run with
+//! interrupts off, and the ring has one writer per index (ISR: tail, main
+//! loop: head). eMcpSchedAdd admits a write only while heap + ring hold
+//! fewer than MCP_SCHED_MAX, so the ISR never finds the ring full.
+//------------------------------------------------------------------------------
+
+// Includes ====================================================================
+#include "mcp_sched.h"
+#include "config/gpio_config.h" // Pin directions, HAL names by handle
+#include "gpioLib.h"
+#include "gpio_helper.h"
+#include "tool_registry.h"
+#include <stddef.h>
+#include <stdio.h>
+
+#ifdef PLATFORM_AVR
+#include <util/atomic.h>
+#define MCP_SCHED_ATOMIC ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+#else
+#define MCP_SCHED_ATOMIC // Serviced from the main loop only
+#endif
+
+// Platform contract (like vPlatformDelayMs, see app_main.c)
+extern uint32_t u32PlatformGetTickMs(void);
+
+#ifdef PLATFORM_FARM
+// Per board, like the gpio_watch table; a deadline needs a wake-up
+extern sMcpSchedQueue_t *psFarmSchedQueue(void);
+extern void vFarmWakeAtMs(uint32_t u32TickMs);
+#define MCP_SCHED_QUEUE() psFarmSchedQueue()
+#define MCP_SCHED_WAKE_AT(ms) vFarmWakeAtMs(ms)
+#else
+static sMcpSchedQueue_t g_sMcpSchedQueue;
+#define MCP_SCHED_QUEUE() (&g_sMcpSchedQueue)
+#define MCP_SCHED_WAKE_AT(ms) ((void)(ms))
+#endif
+
+#define MCP_SCHED_RING(u8Index) ((uint8_t)((u8Index) & (MCP_SCHED_MAX - 1)))
+
+// Private Function Prototypes ================================================
+static bool bMcpSchedBefore(uint32_t u32A, uint32_t u32B);
+static void vMcpSchedPop(sMcpSchedQueue_t *psQueue, sMcpSchedWrite_t *psOut);
+static eRetType_t eMcpSchedWrite(const uint8_t *pu8Mask,
+                                 const uint8_t *pu8Bits, uint8_t u8Span);
+
+// Functions ===================================================================
+
+/** Tick order across the 49-day wrap: deadlines are < 2^31 ms apart */
+static bool bMcpSchedBefore(uint32_t u32A, uint32_t u32B) {
+  return (int32_t)(u32A - u32B) < 0;
+}
+
+/** Remove the earliest write (heap not empty) */
+static void vMcpSchedPop(sMcpSchedQueue_t *psQueue, sMcpSchedWrite_t *psOut) {
+  sMcpSchedWrite_t *psHeap = psQueue->asHeap;
+  uint8_t u8Count = (uint8_t)(psQueue->u8HeapCount - 1);
+  *psOut = psHeap[0];
+  psHeap[0] = psHeap[u8Count];
+  uint8_t u8Index = 0;
+  for (;;) {
+    uint8_t u8Left = (uint8_t)(2 * u8Index + 1);
+    uint8_t u8Min = u8Index;
+    if (u8Left < u8Count &&
+        bMcpSchedBefore(psHeap[u8Left].u32DueMs, psHeap[u8Min].u32DueMs))
+      u8Min = u8Left;
+    if (u8Left + 1 < u8Count &&
+        bMcpSchedBefore(psHeap[u8Left + 1].u32DueMs, psHeap[u8Min].u32DueMs))
+      u8Min = (uint8_t)(u8Left + 1);
+    if (u8Min == u8Index)
+      break;
+    sMcpSchedWrite_t sTmp = psHeap[u8Min];
+    psHeap[u8Min] = psHeap[u8Index];
+    psHeap[u8Index] = sTmp;
+    u8Index = u8Min;
+  }
+  psQueue->u8HeapCount = u8Count;
+}
+
+/** All writes of one service pass at once: the HAL's grouped write when it
+ *  has one (one store per AVR port), else pin by pin */
+static eRetType_t eMcpSchedWrite(const uint8_t *pu8Mask,
+                                 const uint8_t *pu8Bits, uint8_t u8Span) {
+  const sGpioInterface_t *psGpio = psHalGetGpioInterface();
+  if (psGpio == NULL || psGpio->eHalGpioWriteFunc == NULL)
+    return RET_TYPE_FAIL;
+  if (psGpio->eHalGpioWriteManyFunc != NULL)
+    return psGpio->eHalGpioWriteManyFunc(pu8Mask, pu8Bits, u8Span);
+
+  eRetType_t eResult = RET_TYPE_SUCCESS;
+  for (uint8_t i = 0; i < u8Span; i++) {
+    uint8_t u8Bit = (uint8_t)(1u << (i & 7));
+    if ((pu8Mask[i >> 3] & u8Bit) == 0)
+      continue;
+    eRetType_t eRet = psGpio->eHalGpioWriteFunc(
+        g_psGpioPinConfigs[i].pcPinName, (pu8Bits[i >> 3] & u8Bit) != 0);
+    if (eRet != RET_TYPE_SUCCESS)
+      eResult = eRet;
+  }
+  return eResult;
+}
+
+eRetType_t eMcpSchedAdd(uint8_t u8Pin, bool bValue, uint32_t u32DueMs) {
+  sMcpSchedQueue_t *psQueue = MCP_SCHED_QUEUE();
+  if (psQueue == NULL)
+    return RET_TYPE_NULL_POINTER;
+  if (u8Pin >= MCP_SCHED_MAX_PINS || u8Pin >= g_u32McpPinCount)
+    return RET_TYPE_INVALID_PARAMETER;
+  if (g_psGpioPinConfigs[u8Pin].eDirection != GPIO_DIR_OUTPUT)
+    return RET_TYPE_INVALID_STATE;
+
+  eRetType_t eRet = RET_TYPE_SUCCESS;
+  MCP_SCHED_ATOMIC {
+    uint8_t u8Pending = (uint8_t)(psQueue->u8HeapCount +
+                                  (uint8_t)(psQueue->u8DoneTail -
+                                            psQueue->u8DoneHead));
+    if (!bMcpSchedBefore(u32PlatformGetTickMs(), u32DueMs)) {
+      eRet = RET_TYPE_INVALID_PARAMETER; // Due now, past, or >= 2^31 ahead
+    } else if (u8Pending >= MCP_SCHED_MAX) {
+      eRet = RET_TYPE_MEMORY_ERROR;
+    } else {
+      sMcpSchedWrite_t *psHeap = psQueue->asHeap;
+      uint8_t u8Index = psQueue->u8HeapCount;
+      psHeap[u8Index] = (sMcpSchedWrite_t){.u32DueMs = u32DueMs,
+                                           .u8Pin = u8Pin,
+                                           .u8Value = bValue ? 1 : 0};
+      while (u8Index > 0) {
+        uint8_t u8Parent = (uint8_t)((u8Index - 1) / 2);
+        if (!bMcpSchedBefore(psHeap[u8Index].u32DueMs,
+                             psHeap[u8Parent].u32DueMs))
+          break;
+        sMcpSchedWrite_t sTmp = psHeap[u8Parent];
+        psHeap[u8Parent] = psHeap[u8Index];
+        psHeap[u8Index] = sTmp;
+        u8Index = u8Parent;
+      }
+      psQueue->u8HeapCount++;
+    }
+  }
+  if (eRet == RET_TYPE_SUCCESS)
+    MCP_SCHED_WAKE_AT(psQueue->asHeap[0].u32DueMs);
+  return eRet;
+}
+
+void vMcpSchedRun(uint32_t u32NowMs) {
+  sMcpSchedQueue_t *psQueue = MCP_SCHED_QUEUE();
+  if (psQueue == NULL || psQueue->u8HeapCount == 0 ||
+      bMcpSchedBefore(u32NowMs, psQueue->asHeap[0].u32DueMs))
+    return; // Nothing due: the common case, every tick
+
+  uint8_t au8Mask[MCP_SCHED_MAX_PINS / 8] = {0};
+  uint8_t au8Bits[MCP_SCHED_MAX_PINS / 8] = {0};
+  uint8_t u8Span = 0;
+  uint8_t u8Tail = psQueue->u8DoneTail;
+  uint8_t u8Taken = 0;
+  while (psQueue->u8HeapCount > 0 &&
+         !bMcpSchedBefore(u32NowMs, psQueue->asHeap[0].u32DueMs)) {
+    sMcpSchedWrite_t *psDone =
+        &psQueue->asDone[MCP_SCHED_RING(u8Tail + u8Taken)];
+    vMcpSchedPop(psQueue, psDone);
+    psDone->u32DoneMs = u32NowMs;
+    uint8_t u8Pin = psDone->u8Pin;
+    uint8_t u8Bit = (uint8_t)(1u << (u8Pin & 7));
+    au8Mask[u8Pin >> 3] |= u8Bit;
+    if (psDone->u8Value)
+      au8Bits[u8Pin >> 3] |= u8Bit;
+    else
+      au8Bits[u8Pin >> 3] &= (uint8_t)~u8Bit; // A later write of the pin wins
+    if (u8Pin >= u8Span)
+      u8Span = (uint8_t)(u8Pin + 1);
+    u8Taken++;
+  }
+
+  eRetType_t eRet = eMcpSchedWrite(au8Mask, au8Bits, u8Span);
+  for (uint8_t i = 0; i < u8Taken; i++)
+    psQueue->asDone[MCP_SCHED_RING(u8Tail + i)].u8Status = (uint8_t)eRet;
+  psQueue->u8DoneTail = (uint8_t)(u8Tail + u8Taken); // Publish to the loop
+}
+
+void vMcpSchedPoll(void) {
+  sMcpSchedQueue_t *psQueue = MCP_SCHED_QUEUE();
+  if (psQueue == NULL)
+    return;
+#ifndef PLATFORM_AVR
+  vMcpSchedRun(u32PlatformGetTickMs()); // No tick ISR: the loop services it
+#endif
+
+  while (psQueue->u8DoneHead != psQueue->u8DoneTail) {
+    const sMcpSchedWrite_t *psDone =
+        &psQueue->asDone[MCP_SCHED_RING(psQueue->u8DoneHead)];
+    const char *pcPin = g_apcMcpPinNames[psDone->u8Pin];
+    // Same Digital Twin update as eGpioHelperWrite (sent on a change only)
+    if (psDone->u8Status == RET_TYPE_SUCCESS)
+      vGpioHelperSyncPin(psDone->u8Pin, psDone->u8Value != 0);
+    printf("!GPIO_WRITE_AT %s %u %lu %lu %u\n", pcPin,
+           (unsigned)psDone->u8Value, (unsigned long)psDone->u32DueMs,
+           (unsigned long)psDone->u32DoneMs, (unsigned)psDone->u8Status);
+    psQueue->u8DoneHead++; // Slot free for the ISR again
+  }
+
+  if (psQueue->u8HeapCount > 0)
+    MCP_SCHED_WAKE_AT(psQueue->asHeap[0].u32DueMs);
+}
+
+uint32_t u32McpSchedIdleMs(uint32_t u32MaxMs) {
+  sMcpSchedQueue_t *psQueue = MCP_SCHED_QUEUE();
+  uint32_t u32IdleMs = u32MaxMs;
+  if (psQueue == NULL)
+    return u32IdleMs;
+  MCP_SCHED_ATOMIC {
+    if (psQueue->u8HeapCount > 0) {
+      int32_t i32AheadMs =
+          (int32_t)(psQueue->asHeap[0].u32DueMs - u32PlatformGetTickMs());
+      if (i32AheadMs <= 0)
+        u32IdleMs = 0;
+      else if ((uint32_t)i32AheadMs < u32MaxMs)
+        u32IdleMs = (uint32_t)i32AheadMs;
+    }
+  }
+  return u32IdleMs;
+}
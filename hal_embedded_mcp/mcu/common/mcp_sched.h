@@ -0,0 +1,90 @@
+//==============================================================================
+// HAL Embedded MCP - Scheduled GPIO Writes
+//------------------------------------------------------------------------------
+//! @file
+//! @brief Writes queued for a tick of the MCU clock (gpio_write_at)
+//!
+//! "gpio_write_at PIN VALUE TICK_MS" queues a write for the moment
+//! u32PlatformGetTickMs() reaches TICK_MS. The queue is a min-heap on the
+//! deadline (earliest first), so servicing it costs one compare while
+//! nothing is due:
+//!
+//!   AVR         vMcpSchedRun() runs in the Timer0 ISR (vOnPlatformTick),
+//!               so the edge comes at the tick with ISR latency only
+//!   elsewhere   the main loop runs it (vMcpSchedPoll) and sleeps no longer
+//!               than the next deadline (u32McpSchedIdleMs)
+//!
+//! Writes due at the same time go to the HAL together (one store per AVR
+//! port). The main loop then sends the Digital Twin update and
+//!
+//!   !GPIO_WRITE_AT <pin> <0|1> <due_ms> <done_ms> <status>
+//!
+//! for each, status being the eRetType_t of the write (0 = done).
+//------------------------------------------------------------------------------
+
+#ifndef MCP_SCHED_H
+#define MCP_SCHED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Includes ====================================================================
+#include "common.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Constants ===================================================================
+#define MCP_SCHED_MAX 8       // Queued + not yet reported writes (power of 2)
+#define MCP_SCHED_MAX_PINS 64 // Pin handles that can be scheduled
+
+// Type Definitions ============================================================
+typedef struct {
+  uint32_t u32DueMs;
+  uint32_t u32DoneMs;
+  uint8_t u8Pin;
+  uint8_t u8Value;
+  uint8_t u8Status; // eRetType_t of the write, once done
+} sMcpSchedWrite_t;
+
+/** Zero-initialised = empty. Written by the ISR on AVR: see mcp_sched.c */
+typedef struct {
+  sMcpSchedWrite_t asHeap[MCP_SCHED_MAX]; // Min-heap on u32DueMs
+  volatile uint8_t u8HeapCount;
+  sMcpSchedWrite_t asDone[MCP_SCHED_MAX]; // Ring: ISR -> main loop
+  volatile uint8_t u8DoneHead;            // Next to report (main loop)
+  volatile uint8_t u8DoneTail;            // Next free (vMcpSchedRun)
+} sMcpSchedQueue_t;
+
+// Function Prototypes =========================================================
+
+/**
+ * @brief Queue a write of an output pin for tick u32DueMs
+ * @return RET_TYPE_INVALID_STATE for an input pin, RET_TYPE_MEMORY_ERROR
+ *         when MCP_SCHED_MAX writes are pending, RET_TYPE_INVALID_PARAMETER
+ *         for a deadline not in the future (or more than 2^31 ms ahead)
+ */
+eRetType_t eMcpSchedAdd(uint8_t u8Pin, bool bValue, uint32_t u32DueMs);
+
+/**
+ * @brief Apply every write due at u32NowMs (interrupt context on AVR)
+ */
+void vMcpSchedRun(uint32_t u32NowMs);
+
+/**
+ * @brief Main loop: run due writes where there is no tick ISR, then report
+ *        the done ones (Digital Twin + !GPIO_WRITE_AT)
+ */
+void vMcpSchedPoll(void);
+
+/**
+ * @brief How long the main loop may sleep: u32MaxMs, or less if a write is
+ *        due sooner
+ */
+uint32_t u32McpSchedIdleMs(uint32_t u32MaxMs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MCP_SCHED_H
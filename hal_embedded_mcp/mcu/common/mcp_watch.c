@@ -0,0 +1,124 @@
+//==============================================================================
+// HAL Embedded MCP - GPIO Watch Subscriptions
+//------------------------------------------------------------------------------
+//! @file
+//! @brief See mcp_watch.h for the event line and the rate limit
+//------------------------------------------------------------------------------
+
+// Includes ====================================================================
+#include "mcp_watch.h"
+#include "gpio_helper.h"
+#include "tool_registry.h"
+#include <stddef.h>
+#include <stdio.h>
+
+// Platform contract (like vPlatformDelayMs, see app_main.c)
+extern uint32_t u32PlatformGetTickMs(void);
+
+#ifdef PLATFORM_FARM
+// Subscriptions belong to a board: the farm keeps them per instance. It only
+// runs an instance when woken, so a held-back report asks for a wake-up.
+extern sMcpWatchTable_t *psFarmWatchTable(void);
+extern void vFarmWakeAtMs(uint32_t u32TickMs);
+#define MCP_WATCH_TABLE() psFarmWatchTable()
+#define MCP_WATCH_WAKE_AT(ms) vFarmWakeAtMs(ms)
+#else
+static sMcpWatchTable_t g_sMcpWatchTable;
+#define MCP_WATCH_TABLE() (&g_sMcpWatchTable)
+#define MCP_WATCH_WAKE_AT(ms) ((void)(ms)) // The loop polls every pass
+#endif
+
+// Private Function Prototypes ================================================
+static eRetType_t eMcpWatchSample(sMcpWatchTable_t *psTable, uint8_t u8Extra,
+                                  uint8_t *pu8Bits);
+
+// Functions ===================================================================
+
+/**
+ * @brief One snapshot covering every watched pin (plus u8Extra), without the
+ *        per-pin Digital Twin reports of eGpioHelperRead
+ */
+static eRetType_t eMcpWatchSample(sMcpWatchTable_t *psTable, uint8_t u8Extra,
+                                  uint8_t *pu8Bits) {
+  uint32_t u32Span = (uint32_t)u8Extra + 1;
+  for (uint8_t i = 0; i < psTable->u8Count; i++) {
+    if (psTable->asWatch[i].u8Pin >= u32Span)
+      u32Span = (uint32_t)psTable->asWatch[i].u8Pin + 1;
+  }
+  return eGpioHelperReadAll(pu8Bits, u32Span);
+}
+
+eRetType_t eMcpWatchSet(uint8_t u8Pin, uint16_t u16MinMs, bool *pbLevel) {
+  sMcpWatchTable_t *psTable = MCP_WATCH_TABLE();
+  uint8_t au8Bits[MCP_WATCH_MAX_PINS / 8];
+
+  if (psTable == NULL || pbLevel == NULL)
+    return RET_TYPE_NULL_POINTER;
+  if (u8Pin >= MCP_WATCH_MAX_PINS || u8Pin >= g_u32McpPinCount)
+    return RET_TYPE_INVALID_PARAMETER;
+
+  sMcpWatch_t *psWatch = NULL;
+  for (uint8_t i = 0; i < psTable->u8Count; i++) {
+    if (psTable->asWatch[i].u8Pin == u8Pin)
+      psWatch = &psTable->asWatch[i];
+  }
+  if (psWatch == NULL && psTable->u8Count >= MCP_WATCH_MAX)
+    return RET_TYPE_MEMORY_ERROR;
+
+  eRetType_t eRet = eMcpWatchSample(psTable, u8Pin, au8Bits);
+  if (eRet != RET_TYPE_SUCCESS)
+    return eRet;
+
+  if (psWatch == NULL)
+    psWatch = &psTable->asWatch[psTable->u8Count++];
+  // The caller reports the level now: it is the baseline of later events
+  psWatch->u8Pin = u8Pin;
+  psWatch->u8Level = (au8Bits[u8Pin >> 3] >> (u8Pin & 7)) & 1;
+  psWatch->u16MinMs = u16MinMs;
+  psWatch->u32LastMs = u32PlatformGetTickMs();
+  *pbLevel = psWatch->u8Level != 0;
+  return RET_TYPE_SUCCESS;
+}
+
+void vMcpWatchClear(uint8_t u8Pin) {
+  sMcpWatchTable_t *psTable = MCP_WATCH_TABLE();
+  if (psTable == NULL)
+    return;
+  for (uint8_t i = 0; i < psTable->u8Count; i++) {
+    if (psTable->asWatch[i].u8Pin == u8Pin) {
+      // Order does not matter: move the last one into the gap
+      psTable->asWatch[i] = psTable->asWatch[--psTable->u8Count];
+      return;
+    }
+  }
+}
+
+void vMcpWatchPoll(void) {
+  sMcpWatchTable_t *psTable = MCP_WATCH_TABLE();
+  uint8_t au8Bits[MCP_WATCH_MAX_PINS / 8];
+
+  if (psTable == NULL || psTable->u8Count == 0)
+    return; // Nothing watched: costs one compare per loop pass
+  if (eMcpWatchSample(psTable, 0, au8Bits) != RET_TYPE_SUCCESS)
+    return;
+
+  uint32_t u32Now = u32PlatformGetTickMs();
+  for (uint8_t i = 0; i < psTable->u8Count; i++) {
+    sMcpWatch_t *psWatch = &psTable->asWatch[i];
+    uint8_t u8Pin = psWatch->u8Pin;
+    uint8_t u8Level = (au8Bits[u8Pin >> 3] >> (u8Pin & 7)) & 1;
+    if (u8Level == psWatch->u8Level)
+      continue;
+    // Unsigned difference: correct across the 49-day tick wrap
+    if ((uint32_t)(u32Now - psWatch->u32LastMs) < psWatch->u16MinMs) {
+      // Held back; the level at the end of the interval goes out
+      MCP_WATCH_WAKE_AT(psWatch->u32LastMs + psWatch->u16MinMs);
+      continue;
+    }
+    psWatch->u8Level = u8Level;
+    psWatch->u32LastMs = u32Now;
+    // One printf per line: the farm sends each completed line as one frame
+    printf("!GPIO_EVENT %s %u %lu\n", g_apcMcpPinNames[u8Pin],
+           (unsigned)u8Level, (unsigned long)u32Now);
+  }
+}
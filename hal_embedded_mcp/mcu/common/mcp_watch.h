@@ -0,0 +1,73 @@
+//==============================================================================
+// HAL Embedded MCP - GPIO Watch Subscriptions
+//------------------------------------------------------------------------------
+//! @file
+//! @brief Pins the host asked to be told about when they change
+//!
+//! "gpio_watch PIN [MIN_MS]" subscribes a pin. The main loop then samples
+//! every watched pin once per pass (vMcpWatchPoll) and sends an event line
+//! only when a level differs from the last one reported:
+//!
+//!   !GPIO_EVENT <pin> <0|1> <tick_ms>
+//!
+//! Events answer no request, so they carry the "!" tag instead of "#<id>".
+//! MIN_MS rate-limits a pin: a change within MIN_MS of the previous report
+//! is held back and the level at the end of the interval is reported then
+//! (nothing, if the pin went back). tick_ms is u32PlatformGetTickMs().
+//------------------------------------------------------------------------------
+
+#ifndef MCP_WATCH_H
+#define MCP_WATCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Includes ====================================================================
+#include "common.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Constants ===================================================================
+#define MCP_WATCH_MAX 8       // Subscriptions per board
+#define MCP_WATCH_MAX_PINS 64 // Pin handles that can be watched
+
+// Type Definitions ============================================================
+typedef struct {
+  uint8_t u8Pin;      // Pin handle (config.json "pins" index)
+  uint8_t u8Level;    // Last level reported
+  uint16_t u16MinMs;  // Minimum time between two reports
+  uint32_t u32LastMs; // Tick of the last report (or of the subscription)
+} sMcpWatch_t;
+
+/** Zero-initialised = no subscriptions */
+typedef struct {
+  sMcpWatch_t asWatch[MCP_WATCH_MAX];
+  uint8_t u8Count;
+} sMcpWatchTable_t;
+
+// Function Prototypes =========================================================
+
+/**
+ * @brief Watch a pin, or change the interval of an existing subscription
+ * @param pbLevel Current level, the baseline for later events
+ * @return RET_TYPE_MEMORY_ERROR when MCP_WATCH_MAX pins are watched,
+ *         RET_TYPE_INVALID_PARAMETER for a handle >= MCP_WATCH_MAX_PINS
+ */
+eRetType_t eMcpWatchSet(uint8_t u8Pin, uint16_t u16MinMs, bool *pbLevel);
+
+/**
+ * @brief Stop watching a pin (no-op if it is not watched)
+ */
+void vMcpWatchClear(uint8_t u8Pin);
+
+/**
+ * @brief Sample the watched pins and send the due event lines (main loop)
+ */
+void vMcpWatchPoll(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MCP_WATCH_H
@@ -0,0 +1,439 @@
+//==============================================================================
+// MCU Farm - Platform Adapter
+//------------------------------------------------------------------------------
+//! @file
+//! @brief Platform contract for the common firmware when it runs as one of
+//!        many farm instances: GPIO backend, UART line hooks, printf sink
+//------------------------------------------------------------------------------
+
+// Includes ====================================================================
+#include "mcu_farm.h"
+#include "farm_stdio.h"
+#include "gpio_config.h"
+#include "gpioLib.h"
+#include "gpio_helper.h"
+#include "helper_common.h"
+#include "uart_line_callback.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Constants ===================================================================
+// Dispatch round, as on the AVR: up to FARM_MCP_WEIGHT commands, then
+// FARM_DT_WEIGHT twin lines (see mcu_farm.h for the lanes)
+#define FARM_MCP_WEIGHT 2
+#define FARM_DT_WEIGHT 1
+
+// Type Definitions ============================================================
+typedef struct {
+  const char *pcName;
+  eGpioDirection_t eDirection;
+  eGpioPull_t ePull;
+} sFarmPin_t;
+
+// Static Variables ============================================================
+// Pin table is shared by all instances (same firmware, same config.json);
+// only the levels are per instance. Filled by the init, before any worker.
+static sFarmPin_t g_asFarmPins[FARM_MAX_PINS];
+static uint32_t g_u32FarmPinCount = 0;
+static uint32_t g_u32FarmDefaultValues = 0;
+static bool g_bFarmDtSync = false;
+
+static __thread sFarmInstance_t *g_psFarmCurrent = NULL;
+
+// Private Function Prototypes ================================================
+static int32_t iFarmFindPin(const char *pcPinName);
+static void vFarmGpioInit(void);
+static eRetType_t eFarmGpioConfigure(const sGpioConfig_t *psConfig);
+static eRetType_t eFarmGpioRead(const char *pcPinName, bool *pbValue);
+static eRetType_t eFarmGpioWrite(const char *pcPinName, bool bValue);
+static eRetType_t eFarmGpioReadAll(uint8_t *pu8Bits, uint32_t u32Count);
+static eRetType_t eFarmGpioWriteMany(const uint8_t *pu8Mask,
+                                     const uint8_t *pu8Bits, uint32_t u32Count);
+
+// Interface ===================================================================
+const sGpioInterface_t sGpioInterfaceFarm = {
+    .vHalGpioInitFunc = vFarmGpioInit,
+    .eHalGpioConfigureFunc = eFarmGpioConfigure,
+    .eHalGpioReadFunc = eFarmGpioRead,
+    .eHalGpioWriteFunc = eFarmGpioWrite,
+    .eHalGpioReadAllFunc = eFarmGpioReadAll,
+    .eHalGpioWriteManyFunc = eFarmGpioWriteMany,
+};
+
+// Farm Control ================================================================
+
+void vFarmSetCurrent(sFarmInstance_t *psInstance) {
+  g_psFarmCurrent = psInstance;
+}
+
+void vFarmResetPins(sFarmInstance_t *psInstance) {
+  if (psInstance != NULL) {
+    psInstance->u32PinValues = g_u32FarmDefaultValues;
+  }
+}
+
+void vFarmSetDtSync(bool bEnable) { g_bFarmDtSync = bEnable; }
+
+extern void vAppLoop(void);
+
+void vFarmRunInstance(void *pvInstance) {
+  sFarmInstance_t *psInstance = (sFarmInstance_t *)pvInstance;
+  atomic_store(&psInstance->iState, FARM_STATE_RUNNING);
+
+  vFarmSetCurrent(psInstance);
+  for (;;) {
+    vAppLoop();
+
+    int iExpected = FARM_STATE_RUNNING;
+    if (atomic_compare_exchange_strong(&psInstance->iState, &iExpected,
+                                       FARM_STATE_IDLE)) {
+      break;
+    }
+    // Woken while running (new line due): go again on this worker
+    atomic_store(&psInstance->iState, FARM_STATE_RUNNING);
+  }
+  vFarmSetCurrent(NULL);
+}
+
+// Platform Contract (see app_main.c) ==========================================
+
+const sGpioInterface_t *psGetPlatformGpioInterface(void) {
+  return &sGpioInterfaceFarm;
+}
+
+void vPlatformDelayMs(uint32_t u32Ms) {
+  // The loop's idle delay is where a farm instance yields its worker: it
+  // is only run again when a line becomes due, so there is nothing to wait
+  // for here.
+  (void)u32Ms;
+}
+
+uint32_t u32PlatformGetTickMs(void) {
+  return (uint32_t)(u64FarmNowUs() / 1000u);
+}
+
+bool bUartDispatchPendingLine(void) {
+  if (g_psFarmCurrent == NULL) {
+    return false;
+  }
+
+  char acLine[FARM_LINE_SIZE];
+  uint32_t u32Len = 0;
+  bool bFrame = false;
+  bool bAny = false;
+  // A twin lane's worth per pass: a flood cannot keep the worker here
+  uint32_t u32DtBudget = FARM_RX_LINES;
+  bool bMore = true;
+  while (bMore) {
+    bMore = false;
+    for (uint32_t i = 0; i < FARM_MCP_WEIGHT; i++) {
+      if (!bFarmTakeRxLine(g_psFarmCurrent, FARM_RX_MCP, acLine, sizeof(acLine),
+                           &u32Len, &bFrame))
+        break;
+      if (bFrame)
+        vOnUartFrameReceived((const uint8_t *)acLine, (uint16_t)u32Len);
+      else
+        vOnUartLineReceived(acLine);
+      bAny = bMore = true;
+    }
+    for (uint32_t i = 0; i < FARM_DT_WEIGHT && u32DtBudget > 0; i++) {
+      if (!bFarmTakeRxLine(g_psFarmCurrent, FARM_RX_DT, acLine, sizeof(acLine),
+                           &u32Len, &bFrame))
+        break;
+      u32DtBudget--;
+      vApplyReceivedJsonLine(acLine);
+      bAny = bMore = true;
+    }
+  }
+  if (u32DtBudget == 0) {
+    vFarmWakeInstance(g_psFarmCurrent); // More may be due: another pass
+  }
+  return bAny;
+}
+
+void vUartSetFramed(bool bFramed) {
+  if (g_psFarmCurrent != NULL)
+    g_psFarmCurrent->bFramed = bFramed;
+}
+
+bool bUartIsFramed(void) {
+  return g_psFarmCurrent != NULL && g_psFarmCurrent->bFramed;
+}
+
+void vUartGetRxFlow(uint8_t *pu8Slots, uint8_t *pu8Free,
+                    uint32_t *pu32Overruns) {
+  uint32_t u32Queued = 0;
+  *pu8Slots = FARM_RX_LINES;
+  *pu8Free = FARM_RX_LINES;
+  *pu32Overruns = 0;
+  if (g_psFarmCurrent == NULL)
+    return;
+  vFarmGetRxFlow(g_psFarmCurrent, &u32Queued, pu32Overruns);
+  *pu8Free = (uint8_t)(FARM_RX_LINES - u32Queued);
+}
+
+uint32_t u32UartTakeRxOverruns(void) {
+  uint32_t u32Queued = 0;
+  uint32_t u32Total = 0;
+  if (g_psFarmCurrent == NULL)
+    return 0;
+  vFarmGetRxFlow(g_psFarmCurrent, &u32Queued, &u32Total);
+  uint32_t u32New = u32Total - g_psFarmCurrent->u32RxReported;
+  g_psFarmCurrent->u32RxReported = u32Total;
+  return u32New;
+}
+
+sMcpWatchTable_t *psFarmWatchTable(void) {
+  return (g_psFarmCurrent != NULL) ? &g_psFarmCurrent->sWatch : NULL;
+}
+
+sMcpSchedQueue_t *psFarmSchedQueue(void) {
+  return (g_psFarmCurrent != NULL) ? &g_psFarmCurrent->sSched : NULL;
+}
+
+sGpioHelperDtState_t *psFarmGpioHelperDtState(void) {
+  return (g_psFarmCurrent != NULL) ? &g_psFarmCurrent->sDtState : NULL;
+}
+
+void vFarmWakeAtMs(uint32_t u32TickMs) {
+  // An instance only runs when woken: the loop cannot just poll again
+  if (g_psFarmCurrent == NULL)
+    return;
+  uint64_t u64NowUs = u64FarmNowUs();
+  int32_t i32AheadMs = (int32_t)(u32TickMs - (uint32_t)(u64NowUs / 1000u));
+  uint64_t u64DueUs = (u64NowUs / 1000u) * 1000u;
+  if (i32AheadMs > 0)
+    u64DueUs += (uint64_t)i32AheadMs * 1000u;
+  vFarmWakeInstanceAt(g_psFarmCurrent, u64DueUs);
+}
+
+void vUartWriteRaw(const uint8_t *pu8Data, uint16_t u16Len) {
+  if (g_psFarmCurrent != NULL)
+    vFarmQueueTx(g_psFarmCurrent, (const char *)pu8Data, u16Len);
+}
+
+/** Twin input level of a pin. Like eGpioHelperSetSimulated on hardware: the
+ *  twin drives the level, any direction (farm pin i = config pin i). */
+void vPlatformApplyDtPin(uint32_t u32Pin, bool bValue) {
+  if (g_psFarmCurrent == NULL || u32Pin >= g_u32FarmPinCount)
+    return;
+  uint32_t u32Bit = 1u << u32Pin;
+  if (bValue)
+    g_psFarmCurrent->u32PinValues |= u32Bit;
+  else
+    g_psFarmCurrent->u32PinValues &= ~u32Bit;
+}
+
+void vApplyReceivedJsonLine(const char *pcLine) {
+  (void)bGpioHelperParseDtLine(pcLine, vPlatformApplyDtPin);
+}
+
+// Helper / Digital Twin Bridge ================================================
+
+void vHelperSend(const char *pcCmd, const char *pcPin, int iValue) {
+  if (g_bFarmDtSync && !bOnHelperSend(pcCmd, pcPin, iValue)) {
+    iFarmPrintf("{\"t\":\"%s\",\"p\":\"%s\",\"v\":%d}\n", pcCmd, pcPin,
+                iValue);
+  }
+}
+
+void vHelperSendMany(const char *pcCmd, const char *const *ppcPins,
+                     const int *piValues, uint32_t u32Count) {
+  if (!g_bFarmDtSync || u32Count == 0) {
+    return;
+  }
+  if (bOnHelperSend(pcCmd, ppcPins[0], piValues[0])) {
+    for (uint32_t i = 1; i < u32Count; i++) {
+      bOnHelperSend(pcCmd, ppcPins[i], piValues[i]);
+    }
+    return;
+  }
+  // Pieces are assembled into one line (and one UART frame) up to '\n'
+  iFarmPrintf("{\"t\":\"%s\",\"s\":{", pcCmd);
+  for (uint32_t i = 0; i < u32Count; i++) {
+    iFarmPrintf("%s\"%s\":%d", (i > 0) ? "," : "", ppcPins[i], piValues[i]);
+  }
+  iFarmPrintf("}}\n");
+}
+
+void vHelperSendString(const char *pcCmd, const char *pcPin,
+                       const char *pcValue) {
+  if (g_bFarmDtSync) {
+    iFarmPrintf("{\"t\":\"%s\",\"p\":\"%s\",\"v\":\"%s\"}\n", pcCmd, pcPin,
+                pcValue);
+  }
+}
+
+// printf Sink (see farm_stdio.h) ==============================================
+
+int iFarmPrintf(const char *pcFormat, ...) {
+  char acBuffer[FARM_LINE_SIZE * 2];
+  va_list args;
+  va_start(args, pcFormat);
+  int iLen = vsnprintf(acBuffer, sizeof(acBuffer), pcFormat, args);
+  va_end(args);
+  if (iLen < 0) {
+    return iLen;
+  }
+
+  sFarmInstance_t *psInstance = g_psFarmCurrent;
+  if (psInstance == NULL) {
+    return (int)fwrite(acBuffer, 1, strlen(acBuffer), stdout);
+  }
+
+  // Assemble lines; each complete line goes out as one paced UART frame
+  uint32_t u32Len = strlen(acBuffer);
+  for (uint32_t i = 0; i < u32Len; i++) {
+    if (psInstance->u16TxLen < FARM_LINE_SIZE - 1) {
+      psInstance->acTxAssembly[psInstance->u16TxLen++] = acBuffer[i];
+    }
+    if (acBuffer[i] == '\n') {
+      if (psInstance->acTxAssembly[psInstance->u16TxLen - 1] != '\n') {
+        psInstance->acTxAssembly[psInstance->u16TxLen - 1] = '\n';
+      }
+      vFarmQueueTx(psInstance, psInstance->acTxAssembly,
+                   psInstance->u16TxLen);
+      psInstance->u16TxLen = 0;
+    }
+  }
+  return iLen;
+}
+
+// Private Functions ===========================================================
+
+static int32_t iFarmFindPin(const char *pcPinName) {
+  if (pcPinName == NULL) {
+    return -1;
+  }
+  for (uint32_t i = 0; i < g_u32FarmPinCount; i++) {
+    if (strcmp(g_asFarmPins[i].pcName, pcPinName) == 0) {
+      return (int32_t)i;
+    }
+  }
+  return -1;
+}
+
+static void vFarmGpioInit(void) {
+  const sGpioPinConfig_t *psPinConfig = g_psGpioPinConfigs;
+  while (psPinConfig->pcPinName != NULL) {
+    sGpioConfig_t sConfig = {.pcPinName = psPinConfig->pcPinName,
+                             .eDirection = psPinConfig->eDirection,
+                             .ePull = psPinConfig->ePull};
+    if (eFarmGpioConfigure(&sConfig) != RET_TYPE_SUCCESS) {
+      fprintf(stderr, "[GPIO FARM] [ERROR] Cannot configure %s\n",
+              psPinConfig->pcPinName);
+    }
+    psPinConfig++;
+  }
+  fprintf(stderr, "[GPIO FARM] %u pins per instance.\n",
+          (unsigned)g_u32FarmPinCount);
+}
+
+static eRetType_t eFarmGpioConfigure(const sGpioConfig_t *psConfig) {
+  if (psConfig == NULL || psConfig->pcPinName == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+
+  int32_t iPin = iFarmFindPin(psConfig->pcPinName);
+  if (iPin < 0) {
+    if (g_u32FarmPinCount >= FARM_MAX_PINS) {
+      return RET_TYPE_MEMORY_ERROR;
+    }
+    iPin = (int32_t)g_u32FarmPinCount++;
+    g_asFarmPins[iPin].pcName = psConfig->pcPinName;
+  }
+  g_asFarmPins[iPin].eDirection = psConfig->eDirection;
+  g_asFarmPins[iPin].ePull = psConfig->ePull;
+
+  uint32_t u32Bit = 1u << (uint32_t)iPin;
+  if (psConfig->ePull == GPIO_PULL_UP) {
+    g_u32FarmDefaultValues |= u32Bit;
+  } else {
+    g_u32FarmDefaultValues &= ~u32Bit;
+  }
+  return RET_TYPE_SUCCESS;
+}
+
+static eRetType_t eFarmGpioRead(const char *pcPinName, bool *pbValue) {
+  if (pbValue == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+  if (g_psFarmCurrent == NULL) {
+    return RET_TYPE_NOT_INITIALIZED;
+  }
+  int32_t iPin = iFarmFindPin(pcPinName);
+  if (iPin < 0) {
+    return RET_TYPE_NOT_FOUND;
+  }
+  *pbValue = (g_psFarmCurrent->u32PinValues >> (uint32_t)iPin) & 1u;
+  return RET_TYPE_SUCCESS;
+}
+
+/* Pin i is bit i of the instance word: the snapshot is one load */
+static eRetType_t eFarmGpioReadAll(uint8_t *pu8Bits, uint32_t u32Count) {
+  if (pu8Bits == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+  if (g_psFarmCurrent == NULL) {
+    return RET_TYPE_NOT_INITIALIZED;
+  }
+  if (u32Count > g_u32FarmPinCount) {
+    return RET_TYPE_INVALID_PARAMETER;
+  }
+  uint32_t u32Values = g_psFarmCurrent->u32PinValues;
+  for (uint32_t i = 0; i < u32Count; i += 8) {
+    uint8_t u8Byte = (uint8_t)(u32Values >> i);
+    if (u32Count - i < 8) {
+      u8Byte &= (uint8_t)((1u << (u32Count - i)) - 1u);
+    }
+    pu8Bits[i >> 3] = u8Byte;
+  }
+  return RET_TYPE_SUCCESS;
+}
+
+/* All pins live in one instance word: the update is one store */
+static eRetType_t eFarmGpioWriteMany(const uint8_t *pu8Mask,
+                                     const uint8_t *pu8Bits,
+                                     uint32_t u32Count) {
+  if (pu8Mask == NULL || pu8Bits == NULL) {
+    return RET_TYPE_NULL_POINTER;
+  }
+  if (g_psFarmCurrent == NULL) {
+    return RET_TYPE_NOT_INITIALIZED;
+  }
+  if (u32Count > g_u32FarmPinCount) {
+    return RET_TYPE_INVALID_PARAMETER;
+  }
+  uint32_t u32Mask = 0;
+  uint32_t u32Bits = 0;
+  for (uint32_t i = 0; i < u32Count; i += 8) {
+    uint32_t u32ByteMask = pu8Mask[i >> 3];
+    if (u32Count - i < 8) {
+      u32ByteMask &= (1u << (u32Count - i)) - 1u;
+    }
+    u32Mask |= u32ByteMask << i;
+    u32Bits |= ((uint32_t)pu8Bits[i >> 3] & u32ByteMask) << i;
+  }
+  g_psFarmCurrent->u32PinValues =
+      (g_psFarmCurrent->u32PinValues & ~u32Mask) | u32Bits;
+  return RET_TYPE_SUCCESS;
+}
+
+static eRetType_t eFarmGpioWrite(const char *pcPinName, bool bValue) {
+  if (g_psFarmCurrent == NULL) {
+    return RET_TYPE_NOT_INITIALIZED;
+  }
+  int32_t iPin = iFarmFindPin(pcPinName);
+  if (iPin < 0) {
+    return RET_TYPE_NOT_FOUND;
+  }
+  uint32_t u32Bit = 1u << (uint32_t)iPin;
+  if (bValue) {
+    g_psFarmCurrent->u32PinValues |= u32Bit;
+  } else {
+    g_psFarmCurrent->u32PinValues &= ~u32Bit;
+  }
+  return RET_TYPE_SUCCESS;
+}
@@ -0,0 +1,244 @@
+//==============================================================================
+// MCU Farm - Work-Stealing Thread Pool
+//------------------------------------------------------------------------------
+//! @file
+//! @brief Per-worker locked deques with head stealing and condvar idle sleep
+//------------------------------------------------------------------------------
+
+// Includes ====================================================================
+#include "farm_pool.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+// Type Definitions ============================================================
+typedef struct {
+  pthread_mutex_t sLock;
+  void **ppvSlots;
+  uint32_t u32Head; // Steal end
+  uint32_t u32Tail; // Owner end
+  sFarmPoolStats_t sStats;
+  pthread_t sThread;
+  uint32_t u32Index;
+} sFarmWorker_t;
+
+// Static Variables ============================================================
+static sFarmWorker_t *g_asFarmWorkers = NULL;
+static uint32_t g_u32FarmWorkerCount = 0;
+static uint32_t g_u32FarmMask = 0;
+static pfFarmTask_t g_pfFarmRun = NULL;
+
+static atomic_uint g_u32FarmPending;  // Tasks in any deque
+static atomic_uint g_u32FarmSleeping; // Workers blocked on the condition
+static atomic_uint g_u32FarmNextWorker;
+static atomic_bool g_bFarmRunning;
+static pthread_mutex_t g_sFarmIdleLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_sFarmIdleCond = PTHREAD_COND_INITIALIZER;
+
+static __thread sFarmWorker_t *g_psFarmSelf = NULL;
+
+// Private Function Prototypes ================================================
+static bool bFP_Push(sFarmWorker_t *psWorker, void *pvTask);
+static void *pvFP_PopTail(sFarmWorker_t *psWorker);
+static void *pvFP_StealHead(sFarmWorker_t *psWorker);
+static void *pvFP_Find(sFarmWorker_t *psSelf, bool *pbStolen);
+static void *pvFP_WorkerMain(void *pvArg);
+
+// Functions ===================================================================
+
+eRetType_t eFarmPoolStart(uint32_t u32Workers, uint32_t u32Capacity,
+                          pfFarmTask_t pfRun) {
+  if (pfRun == NULL || u32Workers == 0 || u32Capacity == 0) {
+    return RET_TYPE_INVALID_PARAMETER;
+  }
+  if (g_asFarmWorkers != NULL) {
+    return RET_TYPE_ALREADY_EXISTS;
+  }
+
+  uint32_t u32Slots = 1;
+  while (u32Slots < u32Capacity) {
+    u32Slots <<= 1;
+  }
+
+  g_asFarmWorkers = calloc(u32Workers, sizeof(sFarmWorker_t));
+  if (g_asFarmWorkers == NULL) {
+    return RET_TYPE_MEMORY_ERROR;
+  }
+  for (uint32_t i = 0; i < u32Workers; i++) {
+    g_asFarmWorkers[i].ppvSlots = calloc(u32Slots, sizeof(void *));
+    if (g_asFarmWorkers[i].ppvSlots == NULL) {
+      for (uint32_t j = 0; j < i; j++) {
+        free(g_asFarmWorkers[j].ppvSlots);
+      }
+      free(g_asFarmWorkers);
+      g_asFarmWorkers = NULL;
+      return RET_TYPE_MEMORY_ERROR;
+    }
+    pthread_mutex_init(&g_asFarmWorkers[i].sLock, NULL);
+    g_asFarmWorkers[i].u32Index = i;
+  }
+
+  g_u32FarmWorkerCount = u32Workers;
+  g_u32FarmMask = u32Slots - 1;
+  g_pfFarmRun = pfRun;
+  atomic_store(&g_u32FarmPending, 0);
+  atomic_store(&g_u32FarmSleeping, 0);
+  atomic_store(&g_bFarmRunning, true);
+
+  for (uint32_t i = 0; i < u32Workers; i++) {
+    if (pthread_create(&g_asFarmWorkers[i].sThread, NULL, pvFP_WorkerMain,
+                       &g_asFarmWorkers[i]) != 0) {
+      g_u32FarmWorkerCount = i;
+      vFarmPoolStop();
+      return RET_TYPE_FAIL;
+    }
+  }
+  return RET_TYPE_SUCCESS;
+}
+
+eRetType_t eFarmPoolSubmit(void *pvTask) {
+  if (g_asFarmWorkers == NULL) {
+    return RET_TYPE_NOT_INITIALIZED;
+  }
+
+  sFarmWorker_t *psTarget = g_psFarmSelf;
+  if (psTarget == NULL) {
+    uint32_t u32Next = atomic_fetch_add(&g_u32FarmNextWorker, 1);
+    psTarget = &g_asFarmWorkers[u32Next % g_u32FarmWorkerCount];
+  }
+
+  // Count before publishing so Pending never underflows when a worker pops
+  // the task first. Pairs with the sleeper's Sleeping++ / Pending check
+  // (both seq_cst): either we see the sleeper, or it sees our task.
+  atomic_fetch_add(&g_u32FarmPending, 1);
+  if (!bFP_Push(psTarget, pvTask)) {
+    atomic_fetch_sub(&g_u32FarmPending, 1);
+    return RET_TYPE_MEMORY_ERROR;
+  }
+  if (atomic_load(&g_u32FarmSleeping) > 0) {
+    pthread_mutex_lock(&g_sFarmIdleLock);
+    pthread_cond_signal(&g_sFarmIdleCond);
+    pthread_mutex_unlock(&g_sFarmIdleLock);
+  }
+  return RET_TYPE_SUCCESS;
+}
+
+void vFarmPoolStop(void) {
+  if (g_asFarmWorkers == NULL) {
+    return;
+  }
+
+  pthread_mutex_lock(&g_sFarmIdleLock);
+  atomic_store(&g_bFarmRunning, false);
+  pthread_cond_broadcast(&g_sFarmIdleCond);
+  pthread_mutex_unlock(&g_sFarmIdleLock);
+
+  for (uint32_t i = 0; i < g_u32FarmWorkerCount; i++) {
+    pthread_join(g_asFarmWorkers[i].sThread, NULL);
+  }
+  for (uint32_t i = 0; i < g_u32FarmWorkerCount; i++) {
+    pthread_mutex_destroy(&g_asFarmWorkers[i].sLock);
+    free(g_asFarmWorkers[i].ppvSlots);
+  }
+  free(g_asFarmWorkers);
+  g_asFarmWorkers = NULL;
+}
+
+uint32_t u32FarmPoolWorkers(void) { return g_u32FarmWorkerCount; }
+
+void vFarmPoolGetStats(uint32_t u32Worker, sFarmPoolStats_t *psStats) {
+  if (psStats == NULL || g_asFarmWorkers == NULL ||
+      u32Worker >= g_u32FarmWorkerCount) {
+    return;
+  }
+  sFarmWorker_t *psWorker = &g_asFarmWorkers[u32Worker];
+  pthread_mutex_lock(&psWorker->sLock);
+  *psStats = psWorker->sStats;
+  pthread_mutex_unlock(&psWorker->sLock);
+}
+
+// Private Functions ===========================================================
+
+static bool bFP_Push(sFarmWorker_t *psWorker, void *pvTask) {
+  pthread_mutex_lock(&psWorker->sLock);
+  bool bOk = (psWorker->u32Tail - psWorker->u32Head) <= g_u32FarmMask;
+  if (bOk) {
+    psWorker->ppvSlots[psWorker->u32Tail++ & g_u32FarmMask] = pvTask;
+  }
+  pthread_mutex_unlock(&psWorker->sLock);
+  return bOk;
+}
+
+static void *pvFP_PopTail(sFarmWorker_t *psWorker) {
+  void *pvTask = NULL;
+  pthread_mutex_lock(&psWorker->sLock);
+  if (psWorker->u32Tail != psWorker->u32Head) {
+    pvTask = psWorker->ppvSlots[--psWorker->u32Tail & g_u32FarmMask];
+  }
+  pthread_mutex_unlock(&psWorker->sLock);
+  return pvTask;
+}
+
+static void *pvFP_StealHead(sFarmWorker_t *psWorker) {
+  void *pvTask = NULL;
+  if (pthread_mutex_trylock(&psWorker->sLock) != 0) {
+    return NULL; // Busy victim: try the next one rather than queue up
+  }
+  if (psWorker->u32Tail != psWorker->u32Head) {
+    pvTask = psWorker->ppvSlots[psWorker->u32Head++ & g_u32FarmMask];
+  }
+  pthread_mutex_unlock(&psWorker->sLock);
+  return pvTask;
+}
+
+static void *pvFP_Find(sFarmWorker_t *psSelf, bool *pbStolen) {
+  void *pvTask = pvFP_PopTail(psSelf);
+  *pbStolen = false;
+  if (pvTask != NULL) {
+    return pvTask;
+  }
+
+  // Two sweeps: the first may skip victims whose lock was held
+  for (uint32_t u32Sweep = 0; u32Sweep < 2; u32Sweep++) {
+    for (uint32_t i = 1; i < g_u32FarmWorkerCount; i++) {
+      uint32_t u32Victim = (psSelf->u32Index + i) % g_u32FarmWorkerCount;
+      pvTask = pvFP_StealHead(&g_asFarmWorkers[u32Victim]);
+      if (pvTask != NULL) {
+        *pbStolen = true;
+        return pvTask;
+      }
+    }
+  }
+  return NULL;
+}
+
+static void *pvFP_WorkerMain(void *pvArg) {
+  sFarmWorker_t *psSelf = (sFarmWorker_t *)pvArg;
+  g_psFarmSelf = psSelf;
+
+  while (atomic_load(&g_bFarmRunning)) {
+    bool bStolen;
+    void *pvTask = pvFP_Find(psSelf, &bStolen);
+    if (pvTask != NULL) {
+      atomic_fetch_sub(&g_u32FarmPending, 1);
+      g_pfFarmRun(pvTask);
+
+      pthread_mutex_lock(&psSelf->sLock);
+      psSelf->sStats.u64Executed++;
+      psSelf->sStats.u64Stolen += bStolen ? 1u : 0u;
+      pthread_mutex_unlock(&psSelf->sLock);
+      continue;
+    }
+
+    pthread_mutex_lock(&g_sFarmIdleLock);
+    atomic_fetch_add(&g_u32FarmSleeping, 1);
+    while (atomic_load(&g_u32FarmPending) == 0 &&
+           atomic_load(&g_bFarmRunning)) {
+      pthread_cond_wait(&g_sFarmIdleCond, &g_sFarmIdleLock);
+    }
+    atomic_fetch_sub(&g_u32FarmSleeping, 1);
+    pthread_mutex_unlock(&g_sFarmIdleLock);
+  }
+  return NULL;
+}
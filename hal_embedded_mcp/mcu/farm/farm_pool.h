@@ -0,0 +1,62 @@
+//==============================================================================
+// MCU Farm - Work-Stealing Thread Pool
+//------------------------------------------------------------------------------
+//! @file
+//! @brief Fixed worker pool: one deque per worker, idle workers steal
+//!
+//! Owners push and pop at the tail (LIFO keeps a just-woken instance hot in
+//! the cache that produced it); thieves take from the head. Each deque has
+//! its own lock, so workers only contend when stealing. Submissions from
+//! outside the pool (the I/O thread) are spread round-robin.
+//------------------------------------------------------------------------------
+
+#ifndef FARM_POOL_H
+#define FARM_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Includes ====================================================================
+#include "common.h"
+#include <stdint.h>
+
+// Type Definitions ============================================================
+typedef void (*pfFarmTask_t)(void *pvTask);
+
+typedef struct {
+  uint64_t u64Executed; // Tasks run by this worker
+  uint64_t u64Stolen;   // ... of which taken from another worker's deque
+} sFarmPoolStats_t;
+
+// Function Prototypes =========================================================
+
+/**
+ * @brief Start u32Workers threads running pfRun on submitted tasks
+ * @param u32Capacity Max tasks queued at once (each deque is sized for all)
+ * @return RET_TYPE_MEMORY_ERROR / RET_TYPE_FAIL if allocation or thread
+ *         creation fails
+ */
+eRetType_t eFarmPoolStart(uint32_t u32Workers, uint32_t u32Capacity,
+                          pfFarmTask_t pfRun);
+
+/**
+ * @brief Queue a task (any thread); workers push to their own deque
+ * @return RET_TYPE_MEMORY_ERROR if the target deque is full
+ */
+eRetType_t eFarmPoolSubmit(void *pvTask);
+
+/**
+ * @brief Stop and join all workers; queued tasks are dropped
+ */
+void vFarmPoolStop(void);
+
+uint32_t u32FarmPoolWorkers(void);
+
+void vFarmPoolGetStats(uint32_t u32Worker, sFarmPoolStats_t *psStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FARM_POOL_H
@@ -0,0 +1,20 @@
+//==============================================================================
+// MCU Farm - Firmware stdout Redirection
+//------------------------------------------------------------------------------
+// Force-included (-include) into the firmware sources of the farm build only.
+// On the boards, printf goes to the UART; here it must reach the UART of the
+// instance that is running, so printf is routed to iFarmPrintf, which writes
+// to the current instance's TX queue (see farm_platform.c).
+//------------------------------------------------------------------------------
+
+#ifndef FARM_STDIO_H
+#define FARM_STDIO_H
+
+#include <stdio.h> // Declare the real printf before renaming it
+
+int iFarmPrintf(const char *pcFormat, ...)
+    __attribute__((format(printf, 1, 2)));
+
+#define printf iFarmPrintf
+
+#endif // FARM_STDIO_H
@@ -0,0 +1,733 @@
+//==============================================================================
+// MCU Farm - Host Process
+//------------------------------------------------------------------------------
+//! @file
+//! @brief Runs N firmware instances, each behind its own pseudo-terminal
+//!
+//! One I/O thread owns every PTY master in a single epoll set and models the
+//! UART timing: received bytes are released to the firmware only after their
+//! wire time (10 bits per byte at the instance baud) plus latency; responses
+//! are held back the same way. A timerfd armed to the earliest pending
+//! release drives both directions. When a line is due, the instance is
+//! handed to the work-stealing pool, which runs one vAppLoop() pass for it.
+//!
+//! Usage: hal_mcp_farm [-n count] [-w workers] [-b baud] [-l latency_us]
+//!                     [-c link.cfg] [-L link_dir] [-t seconds] [-d]
+//------------------------------------------------------------------------------
+
+#define _GNU_SOURCE // ptsname, O_CLOEXEC
+
+// Includes ====================================================================
+#include "farm_pool.h"
+#include "mcu_farm.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/timerfd.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+// Constants ===================================================================
+#define FARM_DEFAULT_INSTANCES 8
+#define FARM_READ_CHUNK 512
+#define FARM_MAX_EVENTS 64
+#define FARM_TAG_TIMER UINT64_MAX
+#define FARM_TAG_WAKE (UINT64_MAX - 1)
+
+#define FARM_TIMER_RX 0 // A received line becomes due: run the instance
+#define FARM_TIMER_TX 1 // A response becomes due: write it to the PTY
+#define FARM_TIMER_WAKE 2 // The firmware asked to run again (watch, write_at)
+
+// Type Definitions ============================================================
+typedef struct {
+  uint64_t u64DueUs;
+  uint32_t u32Instance;
+  uint8_t u8Kind;
+} sFarmTimer_t;
+
+// Static Variables ============================================================
+static sFarmInstance_t *g_asFarmInstances = NULL;
+static uint32_t g_u32FarmInstanceCount = 0;
+static const char *g_pcFarmLinkDir = NULL;
+
+// Release-time min-heap, shared by the I/O thread (RX) and workers (TX)
+static pthread_mutex_t g_sFarmTimerLock = PTHREAD_MUTEX_INITIALIZER;
+static sFarmTimer_t *g_asFarmTimers = NULL;
+static uint32_t g_u32FarmTimerCount = 0;
+static uint32_t g_u32FarmTimerCapacity = 0;
+
+static int g_iFarmEpollFd = -1;
+static int g_iFarmTimerFd = -1;
+static int g_iFarmWakeFd = -1; // Workers: "the earliest deadline changed"
+static volatile sig_atomic_t g_bFarmStop = 0;
+
+// Private Function Prototypes ================================================
+static uint32_t u32Farm_ByteUs(const sFarmInstance_t *psInstance);
+static void vFarm_TimerPush(uint64_t u64DueUs, uint32_t u32Instance,
+                            uint8_t u8Kind);
+static bool bFarm_TimerPopDue(uint64_t u64NowUs, sFarmTimer_t *psTimer);
+static void vFarm_TimerArm(void);
+static void vFarm_RunTimers(void);
+static void vFarm_OnReadable(sFarmInstance_t *psInstance);
+static void vFarm_FlushTx(sFarmInstance_t *psInstance, uint64_t u64NowUs);
+static bool bFarm_OpenPty(sFarmInstance_t *psInstance);
+static bool bFarm_LoadLinkConfig(const char *pcPath);
+static void vFarm_PrintStats(void);
+static void vFarm_OnSignal(int iSignal);
+static void vFarm_Usage(const char *pcProg);
+
+extern bool vAppInit(void);
+
+// Functions ===================================================================
+
+uint64_t u64FarmNowUs(void) {
+  struct timespec sNow;
+  clock_gettime(CLOCK_MONOTONIC, &sNow);
+  return (uint64_t)sNow.tv_sec * 1000000u + (uint64_t)sNow.tv_nsec / 1000u;
+}
+
+void vFarmWakeInstance(sFarmInstance_t *psInstance) {
+  int iState = atomic_load(&psInstance->iState);
+  for (;;) {
+    int iNext;
+    if (iState == FARM_STATE_IDLE) {
+      iNext = FARM_STATE_QUEUED;
+    } else if (iState == FARM_STATE_RUNNING) {
+      iNext = FARM_STATE_RERUN;
+    } else {
+      return; // Already queued or flagged to rerun
+    }
+    if (atomic_compare_exchange_weak(&psInstance->iState, &iState, iNext)) {
+      break;
+    }
+  }
+  if (iState == FARM_STATE_IDLE &&
+      eFarmPoolSubmit(psInstance) != RET_TYPE_SUCCESS) {
+    atomic_store(&psInstance->iState, FARM_STATE_IDLE);
+    atomic_fetch_add(&psInstance->u32Dropped, 1);
+  }
+}
+
+void vFarmWakeInstanceAt(sFarmInstance_t *psInstance, uint64_t u64DueUs) {
+  // One wake-up pending per instance is enough unless this one is earlier
+  uint64_t u64NowUs = u64FarmNowUs();
+  if (psInstance->u64WakeUs > u64NowUs && psInstance->u64WakeUs <= u64DueUs) {
+    return;
+  }
+  psInstance->u64WakeUs = u64DueUs;
+  vFarm_TimerPush(u64DueUs, psInstance->u32Index, FARM_TIMER_WAKE);
+}
+
+bool bFarmTakeRxLine(sFarmInstance_t *psInstance, uint8_t u8Lane,
+                     char *pcLine, uint32_t u32Size, uint32_t *pu32Len,
+                     bool *pbFrame) {
+  bool bTaken = false;
+  uint64_t u64NextUs = 0;
+  uint64_t u64NowUs = u64FarmNowUs();
+  sFarmRxLane_t *psLane = &psInstance->asRxLane[u8Lane];
+
+  pthread_mutex_lock(&psInstance->sLock);
+  if (psLane->u32Count > 0) {
+    sFarmLine_t *psLine = &psLane->asLine[psLane->u32Head];
+    if (psLine->u64DueUs <= u64NowUs) {
+      uint32_t u32Copy =
+          (psLine->u16Len < u32Size - 1) ? psLine->u16Len : u32Size - 1;
+      memcpy(pcLine, psLine->acData, u32Copy);
+      pcLine[u32Copy] = '\0';
+      *pu32Len = u32Copy;
+      *pbFrame = psLine->bFrame;
+      psLane->u32Head = (psLane->u32Head + 1) % FARM_RX_LINES;
+      psLane->u32Count--;
+      bTaken = true;
+    } else {
+      u64NextUs = psLine->u64DueUs;
+    }
+  }
+  pthread_mutex_unlock(&psInstance->sLock);
+
+  // Twin lines only get a timer when their lane was empty (see
+  // vFarm_OnReadable): the next one is asked for here
+  if (u8Lane == FARM_RX_DT && u64NextUs != 0) {
+    vFarmWakeInstanceAt(psInstance, u64NextUs);
+  }
+  return bTaken;
+}
+
+void vFarmGetRxFlow(sFarmInstance_t *psInstance, uint32_t *pu32Queued,
+                    uint32_t *pu32Overruns) {
+  pthread_mutex_lock(&psInstance->sLock);
+  *pu32Queued = psInstance->asRxLane[FARM_RX_MCP].u32Count;
+  *pu32Overruns = psInstance->u32RxOverruns;
+  pthread_mutex_unlock(&psInstance->sLock);
+}
+
+void vFarmQueueTx(sFarmInstance_t *psInstance, const char *pcData,
+                  uint16_t u16Len) {
+  uint64_t u64NowUs = u64FarmNowUs();
+  uint64_t u64DueUs = 0;
+  bool bTimer = false;
+
+  pthread_mutex_lock(&psInstance->sLock);
+  uint64_t u64StartUs = (psInstance->u64TxBusyUs > u64NowUs)
+                            ? psInstance->u64TxBusyUs
+                            : u64NowUs;
+  psInstance->u64TxBusyUs =
+      u64StartUs + (uint64_t)u16Len * u32Farm_ByteUs(psInstance);
+  u64DueUs = psInstance->u64TxBusyUs + psInstance->u32LatencyUs;
+
+  if (u64DueUs <= u64NowUs && psInstance->u32TxCount == 0) {
+    // Unpaced link: straight to the PTY
+    if (write(psInstance->iPtyFd, pcData, u16Len) == (ssize_t)u16Len) {
+      atomic_fetch_add(&psInstance->u32LinesOut, 1);
+    } else {
+      atomic_fetch_add(&psInstance->u32Dropped, 1);
+    }
+  } else if (psInstance->u32TxCount < FARM_TX_LINES) {
+    uint32_t u32Slot =
+        (psInstance->u32TxHead + psInstance->u32TxCount) % FARM_TX_LINES;
+    sFarmLine_t *psLine = &psInstance->asTx[u32Slot];
+    psLine->u64DueUs = u64DueUs;
+    psLine->u16Len = (u16Len < FARM_LINE_SIZE) ? u16Len : FARM_LINE_SIZE;
+    memcpy(psLine->acData, pcData, psLine->u16Len);
+    psInstance->u32TxCount++;
+    bTimer = true;
+  } else {
+    atomic_fetch_add(&psInstance->u32Dropped, 1);
+  }
+  pthread_mutex_unlock(&psInstance->sLock);
+
+  if (bTimer) {
+    vFarm_TimerPush(u64DueUs, psInstance->u32Index, FARM_TIMER_TX);
+  }
+}
+
+int main(int argc, char **argv) {
+  uint32_t u32Count = FARM_DEFAULT_INSTANCES;
+  long lCpus = sysconf(_SC_NPROCESSORS_ONLN);
+  uint32_t u32Workers = (lCpus > 0) ? (uint32_t)lCpus : 1u;
+  uint32_t u32Baud = 0;
+  uint32_t u32LatencyUs = 0;
+  const char *pcLinkConfig = NULL;
+  uint32_t u32Seconds = 0;
+  bool bDtSync = false;
+
+  int iOpt;
+  while ((iOpt = getopt(argc, argv, "n:w:b:l:c:L:t:dh")) != -1) {
+    switch (iOpt) {
+    case 'n':
+      u32Count = (uint32_t)strtoul(optarg, NULL, 10);
+      break;
+    case 'w':
+      u32Workers = (uint32_t)strtoul(optarg, NULL, 10);
+      break;
+    case 'b':
+      u32Baud = (uint32_t)strtoul(optarg, NULL, 10);
+      break;
+    case 'l':
+      u32LatencyUs = (uint32_t)strtoul(optarg, NULL, 10);
+      break;
+    case 'c':
+      pcLinkConfig = optarg;
+      break;
+    case 'L':
+      g_pcFarmLinkDir = optarg;
+      break;
+    case 't':
+      u32Seconds = (uint32_t)strtoul(optarg, NULL, 10);
+      break;
+    case 'd':
+      bDtSync = true;
+      break;
+    default:
+      vFarm_Usage(argv[0]);
+      return (iOpt == 'h') ? 0 : 1;
+    }
+  }
+  if (u32Count == 0 || u32Workers == 0) {
+    vFarm_Usage(argv[0]);
+    return 1;
+  }
+
+  // Two descriptors per instance: lift the soft limit to the hard one
+  struct rlimit sLimit;
+  if (getrlimit(RLIMIT_NOFILE, &sLimit) == 0) {
+    sLimit.rlim_cur = sLimit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &sLimit);
+  }
+
+  // Shared firmware init once: registers the farm GPIO backend
+  vFarmSetDtSync(bDtSync);
+  vAppInit();
+
+  g_asFarmInstances = calloc(u32Count, sizeof(sFarmInstance_t));
+  g_u32FarmTimerCapacity =
+      u32Count *
+      (FARM_RX_LINES + 1 + FARM_TX_LINES + MCP_WATCH_MAX + MCP_SCHED_MAX);
+  g_asFarmTimers = calloc(g_u32FarmTimerCapacity, sizeof(sFarmTimer_t));
+  g_iFarmEpollFd = epoll_create1(EPOLL_CLOEXEC);
+  g_iFarmTimerFd =
+      timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  g_iFarmWakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (g_asFarmInstances == NULL || g_asFarmTimers == NULL ||
+      g_iFarmEpollFd < 0 || g_iFarmTimerFd < 0 || g_iFarmWakeFd < 0) {
+    fprintf(stderr, "[FARM] [ERROR] Out of resources\n");
+    return 1;
+  }
+
+  struct epoll_event sEv = {.events = EPOLLIN};
+  sEv.data.u64 = FARM_TAG_TIMER;
+  epoll_ctl(g_iFarmEpollFd, EPOLL_CTL_ADD, g_iFarmTimerFd, &sEv);
+  sEv.data.u64 = FARM_TAG_WAKE;
+  epoll_ctl(g_iFarmEpollFd, EPOLL_CTL_ADD, g_iFarmWakeFd, &sEv);
+
+  for (uint32_t i = 0; i < u32Count; i++) {
+    sFarmInstance_t *psInstance = &g_asFarmInstances[i];
+    psInstance->u32Index = i;
+    psInstance->u32Baud = u32Baud;
+    psInstance->u32LatencyUs = u32LatencyUs;
+    pthread_mutex_init(&psInstance->sLock, NULL);
+    atomic_init(&psInstance->iState, FARM_STATE_IDLE);
+    vFarmResetPins(psInstance);
+    if (!bFarm_OpenPty(psInstance)) {
+      fprintf(stderr, "[FARM] [ERROR] PTY %u: %s\n", (unsigned)i,
+              strerror(errno));
+      return 1;
+    }
+    g_u32FarmInstanceCount = i + 1;
+
+    sEv.data.u64 = i;
+    epoll_ctl(g_iFarmEpollFd, EPOLL_CTL_ADD, psInstance->iPtyFd, &sEv);
+  }
+  if (pcLinkConfig != NULL && !bFarm_LoadLinkConfig(pcLinkConfig)) {
+    return 1;
+  }
+
+  // Instance table on stdout, for load-test scripts to pick up the ports
+  for (uint32_t i = 0; i < u32Count; i++) {
+    sFarmInstance_t *psInstance = &g_asFarmInstances[i];
+    printf("MCU %u %s %u %u\n", (unsigned)i, psInstance->acPtyPath,
+           (unsigned)psInstance->u32Baud,
+           (unsigned)psInstance->u32LatencyUs);
+  }
+  fflush(stdout);
+
+  if (eFarmPoolStart(u32Workers, u32Count, vFarmRunInstance) !=
+      RET_TYPE_SUCCESS) {
+    fprintf(stderr, "[FARM] [ERROR] Cannot start %u workers\n",
+            (unsigned)u32Workers);
+    return 1;
+  }
+  fprintf(stderr, "[FARM] %u instances on %u workers.\n", (unsigned)u32Count,
+          (unsigned)u32Workers);
+
+  struct sigaction sAction;
+  memset(&sAction, 0, sizeof(sAction));
+  sAction.sa_handler = vFarm_OnSignal; // No SA_RESTART: break epoll_wait
+  sigaction(SIGINT, &sAction, NULL);
+  sigaction(SIGTERM, &sAction, NULL);
+
+  uint64_t u64EndUs =
+      (u32Seconds > 0) ? u64FarmNowUs() + (uint64_t)u32Seconds * 1000000u : 0;
+  struct epoll_event asEvents[FARM_MAX_EVENTS];
+  while (!g_bFarmStop) {
+    int iTimeoutMs = -1;
+    if (u64EndUs != 0) {
+      uint64_t u64NowUs = u64FarmNowUs();
+      if (u64NowUs >= u64EndUs) {
+        break;
+      }
+      iTimeoutMs = (int)((u64EndUs - u64NowUs + 999u) / 1000u);
+    }
+
+    int iCount =
+        epoll_wait(g_iFarmEpollFd, asEvents, FARM_MAX_EVENTS, iTimeoutMs);
+    for (int i = 0; i < iCount; i++) {
+      uint64_t u64Tag = asEvents[i].data.u64;
+      if (u64Tag == FARM_TAG_TIMER || u64Tag == FARM_TAG_WAKE) {
+        uint64_t u64Drain;
+        ssize_t iIgnored = read((u64Tag == FARM_TAG_TIMER) ? g_iFarmTimerFd
+                                                           : g_iFarmWakeFd,
+                                &u64Drain, sizeof(u64Drain));
+        (void)iIgnored;
+      } else if (u64Tag < g_u32FarmInstanceCount) {
+        vFarm_OnReadable(&g_asFarmInstances[u64Tag]);
+      }
+    }
+    vFarm_RunTimers();
+  }
+
+  vFarm_PrintStats(); // Before the pool (and its counters) is torn down
+  vFarmPoolStop();
+  if (g_pcFarmLinkDir != NULL) {
+    char acLink[256];
+    for (uint32_t i = 0; i < g_u32FarmInstanceCount; i++) {
+      snprintf(acLink, sizeof(acLink), "%s/ttyMCU%03u", g_pcFarmLinkDir,
+               (unsigned)i);
+      unlink(acLink);
+    }
+  }
+  return 0;
+}
+
+// Private Functions ===========================================================
+
+static uint32_t u32Farm_ByteUs(const sFarmInstance_t *psInstance) {
+  if (psInstance->u32Baud == 0) {
+    return 0;
+  }
+  // 8N1: start + 8 data + stop = 10 bit times per byte
+  return (10u * 1000000u + psInstance->u32Baud - 1u) / psInstance->u32Baud;
+}
+
+static void vFarm_TimerPush(uint64_t u64DueUs, uint32_t u32Instance,
+                            uint8_t u8Kind) {
+  bool bNewFirst = false;
+
+  pthread_mutex_lock(&g_sFarmTimerLock);
+  if (g_u32FarmTimerCount < g_u32FarmTimerCapacity) {
+    uint32_t u32Index = g_u32FarmTimerCount++;
+    g_asFarmTimers[u32Index] = (sFarmTimer_t){u64DueUs, u32Instance, u8Kind};
+    while (u32Index > 0) {
+      uint32_t u32Parent = (u32Index - 1) / 2;
+      if (g_asFarmTimers[u32Parent].u64DueUs <=
+          g_asFarmTimers[u32Index].u64DueUs) {
+        break;
+      }
+      sFarmTimer_t sTmp = g_asFarmTimers[u32Parent];
+      g_asFarmTimers[u32Parent] = g_asFarmTimers[u32Index];
+      g_asFarmTimers[u32Index] = sTmp;
+      u32Index = u32Parent;
+    }
+    bNewFirst = (u32Index == 0);
+  }
+  pthread_mutex_unlock(&g_sFarmTimerLock);
+
+  if (bNewFirst) {
+    uint64_t u64One = 1;
+    ssize_t iIgnored = write(g_iFarmWakeFd, &u64One, sizeof(u64One));
+    (void)iIgnored;
+  }
+}
+
+static bool bFarm_TimerPopDue(uint64_t u64NowUs, sFarmTimer_t *psTimer) {
+  bool bPopped = false;
+
+  pthread_mutex_lock(&g_sFarmTimerLock);
+  if (g_u32FarmTimerCount > 0 && g_asFarmTimers[0].u64DueUs <= u64NowUs) {
+    *psTimer = g_asFarmTimers[0];
+    g_asFarmTimers[0] = g_asFarmTimers[--g_u32FarmTimerCount];
+    uint32_t u32Index = 0;
+    for (;;) {
+      uint32_t u32Left = 2 * u32Index + 1;
+      uint32_t u32Min = u32Index;
+      if (u32Left < g_u32FarmTimerCount &&
+          g_asFarmTimers[u32Left].u64DueUs < g_asFarmTimers[u32Min].u64DueUs) {
+        u32Min = u32Left;
+      }
+      if (u32Left + 1 < g_u32FarmTimerCount &&
+          g_asFarmTimers[u32Left + 1].u64DueUs <
+              g_asFarmTimers[u32Min].u64DueUs) {
+        u32Min = u32Left + 1;
+      }
+      if (u32Min == u32Index) {
+        break;
+      }
+      sFarmTimer_t sTmp = g_asFarmTimers[u32Min];
+      g_asFarmTimers[u32Min] = g_asFarmTimers[u32Index];
+      g_asFarmTimers[u32Index] = sTmp;
+      u32Index = u32Min;
+    }
+    bPopped = true;
+  }
+  pthread_mutex_unlock(&g_sFarmTimerLock);
+  return bPopped;
+}
+
+static void vFarm_TimerArm(void) {
+  struct itimerspec sSpec;
+  memset(&sSpec, 0, sizeof(sSpec)); // Zero = disarm
+
+  pthread_mutex_lock(&g_sFarmTimerLock);
+  if (g_u32FarmTimerCount > 0) {
+    uint64_t u64DueUs = g_asFarmTimers[0].u64DueUs;
+    sSpec.it_value.tv_sec = (time_t)(u64DueUs / 1000000u);
+    sSpec.it_value.tv_nsec = (long)(u64DueUs % 1000000u) * 1000;
+    if (sSpec.it_value.tv_sec == 0 && sSpec.it_value.tv_nsec == 0) {
+      sSpec.it_value.tv_nsec = 1;
+    }
+  }
+  pthread_mutex_unlock(&g_sFarmTimerLock);
+
+  timerfd_settime(g_iFarmTimerFd, TFD_TIMER_ABSTIME, &sSpec, NULL);
+}
+
+static void vFarm_RunTimers(void) {
+  uint64_t u64NowUs = u64FarmNowUs();
+  sFarmTimer_t sTimer;
+
+  while (bFarm_TimerPopDue(u64NowUs, &sTimer)) {
+    sFarmInstance_t *psInstance = &g_asFarmInstances[sTimer.u32Instance];
+    if (sTimer.u8Kind != FARM_TIMER_TX) {
+      vFarmWakeInstance(psInstance);
+    } else {
+      vFarm_FlushTx(psInstance, u64NowUs);
+    }
+  }
+  vFarm_TimerArm();
+}
+
+static void vFarm_OnReadable(sFarmInstance_t *psInstance) {
+  char acChunk[FARM_READ_CHUNK];
+  ssize_t iRead = read(psInstance->iPtyFd, acChunk, sizeof(acChunk));
+  if (iRead <= 0) {
+    return;
+  }
+
+  uint64_t u64NowUs = u64FarmNowUs();
+  uint32_t u32ByteUs = u32Farm_ByteUs(psInstance);
+  uint64_t au64Due[FARM_RX_LINES + 1];
+  uint32_t u32NewLines = 0;
+
+  pthread_mutex_lock(&psInstance->sLock);
+  bool bDtWasEmpty = (psInstance->asRxLane[FARM_RX_DT].u32Count == 0);
+  uint64_t u64WireUs = (psInstance->u64RxBusyUs > u64NowUs)
+                           ? psInstance->u64RxBusyUs
+                           : u64NowUs;
+  for (ssize_t i = 0; i < iRead; i++) {
+    char c = acChunk[i];
+    u64WireUs += u32ByteUs;
+
+    // 0x00 opens a binary frame (dropping a partial line) or closes one;
+    // inside a frame '\n' and '\r' are data
+    bool bFrame = false;
+    if (c == '\0') {
+      if (!psInstance->bRxInFrame ||
+          (psInstance->u16RxLen == 0 && !psInstance->bRxDiscard)) {
+        psInstance->bRxInFrame = true;
+        psInstance->bRxDiscard = false;
+        psInstance->u16RxLen = 0;
+        continue;
+      }
+      psInstance->bRxInFrame = false;
+      bFrame = true;
+    } else if (psInstance->bRxInFrame || (c != '\n' && c != '\r')) {
+      if (psInstance->u16RxLen < FARM_LINE_SIZE - 1) {
+        psInstance->acRxAssembly[psInstance->u16RxLen++] = c;
+      } else {
+        psInstance->u16RxLen = 0; // Over-long: drop up to the terminator
+        psInstance->bRxDiscard = true;
+      }
+      continue;
+    }
+
+    bool bDiscard = psInstance->bRxDiscard;
+    uint16_t u16Len = psInstance->u16RxLen;
+    psInstance->bRxDiscard = false;
+    psInstance->u16RxLen = 0;
+    if (bDiscard) {
+      psInstance->u32RxOverruns++;
+      continue;
+    }
+    if (u16Len == 0) {
+      continue;
+    }
+    bool bDt = (!bFrame && psInstance->acRxAssembly[0] == '{');
+    sFarmRxLane_t *psLane =
+        &psInstance->asRxLane[bDt ? FARM_RX_DT : FARM_RX_MCP];
+    if (psLane->u32Count >= FARM_RX_LINES) {
+      atomic_fetch_add(&psInstance->u32Dropped, 1);
+      if (!bDt) {
+        psInstance->u32RxOverruns++; // Host sent past its window ("flow")
+        continue;
+      }
+      // Twin lane: the newest level of a pin is what counts
+      psLane->u32Head = (psLane->u32Head + 1) % FARM_RX_LINES;
+      psLane->u32Count--;
+    }
+
+    uint32_t u32Slot = (psLane->u32Head + psLane->u32Count) % FARM_RX_LINES;
+    sFarmLine_t *psLine = &psLane->asLine[u32Slot];
+    psLine->u64DueUs = u64WireUs + psInstance->u32LatencyUs;
+    psLine->u16Len = u16Len;
+    psLine->bFrame = bFrame;
+    memcpy(psLine->acData, psInstance->acRxAssembly, u16Len);
+    psLane->u32Count++;
+    // One timer per MCP line (at most a lane's worth); twin lines only wake
+    // the instance for the first one, the worker asks for the rest
+    if (!bDt || bDtWasEmpty) {
+      au64Due[u32NewLines++] = psLine->u64DueUs;
+      bDtWasEmpty = bDtWasEmpty && !bDt;
+    }
+    atomic_fetch_add(&psInstance->u32LinesIn, 1);
+  }
+  psInstance->u64RxBusyUs = u64WireUs;
+  pthread_mutex_unlock(&psInstance->sLock);
+
+  for (uint32_t i = 0; i < u32NewLines; i++) {
+    if (au64Due[i] <= u64NowUs) {
+      vFarmWakeInstance(psInstance);
+    } else {
+      vFarm_TimerPush(au64Due[i], psInstance->u32Index, FARM_TIMER_RX);
+    }
+  }
+}
+
+static void vFarm_FlushTx(sFarmInstance_t *psInstance, uint64_t u64NowUs) {
+  pthread_mutex_lock(&psInstance->sLock);
+  while (psInstance->u32TxCount > 0) {
+    sFarmLine_t *psLine = &psInstance->asTx[psInstance->u32TxHead];
+    if (psLine->u64DueUs > u64NowUs) {
+      break;
+    }
+    // Host not reading: a UART would overrun too, so drop rather than block
+    if (write(psInstance->iPtyFd, psLine->acData, psLine->u16Len) ==
+        (ssize_t)psLine->u16Len) {
+      atomic_fetch_add(&psInstance->u32LinesOut, 1);
+    } else {
+      atomic_fetch_add(&psInstance->u32Dropped, 1);
+    }
+    psInstance->u32TxHead = (psInstance->u32TxHead + 1) % FARM_TX_LINES;
+    psInstance->u32TxCount--;
+  }
+  pthread_mutex_unlock(&psInstance->sLock);
+}
+
+static bool bFarm_OpenPty(sFarmInstance_t *psInstance) {
+  int iMaster = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+  if (iMaster < 0) {
+    return false;
+  }
+  if (grantpt(iMaster) != 0 || unlockpt(iMaster) != 0) {
+    close(iMaster);
+    return false;
+  }
+
+  const char *pcSlave = ptsname(iMaster);
+  psInstance->iSlaveFd = open(pcSlave, O_RDWR | O_NOCTTY | O_CLOEXEC);
+  if (psInstance->iSlaveFd < 0) {
+    close(iMaster);
+    return false;
+  }
+  struct termios sTio;
+  if (tcgetattr(psInstance->iSlaveFd, &sTio) == 0) {
+    cfmakeraw(&sTio); // Serial-port behaviour: no echo, no line editing
+    tcsetattr(psInstance->iSlaveFd, TCSANOW, &sTio);
+  }
+  fcntl(iMaster, F_SETFL, fcntl(iMaster, F_GETFL) | O_NONBLOCK);
+  psInstance->iPtyFd = iMaster;
+
+  if (g_pcFarmLinkDir != NULL) {
+    snprintf(psInstance->acPtyPath, sizeof(psInstance->acPtyPath),
+             "%s/ttyMCU%03u", g_pcFarmLinkDir, (unsigned)psInstance->u32Index);
+    unlink(psInstance->acPtyPath);
+    if (symlink(pcSlave, psInstance->acPtyPath) != 0) {
+      fprintf(stderr, "[FARM] [WARNING] Cannot link %s: %s\n",
+              psInstance->acPtyPath, strerror(errno));
+      snprintf(psInstance->acPtyPath, sizeof(psInstance->acPtyPath), "%s",
+               pcSlave);
+    }
+  } else {
+    snprintf(psInstance->acPtyPath, sizeof(psInstance->acPtyPath), "%s",
+             pcSlave);
+  }
+  return true;
+}
+
+/**
+ * @brief Per-instance link overrides, one per line:
+ *        "<first>[-<last>] <baud> <latency_us>"; '#' starts a comment
+ */
+static bool bFarm_LoadLinkConfig(const char *pcPath) {
+  FILE *psFile = fopen(pcPath, "r");
+  if (psFile == NULL) {
+    fprintf(stderr, "[FARM] [ERROR] Cannot open %s: %s\n", pcPath,
+            strerror(errno));
+    return false;
+  }
+
+  char acLine[128];
+  uint32_t u32LineNo = 0;
+  while (fgets(acLine, sizeof(acLine), psFile) != NULL) {
+    u32LineNo++;
+    char *pcHash = strchr(acLine, '#');
+    if (pcHash != NULL) {
+      *pcHash = '\0';
+    }
+
+    unsigned uFirst, uLast, uBaud, uLatency;
+    int iFields =
+        sscanf(acLine, "%u-%u %u %u", &uFirst, &uLast, &uBaud, &uLatency);
+    if (iFields != 4) {
+      uLast = uFirst = 0;
+      if (sscanf(acLine, "%u %u %u", &uFirst, &uBaud, &uLatency) != 3) {
+        if (strspn(acLine, " \t\r\n") != strlen(acLine)) {
+          fprintf(stderr, "[FARM] [WARNING] %s:%u: ignored\n", pcPath,
+                  (unsigned)u32LineNo);
+        }
+        continue;
+      }
+      uLast = uFirst;
+    }
+
+    for (unsigned u = uFirst; u <= uLast && u < g_u32FarmInstanceCount; u++) {
+      g_asFarmInstances[u].u32Baud = uBaud;
+      g_asFarmInstances[u].u32LatencyUs = uLatency;
+    }
+  }
+  fclose(psFile);
+  return true;
+}
+
+static void vFarm_PrintStats(void) {
+  uint64_t u64Executed = 0;
+  uint64_t u64Stolen = 0;
+  for (uint32_t i = 0; i < u32FarmPoolWorkers(); i++) {
+    sFarmPoolStats_t sStats = {0};
+    vFarmPoolGetStats(i, &sStats);
+    u64Executed += sStats.u64Executed;
+    u64Stolen += sStats.u64Stolen;
+  }
+
+  uint64_t u64In = 0;
+  uint64_t u64Out = 0;
+  uint64_t u64Dropped = 0;
+  for (uint32_t i = 0; i < g_u32FarmInstanceCount; i++) {
+    u64In += atomic_load(&g_asFarmInstances[i].u32LinesIn);
+    u64Out += atomic_load(&g_asFarmInstances[i].u32LinesOut);
+    u64Dropped += atomic_load(&g_asFarmInstances[i].u32Dropped);
+  }
+
+  fprintf(stderr,
+          "[FARM] lines in %llu, out %llu, dropped %llu; "
+          "%llu loop passes, %llu stolen\n",
+          (unsigned long long)u64In, (unsigned long long)u64Out,
+          (unsigned long long)u64Dropped, (unsigned long long)u64Executed,
+          (unsigned long long)u64Stolen);
+}
+
+static void vFarm_OnSignal(int iSignal) {
+  (void)iSignal;
+  g_bFarmStop = 1;
+}
+
+static void vFarm_Usage(const char *pcProg) {
+  fprintf(stderr,
+          "Usage: %s [-n count] [-w workers] [-b baud] [-l latency_us]\n"
+          "          [-c link.cfg] [-L link_dir] [-t seconds] [-d]\n"
+          "  -n  firmware instances (default %d)\n"
+          "  -w  worker threads (default: online CPUs)\n"
+          "  -b  UART baud for every instance, 0 = unpaced (default 0)\n"
+          "  -l  extra latency per direction in us (default 0)\n"
+          "  -c  per-instance overrides: \"<first>[-<last>] <baud> <us>\"\n"
+          "  -L  symlink PTYs as <link_dir>/ttyMCU000...\n"
+          "  -t  stop after this many seconds (default: until SIGINT)\n"
+          "  -d  emit Digital Twin JSON lines like the AVR firmware\n",
+          pcProg, FARM_DEFAULT_INSTANCES);
+}
@@ -0,0 +1,186 @@
+//==============================================================================
+// MCU Farm - Many Firmware Instances in One Process
+//------------------------------------------------------------------------------
+//! @file
+//! @brief Per-instance state shared by the farm host and its platform layer
+//!
+//! Every instance runs the common firmware (app_main.c, tool handlers, gpio
+//! helper). Code and the pin configuration are shared; what differs per
+//! board (pin levels, UART buffers, link timing) lives in sFarmInstance_t.
+//! The firmware reaches its per-board state through PLATFORM_FARM hooks:
+//! gpio_helper.c (twin sync state, keepalive wake-up, no read merge),
+//! mcp_watch.c and mcp_sched.c (watch table, write queue, wake-ups), and a
+//! __thread request tag in app_main.c. A worker selects an instance with
+//! vFarmSetCurrent() before calling into the firmware, so the farm GPIO
+//! backend and the printf sink act on that board only.
+//------------------------------------------------------------------------------
+
+#ifndef MCU_FARM_H
+#define MCU_FARM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Includes ====================================================================
+#include "common.h"
+#include "gpio_helper.h"
+#include "mcp_sched.h"
+#include "mcp_watch.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Constants ===================================================================
+#define FARM_MAX_PINS 32
+#define FARM_LINE_SIZE 128 // Same as the AVR RX buffer
+#define FARM_RX_LINES 16 // Per lane
+#define FARM_TX_LINES 32
+
+// Receive lanes: Digital Twin lines ('{' first) never take an MCP slot
+#define FARM_RX_MCP 0 // Commands and frames; full = overrun (flow window)
+#define FARM_RX_DT 1  // Twin input; full = the oldest line gives way
+#define FARM_RX_LANES 2
+
+// Scheduling state of an instance (see vFarmWakeInstance)
+#define FARM_STATE_IDLE 0
+#define FARM_STATE_QUEUED 1
+#define FARM_STATE_RUNNING 2
+#define FARM_STATE_RERUN 3 // Woken while running: run again before idling
+
+// Type Definitions ============================================================
+
+/**
+ * @brief One line (or binary frame) in flight, released once the simulated
+ *        UART delivered it
+ */
+typedef struct {
+  uint64_t u64DueUs;
+  uint16_t u16Len;
+  bool bFrame; // COBS bytes between 0x00 delimiters, not a text line
+  char acData[FARM_LINE_SIZE];
+} sFarmLine_t;
+
+typedef struct {
+  sFarmLine_t asLine[FARM_RX_LINES];
+  uint32_t u32Head;
+  uint32_t u32Count;
+} sFarmRxLane_t;
+
+typedef struct {
+  uint32_t u32Index;
+
+  // Link model: each byte takes 10 bit times; latency adds a fixed delay
+  // per direction (USB-serial adapters buffer for 1-16 ms)
+  uint32_t u32Baud; // 0 = no pacing
+  uint32_t u32LatencyUs;
+
+  int iPtyFd;   // Master side, owned by the I/O thread
+  int iSlaveFd; // Held open so the master never reports a hangup
+  char acPtyPath[64];
+
+  pthread_mutex_t sLock; // Guards everything from here to the stats
+
+  // Host -> firmware
+  char acRxAssembly[FARM_LINE_SIZE];
+  uint16_t u16RxLen;
+  bool bRxDiscard; // Dropping an over-long line up to its terminator
+  bool bRxInFrame; // Inside a 0x00 ... 0x00 binary frame
+  uint64_t u64RxBusyUs;
+  sFarmRxLane_t asRxLane[FARM_RX_LANES];
+  uint32_t u32RxOverruns; // MCP lines dropped: lane full or over-long
+
+  // Firmware -> host
+  uint64_t u64TxBusyUs;
+  sFarmLine_t asTx[FARM_TX_LINES];
+  uint32_t u32TxHead;
+  uint32_t u32TxCount;
+
+  // Only touched by the worker currently running the instance
+  char acTxAssembly[FARM_LINE_SIZE];
+  uint16_t u16TxLen;
+  uint32_t u32PinValues;         // Bit n = level of pin n (see farm_platform.c)
+  bool bFramed;                  // Host asked for COBS telemetry ("proto cobs")
+  sMcpWatchTable_t sWatch;       // gpio_watch subscriptions (see mcp_watch.h)
+  sMcpSchedQueue_t sSched;       // gpio_write_at queue (see mcp_sched.h)
+  sGpioHelperDtState_t sDtState; // Levels sent to the twin (gpio_helper.h)
+  uint64_t u64WakeUs;            // Pending vFarmWakeInstanceAt() deadline
+  uint32_t u32RxReported;        // u32RxOverruns already reported (flow)
+
+  atomic_int iState;
+
+  // Statistics (atomic: read by the main thread while workers run)
+  atomic_uint u32LinesIn;
+  atomic_uint u32LinesOut;
+  atomic_uint u32Dropped; // Lines lost to a full queue or a stalled host
+} sFarmInstance_t;
+
+// Function Prototypes =========================================================
+
+// farm_platform.c -------------------------------------------------------------
+
+/**
+ * @brief Select the instance the firmware acts on in this thread (or NULL)
+ */
+void vFarmSetCurrent(sFarmInstance_t *psInstance);
+
+/**
+ * @brief Set an instance's pins to their power-on levels (pull-ups high)
+ */
+void vFarmResetPins(sFarmInstance_t *psInstance);
+
+/**
+ * @brief Emit Digital Twin JSON after writes/reads, as the AVR build does
+ */
+void vFarmSetDtSync(bool bEnable);
+
+/**
+ * @brief Pool task: run one firmware loop pass for an instance
+ */
+void vFarmRunInstance(void *pvInstance);
+
+// mcu_farm.c ------------------------------------------------------------------
+
+uint64_t u64FarmNowUs(void);
+
+/**
+ * @brief Ask the pool to run an instance (any thread; coalesces wake-ups)
+ */
+void vFarmWakeInstance(sFarmInstance_t *psInstance);
+
+/**
+ * @brief Run an instance again at u64DueUs (worker running it; held-back
+ *        gpio_watch reports, gpio_write_at deadlines)
+ */
+void vFarmWakeInstanceAt(sFarmInstance_t *psInstance, uint64_t u64DueUs);
+
+/**
+ * @brief MCP lines waiting for the firmware, and MCP lines dropped so far
+ *        (lane full or over-long)
+ */
+void vFarmGetRxFlow(sFarmInstance_t *psInstance, uint32_t *pu32Queued,
+                    uint32_t *pu32Overruns);
+
+/**
+ * @brief Pop the next line or frame of a lane (FARM_RX_MCP / FARM_RX_DT)
+ *        whose delivery time has passed (worker running the instance)
+ * @param pu32Len Bytes stored (a NUL follows them)
+ * @param pbFrame true for a binary frame
+ * @return false if none is due yet
+ */
+bool bFarmTakeRxLine(sFarmInstance_t *psInstance, uint8_t u8Lane,
+                     char *pcLine, uint32_t u32Size, uint32_t *pu32Len,
+                     bool *pbFrame);
+
+/**
+ * @brief Queue a firmware output line for paced delivery to the host
+ */
+void vFarmQueueTx(sFarmInstance_t *psInstance, const char *pcData,
+                  uint16_t u16Len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MCU_FARM_H
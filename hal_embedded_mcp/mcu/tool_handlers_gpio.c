@@ -1,63 +1,204 @@
 //==============================================================================
 // HAL Embedded MCP - GPIO Tool Handlers (MCU)
 //------------------------------------------------------------------------------
-// Called from app_main.c: vMcpHandleLine() parses UART line, looks up registry,
-// then calls us with params string (e.g. vHandleGpioWrite("LED1 1")). We
-// convert params -> eGpioHelperWrite/eGpioHelperRead; helper auto-calls
-// vHelperSend() for Digital Twin sync.
+// Called from app_main.c: vMcpHandleLine() splits the UART line into argument
+// spans, looks up the tool, then calls us with them (e.g. vHandleGpioWrite
+// with "LED1" "1"). We convert the spans with bMcpArg*() -> eGpioHelperWrite/
+// eGpioHelperRead; helper auto-calls vHelperSend() for Digital Twin sync.
 //------------------------------------------------------------------------------
 
 #include "tool_registry.h"
 #include "gpio_helper.h"
-#include <stdio.h>
-#include <stdlib.h>
+#include "mcp_sched.h"
+#include "mcp_watch.h"
 #include <string.h>
 
-/* Generated pin list for validation (optional) */
-extern const char *const g_apcMcpPinNames[];
-extern const unsigned int g_u32McpPinCount;
+void vHandleGpioWrite(const sMcpArgs_t *psArgs) {
+    int32_t iPin = 0;
+    bool bVal = false;
+    if (!bMcpArgCount(psArgs, 2, 2, "PIN VALUE") ||
+        !bMcpArgPin(psArgs, 0, &iPin) || !bMcpArgBool(psArgs, 1, &bVal))
+        return;
+    /* Helper does hardware write and DT sync; the MCP response is ours.
+     * The pin handle gives a NUL-terminated name without copying the span. */
+    eRetType_t eRet = eGpioHelperWrite(g_apcMcpPinNames[iPin], bVal);
+    if (eRet == RET_TYPE_SUCCESS)
+        vMcpRespond("OK");
+    else
+        vMcpRespond("ERR %d", (int)eRet);
+}
 
-static int bIsValidPin(const char *pcPin) {
-    for (unsigned int i = 0; i < g_u32McpPinCount && g_apcMcpPinNames[i] != NULL; i++) {
-        if (strcmp(pcPin, g_apcMcpPinNames[i]) == 0)
-            return 1;
-    }
-    return 0;
+void vHandleGpioRead(const sMcpArgs_t *psArgs) {
+    int32_t iPin = 0;
+    if (!bMcpArgCount(psArgs, 1, 1, "PIN") || !bMcpArgPin(psArgs, 0, &iPin))
+        return;
+    bool bVal = false;
+    /* Same as write: eGpioHelperRead(), by handle (no name lookup); the
+     * helper does vHelperSend for DT. */
+    eRetType_t eRet = eGpioHelperReadPin((uint32_t)iPin, &bVal);
+    if (eRet == RET_TYPE_SUCCESS)
+        vMcpRespond("GPIO_READ %s %d", g_apcMcpPinNames[iPin], bVal ? 1 : 0);
+    else
+        vMcpRespond("ERR %d", (int)eRet);
 }
 
-void vHandleGpioWrite(const char *pcParams) {
-    char acPin[32];
-    int iVal = 0;
-    if (sscanf(pcParams, "%31s %d", acPin, &iVal) < 2) {
-        printf("ERR gpio_write need PIN VALUE\n");
+/* gpio_read_all / gpio_write_many: largest pin table their pin bitmasks
+ * cover (mask bytes on the stack) */
+#define MCP_MASK_MAX_PINS 64
+
+/*
+ * "GPIO_READ_ALL <count> <hexmask> [names...]": bit i of the mask is pin
+ * handle i (config.json "pins" order), most significant digit first. The
+ * names map bits to pins; they are left out if the line would not fit, the
+ * host then maps bits by its own copy of the config.
+ */
+void vHandleGpioReadAll(const sMcpArgs_t *psArgs) {
+    static const char acHex[] = "0123456789ABCDEF";
+    uint8_t au8Bits[(MCP_MASK_MAX_PINS + 7) / 8];
+    char acMask[MCP_MASK_MAX_PINS / 4 + 1];
+    char acNames[60]; /* Fits vMcpRespond with a 64-pin mask */
+    uint32_t u32Count = g_u32McpPinCount;
+
+    if (!bMcpArgCount(psArgs, 0, 0, "no arguments"))
+        return;
+    if (u32Count > MCP_MASK_MAX_PINS) {
+        vMcpRespond("ERR %d", (int)RET_TYPE_INVALID_PARAMETER);
         return;
     }
-    if (!bIsValidPin(acPin)) {
-        printf("ERR unknown pin %s\n", acPin);
+    eRetType_t eRet = eGpioHelperReadAll(au8Bits, u32Count);
+    if (eRet != RET_TYPE_SUCCESS) {
+        vMcpRespond("ERR %d", (int)eRet);
+        return;
+    }
+
+    uint32_t u32Digits = (u32Count + 3) / 4;
+    for (uint32_t i = 0; i < u32Digits; i++) {
+        uint32_t u32Nibble = u32Digits - 1 - i;
+        uint8_t u8Byte = au8Bits[u32Nibble >> 1];
+        acMask[i] = acHex[(u32Nibble & 1) ? (u8Byte >> 4) : (u8Byte & 0x0F)];
+    }
+    acMask[u32Digits] = '\0';
+
+    size_t u32Used = 0;
+    for (uint32_t i = 0; i < u32Count; i++) {
+        size_t u32Len = strlen(g_apcMcpPinNames[i]);
+        if (u32Used + 1 + u32Len >= sizeof(acNames)) {
+            u32Used = 0; /* Partial map would be wrong: send none */
+            break;
+        }
+        acNames[u32Used++] = ' ';
+        memcpy(&acNames[u32Used], g_apcMcpPinNames[i], u32Len);
+        u32Used += u32Len;
+    }
+    acNames[u32Used] = '\0';
+
+    vMcpRespond("GPIO_READ_ALL %u %s%s", (unsigned)u32Count, acMask, acNames);
+}
+
+/*
+ * "gpio_write_many PIN=VALUE ...": every pair is checked before any pin
+ * changes; the helper then applies them grouped by port and sends one
+ * aggregated DT update. One response for the whole set.
+ */
+void vHandleGpioWriteMany(const sMcpArgs_t *psArgs) {
+    uint8_t au8Mask[(MCP_MASK_MAX_PINS + 7) / 8] = {0};
+    uint8_t au8Bits[(MCP_MASK_MAX_PINS + 7) / 8] = {0};
+    uint32_t u32Count = g_u32McpPinCount;
+
+    if (!bMcpArgCount(psArgs, 1, MCP_MAX_ARGS, "PIN=VALUE ..."))
+        return;
+    if (u32Count > MCP_MASK_MAX_PINS) {
+        vMcpRespond("ERR %d", (int)RET_TYPE_INVALID_PARAMETER);
         return;
     }
-    bool bVal = (iVal != 0);
-    /* Helper does hardware write and sends "OK" + DT sync on success. */
-    eRetType_t eRet = eGpioHelperWrite(acPin, bVal);
-    if (eRet != RET_TYPE_SUCCESS)
-        printf("ERR %d\n", (int)eRet);
+    for (uint8_t i = 0; i < psArgs->u8Count; i++) {
+        int32_t iPin = 0;
+        bool bVal = false;
+        if (!bMcpArgPinValue(psArgs, i, &iPin, &bVal))
+            return;
+        uint8_t u8Bit = (uint8_t)(1u << (iPin & 7));
+        if (au8Mask[iPin >> 3] & u8Bit) {
+            vMcpRespond("ERR duplicate pin %s", g_apcMcpPinNames[iPin]);
+            return;
+        }
+        au8Mask[iPin >> 3] |= u8Bit;
+        if (bVal)
+            au8Bits[iPin >> 3] |= u8Bit;
+    }
+
+    eRetType_t eRet = eGpioHelperWriteMany(au8Mask, au8Bits, u32Count);
+    if (eRet == RET_TYPE_SUCCESS)
+        vMcpRespond("OK");
+    else
+        vMcpRespond("ERR %d", (int)eRet);
 }
 
-void vHandleGpioRead(const char *pcParams) {
-    char acPin[32];
-    if (sscanf(pcParams, "%31s", acPin) < 1) {
-        printf("ERR gpio_read need PIN\n");
+/*
+ * "gpio_watch PIN [MIN_MS]" subscribes to level changes of PIN (see
+ * mcp_watch.h), answered "GPIO_WATCH <pin> <level>" with the baseline;
+ * "gpio_watch PIN off" unsubscribes. Events follow as "!GPIO_EVENT" lines.
+ */
+void vHandleGpioWatch(const sMcpArgs_t *psArgs) {
+    int32_t iPin = 0;
+    int32_t i32MinMs = 0;
+    if (!bMcpArgCount(psArgs, 1, 2, "PIN [MIN_MS|off]") ||
+        !bMcpArgPin(psArgs, 0, &iPin))
+        return;
+    if (iPin >= MCP_WATCH_MAX_PINS) {
+        vMcpRespond("ERR %d", (int)RET_TYPE_INVALID_PARAMETER);
         return;
     }
-    if (!bIsValidPin(acPin)) {
-        printf("ERR unknown pin %s\n", acPin);
+    if (psArgs->u8Count == 2 && bMcpArgIs(psArgs, 1, "off")) {
+        vMcpWatchClear((uint8_t)iPin);
+        vMcpRespond("OK");
+        return;
+    }
+    if (psArgs->u8Count == 2 && !bMcpArgInt(psArgs, 1, &i32MinMs))
+        return;
+    if (i32MinMs < 0 || i32MinMs > UINT16_MAX) {
+        vMcpRespond("ERR MIN_MS out of range (0..65535)");
         return;
     }
+
+    bool bVal = false;
+    eRetType_t eRet = eMcpWatchSet((uint8_t)iPin, (uint16_t)i32MinMs, &bVal);
+    if (eRet == RET_TYPE_SUCCESS)
+        vMcpRespond("GPIO_WATCH %s %d", g_apcMcpPinNames[iPin], bVal ? 1 : 0);
+    else if (eRet == RET_TYPE_MEMORY_ERROR)
+        vMcpRespond("ERR watch table full (max %d)", MCP_WATCH_MAX);
+    else
+        vMcpRespond("ERR %d", (int)eRet);
+}
+
+/*
+ * "gpio_write_at PIN VALUE TICK_MS" queues a write of an output pin for the
+ * MCU tick TICK_MS (see mcp_sched.h; "clock" reads the tick). Answered
+ * "GPIO_WRITE_AT <pin> <value> <tick>" when queued; a "!GPIO_WRITE_AT" line
+ * follows once the write is done.
+ */
+void vHandleGpioWriteAt(const sMcpArgs_t *psArgs) {
+    int32_t iPin = 0;
     bool bVal = false;
-    /* Same as write: UART params -> eGpioHelperRead(); helper does vHelperSend for DT. */
-    eRetType_t eRet = eGpioHelperRead(acPin, &bVal);
+    uint32_t u32DueMs = 0;
+    if (!bMcpArgCount(psArgs, 3, 3, "PIN VALUE TICK_MS") ||
+        !bMcpArgPin(psArgs, 0, &iPin) || !bMcpArgBool(psArgs, 1, &bVal) ||
+        !bMcpArgU32(psArgs, 2, &u32DueMs))
+        return;
+    if (iPin >= MCP_SCHED_MAX_PINS) {
+        vMcpRespond("ERR %d", (int)RET_TYPE_INVALID_PARAMETER);
+        return;
+    }
+
+    eRetType_t eRet = eMcpSchedAdd((uint8_t)iPin, bVal, u32DueMs);
     if (eRet == RET_TYPE_SUCCESS)
-        printf("GPIO_READ %s %d\n", acPin, bVal ? 1 : 0);
+        vMcpRespond("GPIO_WRITE_AT %s %d %lu", g_apcMcpPinNames[iPin],
+                    bVal ? 1 : 0, (unsigned long)u32DueMs);
+    else if (eRet == RET_TYPE_MEMORY_ERROR)
+        vMcpRespond("ERR schedule full (max %d)", MCP_SCHED_MAX);
+    else if (eRet == RET_TYPE_INVALID_STATE)
+        vMcpRespond("ERR %s is not an output", g_apcMcpPinNames[iPin]);
+    else if (eRet == RET_TYPE_INVALID_PARAMETER)
+        vMcpRespond("ERR TICK_MS not ahead of the MCU clock");
     else
-        printf("ERR %d\n", (int)eRet);
+        vMcpRespond("ERR %d", (int)eRet);
 }
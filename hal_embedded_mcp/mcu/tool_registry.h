@@ -8,17 +8,117 @@
 #ifndef TOOL_REGISTRY_H
 #define TOOL_REGISTRY_H
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/** Max arguments after the tool name */
+#define MCP_MAX_ARGS 8
+
+/** One argument: a span of the received line, not NUL-terminated */
+typedef struct {
+  const char *pcText;
+  uint8_t u8Len;
+} sMcpArg_t;
+
+/** A command split in place: tool name and argument spans (no copies) */
+typedef struct {
+  const char *pcTool;
+  uint8_t u8ToolLen;
+  uint8_t u8Count;
+  sMcpArg_t asArgs[MCP_MAX_ARGS];
+} sMcpArgs_t;
+
+typedef void (*vToolHandler_t)(const sMcpArgs_t *psArgs);
+
 /**
  * @brief Handle one line received over UART (non-JSON = MCP command).
- * Parse "tool_name param1 param2 ...", lookup tool, call handler, send response.
+ * Parse "[#id] tool_name param1 param2 ...", lookup tool, call handler, send
+ * response.
  * @param pcLine Null-terminated line (no trailing \\n).
  */
 void vMcpHandleLine(const char *pcLine);
 
+/**
+ * @brief Send the response line of the command being handled (OK / ERR /
+ * GPIO_READ ...), prefixed with its "#id" when the command was tagged.
+ * @param pcFormat printf format without the trailing newline.
+ */
+void vMcpRespond(const char *pcFormat, ...)
+#ifdef __GNUC__
+    __attribute__((format(__printf__, 1, 2)))
+#endif
+    ;
+
+/*
+ * Typed argument accessors for handlers. Each one parses a single span and,
+ * on failure, sends the precise "ERR ..." response itself and returns false,
+ * so a handler can chain them with && and just return.
+ */
+
+/**
+ * @brief Check the argument count; responds "ERR <tool> need <usage>"
+ */
+bool bMcpArgCount(const sMcpArgs_t *psArgs, uint8_t u8Min, uint8_t u8Max,
+                  const char *pcUsage);
+
+/**
+ * @brief Argument u8Index as a pin handle; responds "ERR unknown pin <name>"
+ */
+bool bMcpArgPin(const sMcpArgs_t *psArgs, uint8_t u8Index, int32_t *piPin);
+
+/**
+ * @brief Argument u8Index as a decimal int32 (optional sign)
+ */
+bool bMcpArgInt(const sMcpArgs_t *psArgs, uint8_t u8Index,
+                int32_t *pi32Value);
+
+/**
+ * @brief Argument u8Index as a decimal uint32 (no sign), e.g. a tick
+ */
+bool bMcpArgU32(const sMcpArgs_t *psArgs, uint8_t u8Index,
+                uint32_t *pu32Value);
+
+/**
+ * @brief Argument u8Index as a level: an integer, non-zero = true
+ */
+bool bMcpArgBool(const sMcpArgs_t *psArgs, uint8_t u8Index, bool *pbValue);
+
+/**
+ * @brief Argument u8Index as "PIN=VALUE": pin handle and level (non-zero =
+ * true); responds "ERR arg <n> need PIN=VALUE: ..." or "ERR unknown pin ..."
+ */
+bool bMcpArgPinValue(const sMcpArgs_t *psArgs, uint8_t u8Index, int32_t *piPin,
+                     bool *pbValue);
+
+/**
+ * @brief Whether argument u8Index equals pcWord (no response)
+ */
+bool bMcpArgIs(const sMcpArgs_t *psArgs, uint8_t u8Index, const char *pcWord);
+
+/**
+ * @brief Handler of a config.json tool (generated perfect hash, mcp_pins_gen.c)
+ * @param pcName Tool name, not necessarily NUL-terminated
+ * @return NULL if the name is not a configured tool
+ */
+vToolHandler_t pfMcpFindTool(const char *pcName, size_t u32Len);
+
+/**
+ * @brief Pin handle (index in g_apcMcpPinNames / config.json "pins") of a pin
+ * name (generated perfect hash, mcp_pins_gen.c)
+ * @param pcName Pin name, not necessarily NUL-terminated
+ * @return -1 if the name is not a configured pin
+ */
+int32_t iMcpFindPin(const char *pcName, size_t u32Len);
+
+/** Generated pin list (mcp_pins_gen.c): a pin handle indexes it */
+extern const char *const g_apcMcpPinNames[];
+extern const unsigned int g_u32McpPinCount;
+
 #ifdef __cplusplus
 }
 #endif
@@ -7,7 +7,8 @@ Same pattern as gpio_driver/scripts/gen_config.py.
 
 Usage:
   python gen_mcp_from_config.py <config.json> [options]
-  --c-out <path>       Write C pin names table (e.g. mcu/build/mcp_pins_gen.c)
+  --c-out <path>       Write C pin names + perfect-hash pin/tool lookup
+                       (e.g. mcu/build/mcp_pins_gen.c)
   --python-out <path>  Write Python schema (e.g. server/generated/mcp_schema.py)
   --help               Show this help
 """
@@ -15,14 +16,113 @@ Usage:
 import argparse
 import json
 import os
+import re
 import sys
 
+DEFAULT_TOOLS = ["gpio_write", "gpio_read"]
+MAX_DISPLACEMENT = 0xFFFF
+
+
+def mcp_hash(key, seed):
+    """Must match u32McpHash() in the generated C: FNV-1a with the seed
+    folded into the basis, then a murmur3-style finalizer for the low bits."""
+    h = (2166136261 ^ seed) & 0xFFFFFFFF
+    for byte in key:
+        h ^= byte
+        h = (h * 16777619) & 0xFFFFFFFF
+    h ^= h >> 16
+    h = (h * 0x85EBCA6B) & 0xFFFFFFFF
+    h ^= h >> 13
+    return h
+
+
+def _pow2_at_least(n):
+    size = 1
+    while size < n:
+        size *= 2
+    return size
+
+
+def build_perfect_hash(names):
+    """Hash-and-displace: bucket = H(key, 0) % buckets, then each bucket gets
+    the first seed d with H(key, d) % slots landing all its keys on free slots.
+    Returns (displacements, slots) where slots[i] is a key index or None."""
+    keys = [n.encode("utf-8") for n in names]
+    if len(set(keys)) != len(keys):
+        dup = sorted({n for n in names if names.count(n) > 1})
+        raise ValueError(f"duplicate names: {', '.join(dup)}")
+
+    n_slots = _pow2_at_least(max(1, len(keys)))
+    n_buckets = _pow2_at_least(max(1, (len(keys) + 1) // 2))
+    while True:
+        placed = _displace(keys, n_buckets, n_slots)
+        if placed is not None:
+            return placed
+        n_slots *= 2  # No seed fits some bucket: retry with more room
+
+
+def _displace(keys, n_buckets, n_slots):
+    buckets = [[] for _ in range(n_buckets)]
+    for index, key in enumerate(keys):
+        buckets[mcp_hash(key, 0) & (n_buckets - 1)].append(index)
+    slots = [None] * n_slots
+    disp = [0] * n_buckets
+    # Biggest buckets first, while the table is still empty
+    for bucket in sorted(range(n_buckets), key=lambda b: -len(buckets[b])):
+        members = buckets[bucket]
+        if not members:
+            break
+        for seed in range(1, MAX_DISPLACEMENT + 1):
+            pos = [mcp_hash(keys[i], seed) & (n_slots - 1) for i in members]
+            if len(set(pos)) == len(pos) and all(slots[p] is None for p in pos):
+                break
+        else:
+            return None
+        disp[bucket] = seed
+        for index, p in zip(members, pos):
+            slots[p] = index
+    return disp, slots
+
+
+def tool_entries(json_data):
+    """(name, handler) per config tool. A tool is a name ("gpio_write" ->
+    vHandleGpioWrite) or {"name": ..., "handler": ...}."""
+    tools = json_data.get("mcp", {}).get("tools", DEFAULT_TOOLS)
+    entries = []
+    for tool in tools:
+        if isinstance(tool, dict):
+            name = tool.get("name", "")
+            handler = tool.get("handler")
+        else:
+            name, handler = tool, None
+        if not re.fullmatch(r"[A-Za-z0-9_]{1,31}", name):
+            raise ValueError(f"bad tool name: {name!r}")
+        if handler is None:
+            handler = "vHandle" + "".join(p.capitalize() for p in name.split("_"))
+        entries.append((name, handler))
+    return entries
+
+
+def _c_array(c_type, name, values, per_line=12):
+    lines = [f"static const {c_type} {name}[{len(values)}] = {{"]
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join(str(v) for v in values[i:i + per_line]) + ",")
+    lines.append("};")
+    return lines
+
 
 def generate_c_pins(json_data):
-    """Generate C file: pin names array for MCU validation only.
+    """Generate C file: pin names, plus perfect-hash lookups for pin names
+    (-> pin handle = index) and config tools (-> handler).
     Actual pin control uses gpio_config_gen.c (g_psGpioPinConfigs) from the
     same config.json via gpio_driver/scripts/gen_config.py."""
     pins = json_data.get("pins", [])
+    pin_names = [pin.get("name", "") for pin in pins]
+    tools = tool_entries(json_data)
+    pin_disp, pin_slots = build_perfect_hash(pin_names)
+    tool_disp, tool_slots = build_perfect_hash([t[0] for t in tools])
+    pin_slot_type = "uint8_t" if len(pins) < 0xFF else "uint16_t"
+
     lines = [
         "// ============================================================================",
         "// AUTO-GENERATED - DO NOT EDIT MANUALLY",
@@ -30,27 +130,103 @@ def generate_c_pins(json_data):
         "//",
         "// MCP tool validation only (allowed pin names). Pin control uses",
         "// gpio_config_gen.c (g_psGpioPinConfigs) from the same config.json.",
+        "// Pin and tool names are found with a perfect hash: two hashes and one",
+        "// memcmp, whatever the number of pins/tools.",
         "// ============================================================================",
         "",
+        '#include "tool_registry.h"',
         "#include <stddef.h>",
+        "#include <stdint.h>",
+        "#include <string.h>",
         "",
         "const char *const g_apcMcpPinNames[] = {",
     ]
-    for pin in pins:
-        name = pin.get("name", "")
+    for name in pin_names:
         lines.append(f'    "{name}",')
     lines.append("    NULL")
     lines.append("};")
     lines.append("")
     lines.append(f"const unsigned int g_u32McpPinCount = {len(pins)};")
+    lines.append("")
+
+    lines.append("/* Tool handlers named by config.json \"mcp.tools\" */")
+    for handler in sorted({t[1] for t in tools}):
+        lines.append(f"extern void {handler}(const sMcpArgs_t *psArgs);")
+    lines.append("")
+    lines += [
+        "typedef struct {",
+        "  const char *pcName;",
+        "  uint8_t u8Len;",
+        "  vToolHandler_t pfHandler;",
+        "} sMcpToolSlot_t;",
+        "",
+        "static uint32_t u32McpHash(const char *pcKey, size_t u32Len,",
+        "                           uint32_t u32Seed) {",
+        "  uint32_t u32Hash = 2166136261u ^ u32Seed;",
+        "  for (size_t i = 0; i < u32Len; i++) {",
+        "    u32Hash ^= (uint8_t)pcKey[i];",
+        "    u32Hash *= 16777619u;",
+        "  }",
+        "  u32Hash ^= u32Hash >> 16;",
+        "  u32Hash *= 0x85EBCA6Bu;",
+        "  u32Hash ^= u32Hash >> 13;",
+        "  return u32Hash;",
+        "}",
+        "",
+        "/* Pins: slot -> pin handle + 1 (0 = empty) */",
+    ]
+    lines += _c_array("uint16_t", "g_au16McpPinDisp", pin_disp)
+    lines += _c_array(pin_slot_type, "g_auMcpPinSlots",
+                      [0 if s is None else s + 1 for s in pin_slots])
+    lines += _c_array("uint8_t", "g_au8McpPinLen",
+                      [len(n.encode("utf-8")) for n in pin_names] or [0])
+    lines.append("")
+    lines.append("/* Tools */")
+    lines += _c_array("uint16_t", "g_au16McpToolDisp", tool_disp)
+    lines.append(f"static const sMcpToolSlot_t g_asMcpToolSlots[{len(tool_slots)}] = {{")
+    for slot in tool_slots:
+        if slot is None:
+            lines.append("    {NULL, 0, NULL},")
+        else:
+            name, handler = tools[slot]
+            lines.append(f'    {{"{name}", {len(name)}, {handler}}},')
+    lines.append("};")
+    lines.append("")
+    lines += [
+        "int32_t iMcpFindPin(const char *pcName, size_t u32Len) {",
+        "  uint32_t u32Bucket =",
+        f"      u32McpHash(pcName, u32Len, 0) & {len(pin_disp) - 1}u;",
+        "  uint32_t u32Slot =",
+        "      u32McpHash(pcName, u32Len, g_au16McpPinDisp[u32Bucket]) &",
+        f"      {len(pin_slots) - 1}u;",
+        "  unsigned int u32Pin = g_auMcpPinSlots[u32Slot];",
+        "  if (u32Pin == 0 || g_au8McpPinLen[u32Pin - 1] != u32Len ||",
+        "      memcmp(g_apcMcpPinNames[u32Pin - 1], pcName, u32Len) != 0)",
+        "    return -1;",
+        "  return (int32_t)(u32Pin - 1);",
+        "}",
+        "",
+        "vToolHandler_t pfMcpFindTool(const char *pcName, size_t u32Len) {",
+        "  uint32_t u32Bucket =",
+        f"      u32McpHash(pcName, u32Len, 0) & {len(tool_disp) - 1}u;",
+        "  const sMcpToolSlot_t *psSlot =",
+        "      &g_asMcpToolSlots[u32McpHash(pcName, u32Len,",
+        "                                   g_au16McpToolDisp[u32Bucket]) &",
+        f"                        {len(tool_slots) - 1}u];",
+        "  if (psSlot->pcName == NULL || psSlot->u8Len != u32Len ||",
+        "      memcmp(psSlot->pcName, pcName, u32Len) != 0)",
+        "    return NULL;",
+        "  return psSlot->pfHandler;",
+        "}",
+        "",
+    ]
     return "\n".join(lines)
 
 
 def generate_python_schema(json_data):
     """Generate Python module: pin list and tool list for MCP server."""
     pins = json_data.get("pins", [])
-    mcp = json_data.get("mcp", {})
-    tools = mcp.get("tools", ["gpio_write", "gpio_read"])
+    tools = [name for name, _ in tool_entries(json_data)]
     pin_names = [p.get("name", "") for p in pins if p.get("name")]
 
     lines = [
@@ -95,6 +271,17 @@ def main():
     with open(args.config, "r", encoding="utf-8") as f:
         data = json.load(f)
 
+    try:
+        tool_entries(data)
+        pin_names = [p.get("name", "") for p in data.get("pins", [])]
+        for name in pin_names:
+            if not 0 < len(name.encode("utf-8")) <= 31 or " " in name:
+                raise ValueError(f"bad pin name: {name!r}")
+        build_perfect_hash(pin_names)
+    except ValueError as e:
+        print(f"Error: {args.config}: {e}", file=sys.stderr)
+        sys.exit(1)
+
     any_out = False
 
     if args.c_out:
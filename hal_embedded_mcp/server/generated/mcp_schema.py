@@ -9,4 +9,8 @@ MCP_PIN_NAMES = [
 MCP_TOOLS = [
     "gpio_write",
     "gpio_read",
+    "gpio_read_all",
+    "gpio_write_many",
+    "gpio_watch",
+    "gpio_write_at",
 ]
@@ -1,7 +1,12 @@
 #!/usr/bin/env python3
 """
-HAL Embedded MCP Server – exposes gpio_write / gpio_read as MCP tools.
-Sends commands to the MCU over serial; uses server/generated/mcp_schema.py (from config.json).
+HAL Embedded MCP Server – exposes gpio_write / gpio_read / gpio_read_all /
+gpio_write_many / gpio_watch (+ gpio_events) / gpio_write_at (+
+gpio_clock_sync) / link_status as MCP tools.
+Sends commands to the MCU over serial, at most as many unanswered as the MCU
+has RX slots ("flow" at connect); a reader thread takes everything the MCU
+sends and wakes each caller when its response arrives. Uses
+server/generated/mcp_schema.py (from config.json).
 Run from repo root or hal_embedded_mcp: python -m server.run_server
 Or: python server/run_server.py (with hal_embedded_mcp as cwd so generated/ is found).
 """
@@ -9,14 +14,24 @@ from __future__ import annotations
 
 __version__ = "1.0.0"
 
+import collections
+import itertools
 import os
 import sys
+import threading
 import time
+from typing import Callable
 
 # Allow importing generated schema when run as script or -m
 _SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
 if _SCRIPT_DIR not in sys.path:
     sys.path.insert(0, _SCRIPT_DIR)
+# Shared binary frame codec (helper_utils/hal_frame.py)
+_HELPER_UTILS = os.path.join(_SCRIPT_DIR, "..", "..", "helper_utils")
+if _HELPER_UTILS not in sys.path:
+    sys.path.append(_HELPER_UTILS)
+
+import hal_frame
 
 try:
     from generated.mcp_schema import MCP_PIN_NAMES, MCP_TOOLS
@@ -41,71 +56,397 @@ except ImportError:
 SERIAL_PORT = os.environ.get("HAL_MCP_SERIAL_PORT", "COM3" if sys.platform == "win32" else "/dev/ttyUSB0")
 SERIAL_BAUD = int(os.environ.get("HAL_MCP_SERIAL_BAUD", "57600"))
 DEBUG_SERIAL = "--debug-serial" in sys.argv
+# Commands in flight at once (credit window). At connect the MCU's "flow"
+# reply sets it to the RX line slots it has (AVR 2, farm 16 per board, PC
+# unbounded -> FLOW_WINDOW_MAX). HAL_MCP_PIPELINE_DEPTH caps it, and is the
+# window for firmware without "flow" (default 1: one pending line).
+_DEPTH_ENV = os.environ.get("HAL_MCP_PIPELINE_DEPTH")
+PIPELINE_DEPTH = max(1, int(_DEPTH_ENV or "1"))
+FLOW_WINDOW_MAX = 32
+RESPONSE_TIMEOUT = 2.0
+# "cobs": switch gpio_write/gpio_read to binary frames at connect time (falls
+# back to text if the firmware does not support it)
+PROTOCOL = os.environ.get("HAL_MCP_PROTOCOL", "text").lower()
 
 mcp = FastMCP("HAL Embedded MCP")
 
-# Global serial instance
+# Global serial instance, read only by the reader thread (_read_link)
 _serial_conn: serial.Serial | None = None
-
-
-def _debug_drain(ser: serial.Serial) -> None:
-    """Read any remaining bytes for a short time and print for debug."""
-    ser.timeout = 0.2
-    collected = []
-    for _ in range(25):
-        b = ser.read(64)
-        if b:
-            collected.append(b)
-    if collected:
-        print("[debug] late bytes:", b"".join(collected).__repr__(), file=sys.stderr)
-    ser.timeout = 2.0
+_reader: threading.Thread | None = None
+# Opening the port and negotiating, once (tool calls may be concurrent)
+_link_lock = threading.Lock()
+# One burst of commands on the wire at a time, so bursts never interleave
+_tx_lock = threading.Lock()
+# Guards _pending; notified by the reader on every response and event, and by
+# a caller that hands credits back
+_rx_cond = threading.Condition()
+# How long a blocking read of the reader thread lasts when the link is quiet
+READER_POLL_S = 0.5
+# Request IDs: "#<id> " prefix, echoed by the MCU (max 8 alphanumerics)
+_request_ids = itertools.count(1)
+# Binary frames: seq 1..255 (0 marks telemetry)
+_frame_seqs = itertools.cycle(range(1, 256))
+# Link state: negotiated protocol and received messages not yet consumed
+_binary = False
+_negotiated = False
+_window = PIPELINE_DEPTH
+# Commands the MCU dropped on RX ("!RX_OVERRUN"): past the window, too long,
+# or sent by something else sharing the link
+_rx_overruns = 0
+# Commands sent and not yet taken by their caller, in send order: key ->
+# response (None until it arrives). Its size is what the window limits.
+_pending: dict[str, str | hal_frame.Frame | None] = {}
+# Responses that arrived after their caller gave up (timeout)
+_late_responses = 0
+# Digital Twin telemetry (JSON lines, DT_GPIO frames) and any other text the
+# MCU prints (boot banner, logs): kept for inspection, oldest dropped
+TELEMETRY_QUEUE_MAX = 256
+_telemetry: collections.deque[str | hal_frame.Frame] = collections.deque(
+    maxlen=TELEMETRY_QUEUE_MAX)
+LOG_QUEUE_MAX = 64
+_log_lines: collections.deque[str] = collections.deque(maxlen=LOG_QUEUE_MAX)
+# gpio_watch: "!GPIO_EVENT" lines seen on the link, oldest dropped when full,
+# and callbacks that get each one as it arrives (see add_event_listener)
+EVENT_QUEUE_MAX = 256
+_events: collections.deque[dict] = collections.deque(maxlen=EVENT_QUEUE_MAX)
+_event_listeners: list[Callable[[dict], None]] = []
+# gpio_write_at: MCU tick = host monotonic ms + offset, from the "clock"
+# exchange with the shortest round trip; re-measured once older than this
+CLOCK_SYNC_MAX_AGE_S = 10.0
+_clock_sync: dict | None = None  # {"offset_ms", "rtt_ms", "at"}
 
 
 def get_serial() -> serial.Serial:
-    """Get or create the persistent serial connection."""
-    global _serial_conn
+    """Get or create the persistent serial connection and its reader."""
+    global _serial_conn, _reader, _negotiated, _binary, _window
     if _serial_conn is None or not _serial_conn.is_open:
-        _serial_conn = serial.Serial(SERIAL_PORT, SERIAL_BAUD, timeout=2.0)
+        ser = serial.Serial(SERIAL_PORT, SERIAL_BAUD, timeout=READER_POLL_S)
         # Give MCU time to boot after possible DTR reset on first open
         time.sleep(2.0)
+        _negotiated = False
+        _binary = False
+        _window = PIPELINE_DEPTH
+        _serial_conn = ser
+        _reader = threading.Thread(target=_read_link, args=(ser,),
+                                   name="hal-mcp-reader", daemon=True)
+        _reader.start()
     return _serial_conn
 
 
-def _send_cmd(line: str) -> str:
-    """Send one line to MCU and return response; interpret success/failure.
-    Drains RX buffer before sending, then waits briefly for MCU to process
-    and monitors for one line within the serial timeout window."""
-    try:
-        ser = get_serial()
-        ser.reset_input_buffer()
-        ser.write((line.strip() + "\n").encode("utf-8"))
-        ser.flush()
-        time.sleep(0.08)
-        raw = ser.readline()
-        if not raw and ser.in_waiting == 0:
-            time.sleep(0.12)
-            raw = ser.readline()
-        resp = raw.decode("utf-8", errors="replace").strip()
+def _read_link(ser: serial.Serial) -> None:
+    """Reader thread: read the link until it fails and hand every message to
+    _on_message as soon as it is complete. Nothing is flushed or skipped."""
+    splitter = hal_frame.StreamSplitter()
+    while True:
+        try:
+            raw = ser.read(max(1, ser.in_waiting))
+        except Exception as e:
+            print(f"[HAL MCP] Serial read failed: {e}", file=sys.stderr)
+            break
+        if not raw:
+            if not ser.is_open:
+                break
+            continue
         if DEBUG_SERIAL:
             print(f"[debug] raw bytes: {raw!r}", file=sys.stderr)
-    except Exception as e:
-        return f"ERR: {e}"
-    if not resp:
+        for kind, data in splitter.feed(raw):
+            _on_message(kind, data)
+    try:
+        ser.close()  # The next call reopens the port (get_serial)
+    except Exception:
+        pass
+    with _rx_cond:
+        _rx_cond.notify_all()  # Callers stop waiting for this link
+
+
+def _reader_alive() -> bool:
+    return _reader is not None and _reader.is_alive()
+
+
+def _split_tag(resp: str) -> tuple[str | None, str]:
+    """Split "#<id> <response>" into (id, response); (None, resp) if untagged."""
+    if resp.startswith("#"):
+        tag, _, body = resp[1:].partition(" ")
+        if tag.isalnum():
+            return tag, body.strip()
+    return None, resp
+
+
+def _is_response(resp: str) -> bool:
+    """Command responses (as opposed to DT JSON telemetry or log output)."""
+    word = resp.split(" ", 1)[0].upper()
+    return word in ("OK", "ERR", "GPIO_READ", "GPIO_READ_ALL", "GPIO_WATCH",
+                    "GPIO_WRITE_AT", "CLOCK", "FLOW")
+
+
+def _deliver(tag: str | None, response: str | hal_frame.Frame) -> None:
+    """Hand a response to the caller waiting for request `tag`. Untagged text
+    replies (firmware without request IDs) go to the oldest unanswered text
+    command."""
+    global _late_responses
+    with _rx_cond:
+        if tag is None:
+            tag = next((k for k, r in _pending.items()
+                        if r is None and not k.startswith("=")), None)
+        if tag in _pending and _pending[tag] is None:
+            _pending[tag] = response
+            _rx_cond.notify_all()
+        else:
+            _late_responses += 1
+
+
+def _on_message(kind: str, data: bytes) -> None:
+    """Classify one message from the link (reader thread): a response wakes
+    its caller, an event goes to gpio_events, Digital Twin telemetry and
+    anything else (logs) are kept in _telemetry / _log_lines."""
+    if kind == "frame":
+        try:
+            frame = hal_frame.decode_frame(data)
+        except ValueError:
+            return  # Corrupt: its request times out
+        if frame.op & hal_frame.RESPONSE:
+            _deliver(f"={frame.seq}", frame)
+        else:
+            _telemetry.append(frame)  # DT_GPIO
+        return
+    line = data.decode("utf-8", errors="replace").strip()
+    if not line:
+        return
+    if line.startswith("!") and _on_event(line):
+        with _rx_cond:
+            _rx_cond.notify_all()  # gpio_events may be waiting
+        return
+    tag, body = _split_tag(line)
+    if tag is not None:
+        _deliver(tag, body)
+    elif _is_response(line):
+        _deliver(None, line)
+    elif line.startswith("{"):
+        _telemetry.append(line)
+    else:
+        _log_lines.append(line)
         if DEBUG_SERIAL:
-            _debug_drain(ser)
+            print(f"[debug] MCU: {line}", file=sys.stderr)
+
+
+def add_event_listener(callback: Callable[[dict], None]) -> None:
+    """Call callback(event) for every gpio_watch / gpio_write_at event, on
+    the thread that reads the link. Events are queued for gpio_events either
+    way."""
+    _event_listeners.append(callback)
+
+
+def _parse_event(parts: list[str]) -> dict | None:
+    """Fields of an event line, None if it is not one."""
+    if len(parts) == 4 and parts[0] == "!GPIO_EVENT":
+        return {"event": "change", "pin": parts[1], "value": int(parts[2]),
+                "tick_ms": int(parts[3])}
+    if len(parts) == 6 and parts[0] == "!GPIO_WRITE_AT":
+        return {"event": "write_at", "pin": parts[1], "value": int(parts[2]),
+                "due_ms": int(parts[3]), "tick_ms": int(parts[4]),
+                "status": int(parts[5])}
+    if len(parts) == 3 and parts[0] == "!RX_OVERRUN":
+        return {"event": "rx_overrun", "lost": int(parts[1]),
+                "total": int(parts[2])}
+    return None
+
+
+def _on_event(line: str) -> bool:
+    """"!GPIO_EVENT <pin> <0|1> <tick_ms>" (gpio_watch), "!GPIO_WRITE_AT
+    <pin> <0|1> <due_ms> <done_ms> <status>" or "!RX_OVERRUN <lost> <total>"
+    -> queue + listeners. False if the line is not an event."""
+    global _rx_overruns
+    try:
+        event = _parse_event(line.split())
+    except ValueError:
+        return False
+    if event is None:
+        return False
+    if event["event"] == "rx_overrun":
+        _rx_overruns += event["lost"]
+        print(f"[HAL MCP] MCU dropped {event['lost']} command(s) (RX overrun)",
+              file=sys.stderr)
+    _events.append(event)
+    for callback in list(_event_listeners):
+        try:
+            callback(event)
+        except Exception as e:
+            print(f"[HAL MCP] Event listener failed: {e}", file=sys.stderr)
+    return True
+
+
+def _text_request(line: str) -> tuple[str, bytes]:
+    """Tag a text command: (key, wire bytes)."""
+    req_id = str(next(_request_ids) % 100000000)
+    return req_id, f"#{req_id} {line.strip()}\n".encode("utf-8")
+
+
+def _frame_request(op: int, pin: int, payload: bytes = b"") -> tuple[str, bytes]:
+    """Binary request: (key, wire bytes). Keys start with '=' so they never
+    collide with text request IDs."""
+    seq = next(_frame_seqs)
+    return f"={seq}", hal_frame.encode_frame(op, seq, pin, payload)
+
+
+def _to_request(line: str) -> tuple[str, bytes]:
+    """gpio_write / gpio_read become frames on a binary link, the rest text."""
+    parts = line.split()
+    if _binary and len(parts) >= 2 and parts[1] in MCP_PIN_NAMES:
+        pin = MCP_PIN_NAMES.index(parts[1])
+        if parts[0] == "gpio_write" and len(parts) == 3 and parts[2] in ("0", "1"):
+            return _frame_request(hal_frame.OP_GPIO_WRITE, pin, bytes([int(parts[2])]))
+        if parts[0] == "gpio_read" and len(parts) == 2:
+            return _frame_request(hal_frame.OP_GPIO_READ, pin)
+    return _text_request(line)
+
+
+def _frame_to_text(frame: hal_frame.Frame) -> str:
+    """Render a response frame like the equivalent text response."""
+    status = frame.payload[0] if frame.payload else 1
+    if frame.op == hal_frame.OP_ERROR | hal_frame.RESPONSE:
+        return f"ERR unsupported frame ({status})"
+    if status != 0:
+        return f"ERR {status}"
+    if frame.op == hal_frame.OP_GPIO_READ | hal_frame.RESPONSE and len(frame.payload) >= 2:
+        return f"GPIO_READ {MCP_PIN_NAMES[frame.pin]} {frame.payload[1]}"
+    return "OK"
+
+
+def _exchange(ser: serial.Serial, requests: list[tuple[str, bytes]]) -> list[str | hal_frame.Frame]:
+    """Send requests, keeping at most _window unanswered on the link (all
+    callers together), and return their responses in order ("" if none
+    arrived): text responses as strings, frame responses as hal_frame.Frame.
+    The reader thread matches replies by ID / seq and wakes the caller, so
+    the call returns after the link round trip; telemetry and replies
+    arriving out of order are harmless."""
+    results: list[str | hal_frame.Frame] = [""] * len(requests)
+    mine: dict[str, int] = {}  # Keys of ours in _pending -> index
+    next_send = 0
+    deadline = time.monotonic() + RESPONSE_TIMEOUT
+    while next_send < len(requests) or mine:
+        # Top up the window with everything allowed in one write
+        burst = []
+        with _tx_lock:
+            with _rx_cond:
+                while next_send < len(requests) and len(_pending) < _window:
+                    key, wire = requests[next_send]
+                    _pending[key] = None
+                    mine[key] = next_send
+                    burst.append(wire)
+                    next_send += 1
+            if burst:
+                ser.write(b"".join(burst))
+                ser.flush()
+                deadline = time.monotonic() + RESPONSE_TIMEOUT
+
+        with _rx_cond:
+            # Until one of ours is answered, or a credit to send more is free
+            while True:
+                done = [key for key in mine if _pending[key] is not None]
+                if done or (next_send < len(requests) and len(_pending) < _window):
+                    break
+                remaining = deadline - time.monotonic()
+                if remaining <= 0 or not _reader_alive():
+                    for key in mine:
+                        del _pending[key]  # A late reply counts as late
+                    _rx_cond.notify_all()
+                    return results
+                _rx_cond.wait(remaining)
+            for key in done:
+                results[mine.pop(key)] = _pending.pop(key)
+            if done:
+                _rx_cond.notify_all()  # Credits back for other callers
+    return results
+
+
+def _parse_flow(resp: str) -> tuple[int, int, int] | None:
+    """"FLOW <slots> <free> <overruns>" -> the numbers, None otherwise."""
+    parts = resp.split() if isinstance(resp, str) else []
+    if len(parts) != 4 or parts[0].upper() != "FLOW":
+        return None
+    try:
+        return int(parts[1]), int(parts[2]), int(parts[3])
+    except ValueError:
+        return None
+
+
+def _negotiate_flow(ser: serial.Serial) -> None:
+    """Size the credit window from the MCU's RX line slots. Every response
+    frees one slot (the MCU frees it before running the command), so at most
+    `slots` unanswered commands can never overrun it."""
+    global _window
+    flow = _parse_flow(_exchange(ser, [_text_request("flow")])[0])
+    if flow is None:
+        return  # Older firmware: HAL_MCP_PIPELINE_DEPTH as given
+    slots = min(max(1, flow[0]), FLOW_WINDOW_MAX)
+    _window = min(slots, PIPELINE_DEPTH) if _DEPTH_ENV else slots
+
+
+def _negotiate(ser: serial.Serial) -> None:
+    """HAL_MCP_PROTOCOL=cobs: ask for binary telemetry, then check the MCU
+    speaks frames for the same pin table (HELLO). Stays on text otherwise."""
+    global _binary
+    if _exchange(ser, [_text_request("proto cobs")])[0] != "OK":
+        print("[HAL MCP] Firmware has no binary mode; using text", file=sys.stderr)
+        return
+    hello = _exchange(ser, [_frame_request(hal_frame.OP_HELLO, hal_frame.PIN_NONE)])[0]
+    if (isinstance(hello, hal_frame.Frame) and hello.payload[:1] == b"\x00"
+            and len(hello.payload) >= 3 and hello.payload[1] == hal_frame.VERSION
+            and hello.payload[2] == len(MCP_PIN_NAMES)):
+        _binary = True
+        return
+    print("[HAL MCP] Frame HELLO mismatch (pin table?); using text", file=sys.stderr)
+    _exchange(ser, [_text_request("proto text")])
+
+
+def _connect() -> serial.Serial:
+    """Open the link if needed and negotiate it once (window, protocol)."""
+    global _negotiated
+    with _link_lock:
+        ser = get_serial()
+        if not _negotiated:
+            _negotiated = True
+            _negotiate_flow(ser)
+            if PROTOCOL == "cobs":
+                _negotiate(ser)
+    return ser
+
+
+def _send_many(lines: list[str]) -> list[str]:
+    """Send commands (pipelined, see _exchange) and return their responses in
+    order as text ("" if none arrived). On a binary link gpio_write/gpio_read
+    travel as frames; their results are rendered like the text responses."""
+    ser = _connect()
+    results = _exchange(ser, [_to_request(line) for line in lines])
+    return [_frame_to_text(r) if isinstance(r, hal_frame.Frame) else r for r in results]
+
+
+def _interpret(resp: str) -> str:
+    """Map an MCU response line to the tool result."""
+    if not resp:
+        if DEBUG_SERIAL and _log_lines:
+            print(f"[debug] recent MCU output: {list(_log_lines)[-5:]!r}",
+                  file=sys.stderr)
+        if _rx_overruns:
+            return (f"No response from MCU: it reported {_rx_overruns} dropped "
+                    "command(s) (RX overrun, see link_status).")
         return (
             "No response from MCU. Check: board connected, correct port "
             f"({SERIAL_PORT}), firmware flashed, and no other app using the port."
         )
     if resp.upper() == "OK":
         return "OK"
-    if resp.upper().startswith("ERR"):
-        return resp
-    if resp.upper().startswith("GPIO_READ"):
-        return resp
     return resp
 
 
+def _send_cmd(line: str) -> str:
+    """Send one line to MCU and return its response; interpret success/failure."""
+    try:
+        return _interpret(_send_many([line])[0])
+    except Exception as e:
+        return f"ERR: {e}"
+
+
 @mcp.tool()
 def gpio_write(pin_id: str, value: bool) -> str:
     """Set a GPIO pin high (True) or low (False). pin_id must be one of the configured pins."""
@@ -122,23 +463,183 @@ def gpio_read(pin_id: str) -> str:
     return _send_cmd(f"gpio_read {pin_id}")
 
 
+# Pairs per gpio_write_many command (firmware MCP_MAX_ARGS)
+WRITE_MANY_MAX = 8
+
+
+@mcp.tool()
+def gpio_write_many(values: dict[str, bool]) -> str:
+    """Set several GPIO pins at once, e.g. {"LED1": true, "LED2": false} (at most 8). All pins are checked first; pins on the same port change in the same instant."""
+    unknown = [pin for pin in values if pin not in MCP_PIN_NAMES]
+    if unknown:
+        return f"ERR unknown pin {unknown[0]}. Allowed: {', '.join(MCP_PIN_NAMES)}"
+    if not values or len(values) > WRITE_MANY_MAX:
+        return f"ERR need 1 to {WRITE_MANY_MAX} pins"
+    pairs = " ".join(f"{pin}={1 if value else 0}" for pin, value in values.items())
+    return _send_cmd(f"gpio_write_many {pairs}")
+
+
+def _parse_read_all(resp: str) -> dict:
+    """"GPIO_READ_ALL <count> <hexmask> [names...]" -> {"pins": {name: 0/1},
+    "mask": "0x.."}. Bit i is pin handle i; without names the MCU's pin order
+    is config.json's, i.e. MCP_PIN_NAMES."""
+    parts = resp.split()
+    if len(parts) < 3 or parts[0].upper() != "GPIO_READ_ALL":
+        raise ValueError(resp or "no response")
+    count, mask = int(parts[1]), int(parts[2], 16)
+    names = parts[3:] or list(MCP_PIN_NAMES)
+    if len(names) != count:
+        raise ValueError(f"pin map mismatch ({count} bits, {len(names)} names)")
+    return {"pins": {name: (mask >> i) & 1 for i, name in enumerate(names)},
+            "mask": f"0x{parts[2]}"}
+
+
+@mcp.tool()
+def gpio_read_all() -> dict:
+    """Read every configured pin in one round trip. Returns {"pins": {name: 0/1}, "mask": hex bitmask (bit i = i-th configured pin)}."""
+    try:
+        resp = _send_many(["gpio_read_all"])[0]
+    except Exception as e:
+        return {"error": f"ERR: {e}"}
+    try:
+        return _parse_read_all(resp)
+    except ValueError:
+        return {"error": _interpret(resp)}
+
+
+@mcp.tool()
+def gpio_watch(pin_id: str, min_interval_ms: int = 0, enable: bool = True) -> str:
+    """Subscribe to level changes of a pin (enable=False unsubscribes, at most 8 pins). The MCU then reports only changes, at most one per min_interval_ms; collect them with gpio_events. Returns the current level as "GPIO_WATCH <pin> <0|1>"."""
+    if pin_id not in MCP_PIN_NAMES:
+        return f"ERR unknown pin. Allowed: {', '.join(MCP_PIN_NAMES)}"
+    if not enable:
+        return _send_cmd(f"gpio_watch {pin_id} off")
+    if not 0 <= min_interval_ms <= 65535:
+        return "ERR min_interval_ms must be 0..65535"
+    return _send_cmd(f"gpio_watch {pin_id} {min_interval_ms}")
+
+
+def _wait_events(timeout: float) -> None:
+    """Wait until the reader thread queues an event, or timeout."""
+    _connect()
+    with _rx_cond:
+        _rx_cond.wait_for(lambda: _events or not _reader_alive(), timeout)
+
+
+@mcp.tool()
+def gpio_events(timeout_s: float = 0.0, max_events: int = 32) -> list[dict]:
+    """Take pending events, oldest first: gpio_watch changes {"event": "change", "pin", "value", "tick_ms"} and done gpio_write_at writes {"event": "write_at", "pin", "value", "due_ms", "tick_ms", "status"} (tick_ms = MCU clock, status 0 = written). With timeout_s > 0, waits up to that long for the first one."""
+    try:
+        if not _events and timeout_s > 0:
+            _wait_events(min(timeout_s, 60.0))
+    except Exception as e:
+        return [{"error": f"ERR: {e}"}]
+    taken = []
+    while _events and len(taken) < max(1, max_events):
+        taken.append(_events.popleft())
+    return taken
+
+
+@mcp.tool()
+def link_status() -> dict:
+    """Serial link flow control: {"slots": MCU RX command slots, "free": free now, "overruns": commands the MCU dropped since boot, "window": commands the server keeps in flight}. A growing overruns count means commands were lost."""
+    try:
+        resp = _send_many(["flow"])[0]
+    except Exception as e:
+        return {"error": f"ERR: {e}"}
+    flow = _parse_flow(resp)
+    if flow is None:
+        return {"error": _interpret(resp), "window": _window}
+    slots, free, overruns = flow
+    return {"slots": slots, "free": free, "overruns": overruns, "window": _window}
+
+
+def _sync_clock(samples: int) -> dict:
+    """Map host time onto the MCU tick: of `samples` "clock" exchanges the
+    one with the shortest round trip bounds the error best; its tick is
+    taken to be read halfway through."""
+    global _clock_sync
+    best = None
+    for _ in range(samples):
+        sent = time.monotonic()
+        resp = _send_many(["clock"])[0]
+        received = time.monotonic()
+        parts = resp.split()
+        if len(parts) != 2 or parts[0].upper() != "CLOCK":
+            raise ValueError(_interpret(resp))
+        rtt_ms = (received - sent) * 1000.0
+        if best is None or rtt_ms < best[0]:
+            best = (rtt_ms, int(parts[1]), (sent + received) * 500.0)
+    rtt_ms, tick_ms, midpoint_ms = best
+    _clock_sync = {"offset_ms": tick_ms - midpoint_ms, "rtt_ms": rtt_ms,
+                   "at": time.monotonic()}
+    return {"tick_ms": tick_ms, "offset_ms": round(_clock_sync["offset_ms"], 3),
+            "rtt_ms": round(rtt_ms, 3)}
+
+
+def _mcu_now_ms() -> float:
+    """Current MCU tick estimate (unwrapped), re-syncing when stale."""
+    if _clock_sync is None or time.monotonic() - _clock_sync["at"] > CLOCK_SYNC_MAX_AGE_S:
+        _sync_clock(5)
+    return time.monotonic() * 1000.0 + _clock_sync["offset_ms"]
+
+
+@mcp.tool()
+def gpio_clock_sync(samples: int = 5) -> dict:
+    """Measure the MCU clock against the host ("clock" round trips, best of samples). Returns {"tick_ms": MCU tick, "offset_ms", "rtt_ms"}; gpio_write_at(in_ms=...) uses the result and re-syncs on its own after 10 s."""
+    try:
+        return _sync_clock(max(1, min(samples, 50)))
+    except Exception as e:
+        return {"error": f"ERR: {e}"}
+
+
+@mcp.tool()
+def gpio_write_at(pin_id: str, value: bool, tick_ms: int | None = None, in_ms: int | None = None) -> str:
+    """Set an output pin at a given MCU tick (tick_ms, as in gpio_events / gpio_clock_sync) or in_ms milliseconds from now; the MCU applies it on its own clock, so the edge time does not depend on the link. At most 8 writes pending. Returns "GPIO_WRITE_AT <pin> <0|1> <tick>"; a {"event": "write_at"} from gpio_events reports when it was done."""
+    if pin_id not in MCP_PIN_NAMES:
+        return f"ERR unknown pin. Allowed: {', '.join(MCP_PIN_NAMES)}"
+    if (tick_ms is None) == (in_ms is None):
+        return "ERR give exactly one of tick_ms, in_ms"
+    try:
+        if in_ms is not None:
+            if in_ms <= 0:
+                return "ERR in_ms must be > 0"
+            tick_ms = round(_mcu_now_ms() + in_ms)
+    except Exception as e:
+        return f"ERR: {e}"
+    # The MCU tick is 32 bits and wraps (every ~49.7 days)
+    return _send_cmd(f"gpio_write_at {pin_id} {1 if value else 0} {tick_ms & 0xFFFFFFFF}")
+
+
 def run_cli():
     """Simple interactive CLI for manual testing of the serial link."""
     print(f"--- HAL MCP CLI Mode (Port: {SERIAL_PORT}, Baud: {SERIAL_BAUD}) ---")
     if DEBUG_SERIAL:
         print("Serial debug: ON (raw/late bytes printed to stderr)", file=sys.stderr)
     print(f"Allowed pins: {', '.join(MCP_PIN_NAMES)}")
-    print("Commands: gpio_write <pin> <0/1>, gpio_read <pin>, quit")
+    print("Commands: gpio_write <pin> <0/1>, gpio_read <pin>, gpio_read_all, gpio_write_many <pin>=<0/1> ...,")
+    print("          gpio_watch <pin> [min_ms|off], gpio_write_at <pin> <0/1> <tick_ms>, clock,")
+    print("          flow (RX slots / overruns), events (pending watch / write_at events), quit")
+    print("Separate commands with ';' to pipeline them (window from 'flow' or HAL_MCP_PIPELINE_DEPTH)")
     while True:
         try:
             line = input("> ").strip()
             if not line or line.lower() in ["quit", "exit"]:
                 break
-            result = _send_cmd(line)
-            if result.startswith("ERR") or "No response" in result:
-                print(f"Error: {result}")
-            else:
-                print(f"MCU Response: {result}")
+            if line.lower() == "events":
+                for event in gpio_events(timeout_s=1.0, max_events=EVENT_QUEUE_MAX):
+                    print(f"Event: {event}")
+                continue
+            cmds = [c.strip() for c in line.split(";") if c.strip()]
+            try:
+                results = [_interpret(r) for r in _send_many(cmds)]
+            except Exception as e:
+                results = [f"ERR: {e}"] * len(cmds)
+            for result in results:
+                if result.startswith("ERR") or "No response" in result:
+                    print(f"Error: {result}")
+                else:
+                    print(f"MCU Response: {result}")
         except EOFError:
             break
         except KeyboardInterrupt:
@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+"""
+Binary frame codec for the HAL MCP serial link
+----------------------------------------------
+Host-side counterpart of hal_embedded_mcp/mcu/common/mcp_frame.h.
+
+On the wire a frame is 0x00 <COBS bytes> 0x00 and shares the link with the
+text protocol (lines never contain 0x00). Decoded:
+
+    [op][seq][pin][payload 0..8][crc16 lo][crc16 hi]
+
+crc16 is CRC-16/CCITT-FALSE over op..payload. Responses carry op | RESPONSE
+and start their payload with a status byte (0 = success, else eRetType_t).
+The pin handle is the pin's index in config.json "pins".
+"""
+
+from __future__ import annotations
+
+from typing import NamedTuple
+
+VERSION = 1
+
+OP_HELLO = 0x01       # -> [status][version][pin count]
+OP_GPIO_WRITE = 0x02  # [value] -> [status]
+OP_GPIO_READ = 0x03   # -> [status][value]
+OP_DT_GPIO = 0x10     # [value], telemetry / Digital Twin injection
+OP_ERROR = 0x7F       # -> [status] for an unknown op
+RESPONSE = 0x80
+
+PIN_NONE = 0xFF
+MAX_PAYLOAD = 8
+MAX_FRAME = 3 + MAX_PAYLOAD + 2 + 1  # COBS bytes between the delimiters
+
+
+class Frame(NamedTuple):
+    op: int
+    seq: int
+    pin: int
+    payload: bytes
+
+
+def crc16(data: bytes) -> int:
+    """CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)."""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_encode(data: bytes) -> bytes:
+    """COBS without delimiters (frames are shorter than 254 bytes)."""
+    out = bytearray([0])
+    code_idx = 0
+    for byte in data:
+        if byte == 0:
+            out[code_idx] = len(out) - code_idx
+            code_idx = len(out)
+            out.append(0)
+        else:
+            out.append(byte)
+    out[code_idx] = len(out) - code_idx
+    return bytes(out)
+
+
+def cobs_decode(data: bytes) -> bytes:
+    """Inverse of cobs_encode; raises ValueError on malformed input."""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            raise ValueError("bad COBS block")
+        out += data[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def encode_frame(op: int, seq: int, pin: int, payload: bytes = b"") -> bytes:
+    """Wire form of a frame, delimiters included."""
+    if len(payload) > MAX_PAYLOAD:
+        raise ValueError("payload too long")
+    raw = bytes([op, seq & 0xFF, pin & 0xFF]) + bytes(payload)
+    crc = crc16(raw)
+    return b"\x00" + cobs_encode(raw + bytes([crc & 0xFF, crc >> 8])) + b"\x00"
+
+
+def decode_frame(cobs: bytes) -> Frame:
+    """Decode the bytes between two delimiters; raises ValueError if the frame
+    is malformed or fails its CRC."""
+    raw = cobs_decode(cobs)
+    if len(raw) < 5 or len(raw) > 3 + MAX_PAYLOAD + 2:
+        raise ValueError("bad frame length")
+    if crc16(raw[:-2]) != raw[-2] | (raw[-1] << 8):
+        raise ValueError("CRC mismatch")
+    return Frame(raw[0], raw[1], raw[2], raw[3:-2])
+
+
+class StreamSplitter:
+    """Split a byte stream into text lines and binary frames, with the same
+    rules as the firmware: 0x00 opens a frame (dropping a partial line) or
+    closes a non-empty one; inside a frame '\\n' and '\\r' are data."""
+
+    def __init__(self) -> None:
+        self._buf = bytearray()
+        self._in_frame = False
+
+    def feed(self, data: bytes) -> list[tuple[str, bytes]]:
+        """Return ("line", text bytes) and ("frame", COBS bytes) messages."""
+        messages: list[tuple[str, bytes]] = []
+        for byte in data:
+            if byte == 0:
+                if self._in_frame and self._buf:
+                    messages.append(("frame", bytes(self._buf)))
+                    self._in_frame = False
+                else:
+                    self._in_frame = True
+                self._buf.clear()
+            elif not self._in_frame and byte in (0x0A, 0x0D):
+                if self._buf:
+                    messages.append(("line", bytes(self._buf)))
+                self._buf.clear()
+            else:
+                self._buf.append(byte)
+        return messages
@@ -22,6 +22,18 @@ void vHelperSend(const char *pcCmd, const char *pcPin, int iValue) {
   }
 }
 
+void vHelperSendMany(const char *pcCmd, const char *const *ppcPins,
+                     const int *piValues, uint32_t u32Count) {
+  if (pcCmd != NULL && ppcPins != NULL && piValues != NULL && u32Count > 0) {
+    // JSON Format: {"t":"TYPE","s":{"PIN_NAME":VALUE,...}}
+    printf("{\"t\":\"%s\",\"s\":{", pcCmd);
+    for (uint32_t i = 0; i < u32Count; i++) {
+      printf("%s\"%s\":%d", (i > 0) ? "," : "", ppcPins[i], piValues[i]);
+    }
+    printf("}}\n");
+  }
+}
+
 void vHelperSendString(const char *pcCmd, const char *pcPin,
                        const char *pcValue) {
   if (pcCmd != NULL && pcPin != NULL && pcValue != NULL) {
@@ -29,6 +29,19 @@ extern "C" {
  */
 void vHelperSend(const char *pcCmd, const char *pcPin, int iValue);
 
+/**
+ * @brief Send several values of one type as one telemetry message
+ *
+ * Format: {"t":"<Cmd>","s":{"<Pin1>":<Val1>,"<Pin2>":<Val2>}}
+ * On a binary link (bOnHelperSend) each value is a DT frame instead.
+ *
+ * @param ppcPins Pin names
+ * @param piValues One value per name
+ * @param u32Count Number of entries
+ */
+void vHelperSendMany(const char *pcCmd, const char *const *ppcPins,
+                     const int *piValues, uint32_t u32Count);
+
 /**
  * @brief Send a helper/telemetry message with STRING value
  * Format: {"t":"<Cmd>","p":"<Pin>","v":"<Val>"}
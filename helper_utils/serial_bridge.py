@@ -5,21 +5,44 @@ Serial-to-HTTP Bridge for GPIO Digital Twin
 Reads JSON telemetry from Serial (AVR) and forwards it to the 
 HTTP GPIO Simulator (Unity Digital Twin).
 
+Binary DT_GPIO frames (hal_frame.py) are decoded too; their pin handle is the
+index in config.json "pins" (HAL_BRIDGE_CONFIG). With HAL_BRIDGE_PROTOCOL=cobs
+the bridge asks the MCU for binary telemetry on connect.
+
 Requirements:
     pip install pyserial
 """
 
 import serial
 import json
+import os
 import requests
 import sys
 import threading
 from datetime import datetime
 
+import hal_frame
+
 # Configuration
 SERIAL_PORT = 'COM3'
 BAUD_RATE = 57600
 SIMULATOR_URL = "http://127.0.0.1:8080/api/gpio"
+BRIDGE_PROTOCOL = os.environ.get("HAL_BRIDGE_PROTOCOL", "text").lower()
+BRIDGE_CONFIG = os.environ.get(
+    "HAL_BRIDGE_CONFIG",
+    os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "gpio_driver",
+                 "examples", "avr", "config.json"))
+
+
+def load_pin_names(path):
+    """Pin handle -> name, as the firmware's generated pin table orders them."""
+    try:
+        with open(path, "r", encoding="utf-8") as f:
+            return [p.get("name", "") for p in json.load(f).get("pins", [])]
+    except (OSError, ValueError) as e:
+        print(f"[WARN] No pin table ({path}: {e}); binary frames are ignored")
+        return []
+
 
 def main():
     print("=" * 60)
@@ -38,48 +61,74 @@ def main():
         
         # Use a Session for connection pooling (much faster!)
         session = requests.Session()
-        
+        pin_names = load_pin_names(BRIDGE_CONFIG)
+        splitter = hal_frame.StreamSplitter()
+        if BRIDGE_PROTOCOL == "cobs":
+            ser.write(b"proto cobs\n")
+
+        # Forward to Simulator ASYNC using threading
+        def send_to_simulator(pins, ts):
+            for p_name, p_val in pins.items():
+                url = f"{SIMULATOR_URL}/{p_name}"
+                payload = {"value": p_val}
+                try:
+                    # Increased timeout to 1.0s to avoid flakes under heavy polling load
+                    resp = session.post(url, json=payload, timeout=1.0)
+                    if resp.status_code == 200:
+                        print(f"[{ts}] Forwarded: {p_name} -> {p_val}")
+                    else:
+                        print(f"[{ts}] [ERROR] Simulator returned {resp.status_code}")
+                except requests.exceptions.RequestException as e:
+                    print(f"[{ts}] [ERROR] Failed to reach Simulator: {e}")
+
+        def forward(pins):
+            """One message (a tick's changes, {pin: value}) -> one thread."""
+            if not pins:
+                return
+            timestamp = datetime.now().strftime('%H:%M:%S')
+            # Fire and forget thread
+            threading.Thread(target=send_to_simulator, args=(pins, timestamp), daemon=True).start()
+
         while True:
-            if ser.in_waiting > 0:
-                line = ser.readline().decode('utf-8', errors='ignore').strip()
+            chunk = ser.read(max(1, ser.in_waiting))
+            for kind, raw in splitter.feed(chunk):
+                if kind == "frame":
+                    try:
+                        frame = hal_frame.decode_frame(raw)
+                    except ValueError:
+                        continue  # Corrupt frame: the next update corrects it
+                    if (frame.op == hal_frame.OP_DT_GPIO and frame.payload
+                            and frame.pin < len(pin_names)):
+                        forward({pin_names[frame.pin]: frame.payload[0]})
+                    continue
+
+                line = raw.decode('utf-8', errors='ignore').strip()
                 if not line:
                     continue
-                
+
                 try:
-                    # Example format: {"t":"WRITE","p":"LED1","v":1}
+                    # The firmware sends the pins that changed during a main
+                    # loop pass together: {"t":"GPIO","s":{"LED1":1,"LED2":0}}
+                    # or, from older firmware, {"t":"GPIO","p":"LED1","v":1}
                     data = json.loads(line)
-                    
+
                     # Extract fields
                     cmd_type = data.get("t")
                     pin_name = data.get("p")
-                    value = data.get("v")
-                    
-                    if cmd_type in ["WRITE", "GPIO"] and pin_name:
-                        timestamp = datetime.now().strftime('%H:%M:%S')
-                        
-                        # Forward to Simulator ASYNC using threading
-                        def send_to_simulator(p_name, p_val, ts):
-                            url = f"{SIMULATOR_URL}/{p_name}"
-                            payload = {"value": p_val}
-                            try:
-                                # Increased timeout to 1.0s to avoid flakes under heavy polling load
-                                resp = session.post(url, json=payload, timeout=1.0)
-                                if resp.status_code == 200:
-                                    print(f"[{ts}] Forwarded: {p_name} -> {p_val}")
-                                else:
-                                    print(f"[{ts}] [ERROR] Simulator returned {resp.status_code}")
-                            except requests.exceptions.RequestException as e:
-                                print(f"[{ts}] [ERROR] Failed to reach Simulator: {e}")
-
-                        # Fire and forget thread
-                        threading.Thread(target=send_to_simulator, args=(pin_name, value, timestamp), daemon=True).start()
-                            
+
+                    if cmd_type in ["WRITE", "GPIO"]:
+                        pins = data.get("s")
+                        pins = dict(pins) if isinstance(pins, dict) else {}
+                        if pin_name:
+                            pins[pin_name] = data.get("v")
+                        forward(pins)
+
                 except json.JSONDecodeError:
                     # Ignore non-JSON lines (boot messages, logs, etc)
                     if not line.startswith('{'):
                          print(f"DEBUG: {line}")
                     continue
-                    
+
     except serial.SerialException as e:
         print(f"\n[FATAL ERROR] Could not open {SERIAL_PORT}: {e}")
         print("\nPossible solutions:")